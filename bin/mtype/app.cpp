@@ -1,6 +1,9 @@
 #include "app.hpp"
 #include "show.hpp"
 #include "type_analysis.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 namespace mt {
 
@@ -22,9 +25,9 @@ namespace {
 }
 
 App::App(const cmd::Arguments& args,
-         SearchPath&& search_path_) :
+         const SearchPath& search_path) :
   arguments(args),
-  search_path(std::move(search_path_)),
+  search_path(search_path),
   type_store(args.initial_store_capacity),
   library(type_store, store, search_path, string_registry),
   unifier(type_store, library, string_registry),
@@ -34,10 +37,40 @@ App::App(const cmd::Arguments& args,
   initialize();
 }
 
+App::App(const cmd::Arguments& args,
+         const SearchPath& search_path,
+         const BaseLibrary& base) :
+  arguments(args),
+  search_path(search_path),
+  type_store(args.initial_store_capacity),
+  string_registry(base.string_registry),
+  library(type_store, store, search_path, string_registry, base.library),
+  unifier(type_store, library, string_registry),
+  constraint_generator(substitution, store, type_store, library, string_registry),
+  type_to_string(&library, &string_registry) {
+  //
+  initialize();
+}
+
+/*
+ * BaseLibrary
+ */
+
+BaseLibrary::BaseLibrary(const cmd::Arguments& args, const SearchPath& search_path) :
+  type_store(args.initial_store_capacity),
+  library(type_store, store, search_path, string_registry) {
+  //
+}
+
 void App::initialize() {
   configure_type_to_string(type_to_string, arguments);
   make_pre_imports();
   maybe_make_error_filter();
+
+  if (arguments.show_errors && arguments.diagnostic_format) {
+    diagnostic_sink = std::make_unique<DiagnosticSink>(arguments.diagnostic_format.value(),
+                                                       source_data_by_token, type_to_string);
+  }
 }
 
 void App::maybe_make_error_filter() {
@@ -56,6 +89,7 @@ void App::add_root_identifier(const std::string& name,
   MatlabIdentifier ident(string_registry.register_string(name));
   FunctionSearchCandidate search_candidate(source_candidate, ident);
   external_functions.add_visited_candidate(search_candidate);
+  root_identifier_files.insert(source_candidate->defining_file);
 }
 
 void App::make_pre_imports() {
@@ -97,10 +131,21 @@ void App::check_for_concrete_function_types() {
   }
 
   move_from(concrete_instance.errors, type_errors);
+  stream_diagnostics();
 }
 
 void App::unify() {
-  auto unify_res = unifier.unify(&substitution, &external_functions);
+  if (arguments.collect_types) {
+    type_store.set_collectable(true);
+  }
+  MT_SCOPE_EXIT {
+    type_store.set_collectable(false);
+  };
+
+  const auto num_threads = arguments.num_unify_threads;
+  auto unify_res = num_threads > 1 ?
+    unifier.unify_partitioned(&substitution, &external_functions, num_threads) :
+    unifier.unify(&substitution, &external_functions);
 
   if (unify_res.is_error()) {
     move_from(unify_res.errors, type_errors);
@@ -110,6 +155,36 @@ void App::unify() {
   }
 }
 
+void App::maybe_collect_types() {
+  if (!arguments.collect_types ||
+      type_store.num_collectable_types() < std::max(next_type_collection,
+                                                     int64_t(arguments.type_collection_threshold))) {
+    return;
+  }
+
+  //  Types made outside of unification (e.g., those referenced by ASTs, the library, and type
+  //  scopes) are never collected, so only the holders of types made while unifying are roots.
+  std::vector<const Type*> roots;
+  substitution.gather_types(roots);
+  unifier.gather_types(roots);
+  external_functions.gather_types(roots);
+  for (const auto& pair : visited_resolution_pairs) {
+    roots.push_back(pair.as_defined);
+    roots.push_back(pair.as_referenced);
+  }
+  for (const auto& err : type_errors) {
+    err->gather_types(roots);
+  }
+
+  const auto collection = type_store.collect(roots);
+  collected_types.num_types += collection.num_types;
+  collected_types.num_bytes += collection.num_bytes;
+  num_type_collections++;
+
+  //  Wait for the surviving types to double before collecting again.
+  next_type_collection = type_store.num_collectable_types() * 2;
+}
+
 bool App::add_base_scopes(const AstStoreEntries& entries) const {
   for (const auto& entry : entries) {
     if (!entry->added_base_type_scope) {
@@ -216,21 +291,33 @@ bool App::check_for_recursive_types(const AstStoreEntries& root_entries,
 }
 
 bool App::resolve_type_identifiers(const AstStoreEntries& root_entries) {
-  bool any_resolution_errors = false;
-  PendingSchemes pending_schemes;
+  AstStoreEntries entries;
+  std::vector<std::unique_ptr<TypeIdentifierResolverInstance>> instances;
 
   for (const auto& root_entry : root_entries) {
-    if (root_entry->resolved_type_identifiers) {
-      continue;
+    if (!root_entry->resolved_type_identifiers) {
+      entries.push_back(root_entry);
+      instances.push_back(std::make_unique<TypeIdentifierResolverInstance>(
+        type_store, library, store, string_registry, source_data_by_token));
     }
+  }
 
-    TypeIdentifierResolverInstance instance(type_store, library, store,
-                                            string_registry, source_data_by_token);
-    TypeIdentifierResolver type_identifier_resolver(&instance);
+  if (arguments.num_resolution_threads > 1 && entries.size() > 1) {
+    resolve_type_identifiers_concurrently(entries, instances);
+  } else {
+    for (int64_t i = 0; i < int64_t(entries.size()); i++) {
+      TypeIdentifierResolver type_identifier_resolver(instances[i].get());
+      entries[i]->root_block->accept(type_identifier_resolver);
+    }
+  }
 
-    const auto& root = root_entry->root_block;
-    root->accept(type_identifier_resolver);
-    root_entry->resolved_type_identifiers = true;
+  bool any_resolution_errors = false;
+  PendingSchemes pending_schemes;
+
+  for (int64_t i = 0; i < int64_t(entries.size()); i++) {
+    auto& instance = *instances[i];
+    instance.register_local_types();
+    entries[i]->resolved_type_identifiers = true;
 
     if (instance.had_error()) {
       move_from(instance.errors, parse_errors);
@@ -254,6 +341,47 @@ bool App::resolve_type_identifiers(const AstStoreEntries& root_entries) {
   return true;
 }
 
+void App::resolve_type_identifiers_concurrently(const AstStoreEntries& entries,
+                                                const ResolverInstances& instances) {
+  const auto num_entries = int64_t(entries.size());
+  TypeIdentifierResolutionOrder order(num_entries);
+
+  for (int64_t i = 0; i < num_entries; i++) {
+    instances[i]->resolve_concurrently(&order, i);
+  }
+
+  //  Entries are claimed in order, as required by `order`.
+  std::atomic<int64_t> next_entry{0};
+  auto worker = [&]() {
+    int64_t i;
+    while ((i = next_entry++) < num_entries) {
+      TypeStore::defer_identifiers(&instances[i]->made_variables);
+      TypeIdentifierResolver type_identifier_resolver(instances[i].get());
+      entries[i]->root_block->accept(type_identifier_resolver);
+      TypeStore::defer_identifiers(nullptr);
+      order.mark_resolved(i);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  const auto num_workers = std::min(int64_t(arguments.num_resolution_threads), num_entries);
+  for (int64_t i = 1; i < num_workers; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  //  Number type variables in file order, as if the files had been resolved serially.
+  for (const auto& instance : instances) {
+    const auto& made_variables = instance->made_variables;
+    type_store.assign_identifiers(made_variables.data(), int64_t(made_variables.size()));
+  }
+
+  num_concurrently_resolved_files += num_entries;
+}
+
 bool App::resolve_external_functions(ParsePipelineInstanceData& pipeline_instance) {
   ResolutionInstance resolution_instance;
   auto resolution_pairs =
@@ -269,11 +397,34 @@ bool App::resolve_external_functions(ParsePipelineInstanceData& pipeline_instanc
   return true;
 }
 
-bool App::generate_type_constraints(const AstStoreEntries& root_entries) {
+bool App::generate_type_constraints(ParsePipelineInstanceData& pipeline_instance,
+                                    const AstStoreEntries& root_entries) {
+  AstStoreEntries entries;
   for (const auto& root_entry : root_entries) {
     if (!root_entry->generated_type_constraints) {
-      root_entry->root_block->accept_const(constraint_generator);
-      root_entry->generated_type_constraints = true;
+      entries.push_back(root_entry);
+    }
+  }
+
+  std::vector<std::unique_ptr<TypeConstraintGenerator>> generators;
+  if (arguments.num_constraint_threads > 1 && entries.size() > 1) {
+    generators = generate_type_constraints_concurrently(entries);
+  }
+
+  for (int64_t i = 0; i < int64_t(entries.size()); i++) {
+    auto& entry = *entries[i];
+    if (generators.empty()) {
+      entry.root_block->accept_const(constraint_generator);
+    } else {
+      //  Merge in file order, so that equations are solved in the same order as if they had been
+      //  generated serially.
+      constraint_generator.merge(std::move(*generators[i]));
+    }
+
+    entry.generated_type_constraints = true;
+
+    if (!entry.deferred_function_bodies.empty()) {
+      defer_or_check_function_bodies(pipeline_instance, entry);
     }
   }
 
@@ -284,45 +435,201 @@ bool App::generate_type_constraints(const AstStoreEntries& root_entries) {
   return true;
 }
 
+std::vector<std::unique_ptr<TypeConstraintGenerator>>
+App::generate_type_constraints_concurrently(const AstStoreEntries& entries) {
+  const auto num_entries = int64_t(entries.size());
+  std::vector<std::unique_ptr<TypeConstraintGenerator>> generators(num_entries);
+
+  for (auto& generator : generators) {
+    generator = std::make_unique<TypeConstraintGenerator>(store, type_store,
+                                                          library, string_registry);
+  }
+
+  std::atomic<int64_t> next_entry{0};
+  auto worker = [&]() {
+    int64_t i;
+    while ((i = next_entry++) < num_entries) {
+      entries[i]->root_block->accept_const(*generators[i]);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  const auto num_workers = std::min(int64_t(arguments.num_constraint_threads), num_entries);
+  for (int64_t i = 1; i < num_workers; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  num_concurrently_constrained_files += num_entries;
+  return generators;
+}
+
+namespace {
+  bool has_fully_concrete_signature(const DeferredFunctionBody& deferred) {
+    const auto* signature = deferred.signature->resolved_type;
+    if (!signature) {
+      return false;
+    }
+
+    IsFullyConcreteInstance concrete_instance;
+    IsFullyConcrete check_fully_concrete(&concrete_instance);
+    return signature->accept(check_fully_concrete);
+  }
+}
+
+void App::defer_or_check_function_bodies(ParsePipelineInstanceData& pipeline_instance,
+                                         AstStore::Entry& entry) {
+  //  A function with a fully concrete signature is trusted as an interface by its callers, and
+  //  its body is checked separately. Otherwise, its body is checked along with its callers.
+  auto& deferred_bodies = entry.deferred_function_bodies;
+  num_deferred_function_bodies += int64_t(deferred_bodies.size());
+
+  auto trusted_end = std::stable_partition(deferred_bodies.begin(), deferred_bodies.end(),
+                                           has_fully_concrete_signature);
+  for (auto it = trusted_end; it != deferred_bodies.end(); ++it) {
+    check_deferred_function_body(pipeline_instance, entry, *it);
+  }
+
+  deferred_bodies.erase(trusted_end, deferred_bodies.end());
+
+  if (!deferred_bodies.empty()) {
+    const auto* file_descriptor = entry.root_block->scope->file_descriptor;
+    files_with_deferred_function_bodies.push_back(file_descriptor->file_path);
+  }
+}
+
 bool App::unify_while_able(ParsePipelineInstanceData& pipeline_instance) {
   bool proceed = true;
   while (proceed) {
     //  By unifying, we may discover the types of dependent external functions.
     //  By resolving these types, we may be able to locate additional dependent
-    //  external functions. Continue to unify until we find no new external function types.
-    const auto original_num_pending =
-      external_functions.num_pending_candidate_files();
+    //  external functions. Continue to unify until no external function is ready to be
+    //  resolved.
+    external_functions.schedule_stats.num_rounds++;
 
     if (!resolve_external_functions(pipeline_instance)) {
       return false;
     }
 
     unify();
+    proceed = external_functions.has_ready_candidates();
+  }
+
+  return true;
+}
+
+bool App::check_deferred_function_body(ParsePipelineInstanceData& pipeline_instance,
+                                       const AstStore::Entry& entry,
+                                       const DeferredFunctionBody& deferred) {
+  if (!parse_deferred_function_body(pipeline_instance, entry, deferred)) {
+    return false;
+  }
 
-    const auto new_num_pending = external_functions.num_pending_candidate_files();
-    proceed = new_num_pending != original_num_pending;
+  num_parsed_deferred_function_bodies++;
+
+  TypeIdentifierResolverInstance instance(type_store, library, store,
+                                          string_registry, source_data_by_token);
+  TypeIdentifierResolver type_identifier_resolver(&instance);
+  type_identifier_resolver.deferred_function_def_body(deferred.root_scope,
+                                                      deferred.root_type_scope, *deferred.node);
+
+  if (instance.had_error()) {
+    move_from(instance.errors, parse_errors);
+    return false;
+  }
+
+  if (!check_for_recursive_types({}, instance.pending_schemes)) {
+    return false;
+  }
+
+  for (const auto& pending_scheme : instance.pending_schemes) {
+    pending_scheme.instantiate(type_store);
   }
 
+  constraint_generator.deferred_function_def_body(deferred.root_scope,
+                                                  deferred.root_type_scope, *deferred.node);
   return true;
 }
 
-bool App::visit_file(const FilePath& file_path) {
-  if (ast_store.lookup(file_path)) {
+bool App::check_deferred_function_bodies() {
+  if (files_with_deferred_function_bodies.empty()) {
     return false;
+
+  } else if (arguments.trust_annotated_functions) {
+    //  Bodies are only checked when their files are named as root identifiers.
+    files_with_deferred_function_bodies.clear();
+    return false;
+  }
+
+  auto pipeline_instance = make_pipeline_instance();
+  std::vector<FilePath> files;
+  std::swap(files, files_with_deferred_function_bodies);
+
+  for (const auto& file : files) {
+    auto* entry = ast_store.lookup(file);
+    if (!entry) {
+      continue;
+    }
+
+    //  Each body is solved on its own, against the trusted signatures of the functions it calls.
+    for (const auto& deferred : entry->deferred_function_bodies) {
+      if (!check_deferred_function_body(pipeline_instance, *entry, deferred)) {
+        continue;
+      }
+
+      auto& gen_warnings = constraint_generator.get_warnings();
+      move_from(gen_warnings, type_errors);
+      gen_warnings.clear();
+
+      unify_while_able(pipeline_instance);
+      maybe_collect_types();
+    }
+
+    entry->deferred_function_bodies.clear();
+    stream_diagnostics();
   }
 
+  return true;
+}
+
+ParsePipelineInstanceData App::make_pipeline_instance() {
   ParsePipelineInstanceData pipeline_instance(search_path, store, type_store, library,
                                               string_registry, ast_store,
                                               scan_result_store, functions_by_file,
                                               pre_imports, source_data_by_token, arguments,
                                               parse_errors, parse_warnings);
+  pipeline_instance.eager_files = &root_identifier_files;
+  return pipeline_instance;
+}
 
+bool App::visit_file(const FilePath& file_path) {
+  if (ast_store.lookup(file_path)) {
+    //  Another function in this file was already requested.
+    external_functions.schedule_stats.num_revisits++;
+    external_functions.mark_file_ready(file_path);
+    return false;
+  }
+
+  MT_SCOPE_EXIT {
+    stream_diagnostics();
+  };
+
+  auto pipeline_instance = make_pipeline_instance();
   auto root_res = file_entry(pipeline_instance, file_path);
   if (!root_res) {
     return false;
   }
 
   auto root_entries = pipeline_instance.gather_root_entries();
+  for (const auto& entry : root_entries) {
+    if (entry->root_block) {
+      external_functions.mark_file_ready(entry->root_block->scope->file_descriptor->file_path);
+    }
+  }
+
   if (!are_valid_root_entries(root_entries)) {
     return false;
   }
@@ -339,7 +646,7 @@ bool App::visit_file(const FilePath& file_path) {
     return false;
   }
 
-  if (!generate_type_constraints(root_entries)) {
+  if (!generate_type_constraints(pipeline_instance, root_entries)) {
     return false;
   }
 
@@ -347,10 +654,14 @@ bool App::visit_file(const FilePath& file_path) {
     return false;
   }
 
+  maybe_collect_types();
   return true;
 }
 
-void App::maybe_show() const {
+void App::maybe_show() {
+  //  Types are no longer modified, so their strings can be reused.
+  type_to_string.cache = &type_string_cache;
+
   maybe_show_type_distribution();
   maybe_show_local_variable_types();
   maybe_show_local_function_types();
@@ -362,14 +673,13 @@ void App::maybe_show() const {
 
 void App::maybe_show_local_function_types() const {
   if (arguments.show_local_function_types) {
-    show_function_types(functions_by_file, type_to_string,
-                        store, string_registry, library);
+    show_function_types(functions_by_file, type_to_string, library, num_render_threads());
   }
 }
 
 void App::maybe_show_local_variable_types() const {
   if (arguments.show_local_variable_types) {
-    constraint_generator.show_variable_types(type_to_string);
+    constraint_generator.show_variable_types(type_to_string, num_render_threads());
   }
 }
 
@@ -417,8 +727,35 @@ void App::show_type_errors() const {
   }
 }
 
-void App::maybe_show_errors() const {
-  if (arguments.show_errors) {
+void App::emit_pending_diagnostics() {
+  for (; num_streamed_parse_errors < int64_t(parse_errors.size()); num_streamed_parse_errors++) {
+    diagnostic_sink->emit(parse_errors[num_streamed_parse_errors]);
+  }
+
+  for (; num_streamed_type_errors < int64_t(type_errors.size()); num_streamed_type_errors++) {
+    const auto& err = type_errors[num_streamed_type_errors];
+    if (!maybe_error_filter ||
+        passes_error_filter(err, maybe_error_filter.value(), source_data_by_token)) {
+      diagnostic_sink->emit(*err);
+    }
+  }
+}
+
+void App::stream_diagnostics() {
+  //  Roots checked in parallel by separate apps would interleave their errors, so those are
+  //  only emitted once the app's results are shown.
+  if (diagnostic_sink && arguments.num_root_threads == 0) {
+    emit_pending_diagnostics();
+    diagnostic_sink->flush();
+  }
+}
+
+void App::maybe_show_errors() {
+  if (diagnostic_sink) {
+    emit_pending_diagnostics();
+    diagnostic_sink->finish();
+
+  } else if (arguments.show_errors) {
     show_parse_errors(parse_errors, source_data_by_token, arguments);
     show_type_errors();
   }
@@ -428,11 +765,44 @@ void App::maybe_show_diagnostics() const {
   if (arguments.show_diagnostics) {
     std::cout << "Num files visited: " << ast_store.num_visited_files() << std::endl;
     std::cout << "Num type eqs: " << substitution.num_type_equations() << std::endl;
+    std::cout << "Num deduplicated type eqs: "
+              << substitution.type_equation_counts().deduplicated << std::endl;
+    std::cout << "Num retired type eqs: "
+              << substitution.type_equation_counts().retired << std::endl;
     std::cout << "Subs size: " << substitution.num_bound_terms() << std::endl;
     std::cout << "Num types: " << type_store.size() << std::endl;
     std::cout << "Num external functions: "
               << external_functions.resolved_candidates.size() << std::endl;
     std::cout << "Num visited types in unifier: " << unifier.num_registered_types() << std::endl;
+    const auto& relation_stats = unifier.relation_cache_stats();
+    std::cout << "Num relation cache hits: " << relation_stats.hits << std::endl;
+    std::cout << "Num relation cache misses: " << relation_stats.misses << std::endl;
+    const auto& schedule_stats = external_functions.schedule_stats;
+    std::cout << "Max external file queue depth: " << schedule_stats.max_queue_depth << std::endl;
+    std::cout << "Num external function rounds: " << schedule_stats.num_rounds << std::endl;
+    std::cout << "Num external file re-visits: " << schedule_stats.num_revisits << std::endl;
+    if (arguments.num_unify_threads > 1) {
+      std::cout << "Num partitioned components: " << unifier.num_partitioned_components() << std::endl;
+      std::cout << "Num deferred components: " << unifier.num_deferred_components() << std::endl;
+    }
+    if (arguments.num_resolution_threads > 1) {
+      std::cout << "Num concurrently resolved files: "
+                << num_concurrently_resolved_files << std::endl;
+    }
+    if (arguments.num_constraint_threads > 1) {
+      std::cout << "Num concurrently constrained files: "
+                << num_concurrently_constrained_files << std::endl;
+    }
+    if (arguments.collect_types) {
+      std::cout << "Num type collections: " << num_type_collections << std::endl;
+      std::cout << "Num collected types: " << collected_types.num_types << std::endl;
+      std::cout << "Collected type bytes: " << collected_types.num_bytes << std::endl;
+    }
+    if (arguments.defer_annotated_function_bodies) {
+      std::cout << "Num deferred function bodies: " << num_deferred_function_bodies << std::endl;
+      std::cout << "Num parsed deferred function bodies: "
+                << num_parsed_deferred_function_bodies << std::endl;
+    }
 //    std::cout << "Parse / check time: " << check_elapsed_ms << " (ms)" << std::endl;
 //    std::cout << "Build path time: " << build_search_path_elapsed_ms << " (ms)" << std::endl;
 //    std::cout << "Unify time: " << unify_time << " (ms)" << std::endl;
@@ -6,6 +6,8 @@
 #include "command_line.hpp"
 #include "external_resolution.hpp"
 #include "pre_imports.hpp"
+#include "diagnostics.hpp"
+#include <memory>
 
 namespace mt {
 
@@ -13,28 +15,59 @@ namespace cmd {
   struct Arguments;
 }
 
+/*
+ * BaseLibrary
+ *
+ * The known types, made once and copied by each app that checks a root independently.
+ */
+
+struct BaseLibrary {
+  BaseLibrary(const cmd::Arguments& args, const SearchPath& search_path);
+
+  Store store;
+  TypeStore type_store;
+  StringRegistry string_registry;
+  Library library;
+};
+
 class App {
+  using ResolverInstances = std::vector<std::unique_ptr<TypeIdentifierResolverInstance>>;
 public:
-  App(const cmd::Arguments& args, SearchPath&& search_path);
+  App(const cmd::Arguments& args, const SearchPath& search_path);
+  App(const cmd::Arguments& args, const SearchPath& search_path, const BaseLibrary& base);
 
   bool visit_file(const FilePath& file_path);
+  bool check_deferred_function_bodies();
   bool locate_root_identifiers();
   void check_for_concrete_function_types();
-  void maybe_show() const;
+  void maybe_show();
 
 private:
   bool add_base_scopes(const AstStoreEntries& entries) const;
   bool resolve_type_imports(AstStoreEntryPtr root_entry);
   bool resolve_type_identifiers(const AstStoreEntries& entries);
+  void resolve_type_identifiers_concurrently(const AstStoreEntries& entries,
+                                             const ResolverInstances& instances);
   bool resolve_external_functions(ParsePipelineInstanceData& pipeline_instance);
   bool check_for_recursive_types(const AstStoreEntries& entries,
                                  const PendingSchemes& pending_schemes);
-  bool generate_type_constraints(const AstStoreEntries& entries);
+  bool generate_type_constraints(ParsePipelineInstanceData& pipeline_instance,
+                                 const AstStoreEntries& entries);
+  std::vector<std::unique_ptr<TypeConstraintGenerator>>
+  generate_type_constraints_concurrently(const AstStoreEntries& entries);
+  void defer_or_check_function_bodies(ParsePipelineInstanceData& pipeline_instance,
+                                      AstStore::Entry& entry);
   bool unify_while_able(ParsePipelineInstanceData& pipeline_instance);
+  bool check_deferred_function_body(ParsePipelineInstanceData& pipeline_instance,
+                                    const AstStore::Entry& entry,
+                                    const DeferredFunctionBody& deferred);
+
+  ParsePipelineInstanceData make_pipeline_instance();
 
   void initialize();
   void maybe_make_error_filter();
   void unify();
+  void maybe_collect_types();
   void add_root_identifier(const std::string& name,
                            const SearchCandidate* source_candidate);
   void make_pre_imports();
@@ -44,18 +77,21 @@ private:
   void maybe_show_local_function_types() const;
   void maybe_show_local_variable_types() const;
   void maybe_show_visited_external_files() const;
-  void maybe_show_errors() const;
+  void maybe_show_errors();
   void maybe_show_diagnostics() const;
   void maybe_show_type_distribution() const;
   void maybe_show_asts() const;
 
   std::vector<const TypeError*> filter_type_errors() const;
   void show_type_errors() const;
+  void emit_pending_diagnostics();
+  void stream_diagnostics();
 
 public:
   cmd::Arguments arguments;
 
-  SearchPath search_path;
+  //  Read-only after construction, and so can be shared by apps checking roots in parallel.
+  const SearchPath& search_path;
   Store store;
   TypeStore type_store;
   StringRegistry string_registry;
@@ -67,12 +103,25 @@ public:
   PendingExternalFunctions external_functions;
 
   TypeToString type_to_string;
+  TypeStringCache type_string_cache;
 
   AstStore ast_store;
   ScanResultStore scan_result_store;
   FunctionsByFile functions_by_file;
   VisitedResolutionPairs visited_resolution_pairs;
 
+  std::unordered_set<FilePath, FilePath::Hash> root_identifier_files;
+  std::vector<FilePath> files_with_deferred_function_bodies;
+  int64_t num_deferred_function_bodies = 0;
+  int64_t num_parsed_deferred_function_bodies = 0;
+  int64_t num_concurrently_resolved_files = 0;
+  int64_t num_concurrently_constrained_files = 0;
+
+  //  Types made while unifying are reclaimed once this many are live; see `--collect-types`.
+  int64_t next_type_collection = 0;
+  int64_t num_type_collections = 0;
+  TypeStore::Collection collected_types;
+
   PreImports pre_imports;
 
   ParseErrors parse_errors;
@@ -80,6 +129,11 @@ public:
 
   TypeErrors type_errors;
   Optional<ErrorFilter> maybe_error_filter;
+
+  //  Set when errors are streamed as files are checked, rather than shown by `maybe_show`.
+  std::unique_ptr<DiagnosticSink> diagnostic_sink;
+  int64_t num_streamed_parse_errors = 0;
+  int64_t num_streamed_type_errors = 0;
 };
 
 }
\ No newline at end of file
@@ -24,6 +24,7 @@ public:
     FunctionReferenceHandle file_entry_function_ref;
     const FunctionDefNode* file_entry_function_def_node;
     CodeFileType file_type;
+    DeferredFunctionBodies deferred_function_bodies;
   };
 
   AstStore::Entry* insert(const FilePath& file_path, Entry&& entry);
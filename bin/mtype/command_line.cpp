@@ -15,7 +15,6 @@ namespace {
     return std::strlen(a) > 0 && a[0] == '-';
   }
 
-#if 0
   Optional<int> parse_int(const char* arg) {
     try {
       return Optional<int>(std::stoi(arg));
@@ -23,7 +22,6 @@ namespace {
       return NullOpt{};
     }
   }
-#endif
 
   std::vector<FilePath> get_split_paths(const std::string& arg) {
     auto split = mt::split(arg.c_str(), arg.size(), Character(':'));
@@ -261,6 +259,111 @@ void Arguments::build_parse_spec() {
       return MatchResult{true, 2};
     }
   });
+  arguments.emplace_back(ParameterName("--single-pass-parse", "-spp"), "Classify identifiers while generating each file's AST.",
+    [this](int, int, char**) {
+    return true_param(&classify_identifiers_during_parse);
+  });
+  arguments.emplace_back(ParameterName("--defer-annotated-bodies", "-dab"), "Defer parsing the bodies of type-annotated functions in external files.",
+    [this](int, int, char**) {
+    return true_param(&defer_annotated_function_bodies);
+  });
+  arguments.emplace_back(ParameterName("--trust-annotated-functions", "-taf"), "Trust the signatures of fully concrete, type-annotated functions in external files, without checking their bodies. Implies -dab.",
+    [this](int, int, char**) {
+    defer_annotated_function_bodies = true;
+    return true_param(&trust_annotated_functions);
+  });
+  arguments.emplace_back(ParameterName("--unify-threads", "-ut"), "`n`",
+    "Solve independent groups of type equations on up to `n` threads.",
+    [this](int i, int argc, char** argv) {
+    if (i >= argc-1) {
+      return MatchResult{false, 1};
+    }
+    auto maybe_n = parse_int(argv[i + 1]);
+    if (!maybe_n || maybe_n.value() < 1) {
+      return MatchResult{false, 2};
+    } else {
+      num_unify_threads = maybe_n.value();
+      return MatchResult{true, 2};
+    }
+  });
+  arguments.emplace_back(ParameterName("--resolution-threads", "-rt"), "`n`",
+    "Resolve the type identifiers of newly visited files on up to `n` threads.",
+    [this](int i, int argc, char** argv) {
+    if (i >= argc-1) {
+      return MatchResult{false, 1};
+    }
+    auto maybe_n = parse_int(argv[i + 1]);
+    if (!maybe_n || maybe_n.value() < 1) {
+      return MatchResult{false, 2};
+    } else {
+      num_resolution_threads = maybe_n.value();
+      return MatchResult{true, 2};
+    }
+  });
+  arguments.emplace_back(ParameterName("--constraint-threads", "-cgt"), "`n`",
+    "Generate the type equations of newly visited files on up to `n` threads.",
+    [this](int i, int argc, char** argv) {
+    if (i >= argc-1) {
+      return MatchResult{false, 1};
+    }
+    auto maybe_n = parse_int(argv[i + 1]);
+    if (!maybe_n || maybe_n.value() < 1) {
+      return MatchResult{false, 2};
+    } else {
+      num_constraint_threads = maybe_n.value();
+      return MatchResult{true, 2};
+    }
+  });
+  arguments.emplace_back(ParameterName("--collect-types", "-ct"), "`n`",
+    "Reclaim unreachable types made while solving type equations, once `n` such types exist.",
+    [this](int i, int argc, char** argv) {
+    if (i >= argc-1) {
+      return MatchResult{false, 1};
+    }
+    auto maybe_n = parse_int(argv[i + 1]);
+    if (!maybe_n || maybe_n.value() < 1) {
+      return MatchResult{false, 2};
+    } else {
+      collect_types = true;
+      type_collection_threshold = maybe_n.value();
+      return MatchResult{true, 2};
+    }
+  });
+  arguments.emplace_back(ParameterName("--diagnostic-format", "-df"), "`format`",
+    "Stream errors as each file is checked, as `plain`, `color`, `jsonl` or `sarif`.",
+    [this](int i, int argc, char** argv) {
+    if (i >= argc-1) {
+      return MatchResult{false, 1};
+    }
+    auto maybe_format = parse_diagnostic_format(argv[i + 1]);
+    if (!maybe_format) {
+      return MatchResult{false, 2};
+    }
+    const auto format = maybe_format.value();
+    diagnostic_format = format;
+    //  Type strings within errors are styled only for colored output.
+    rich_text = format == DiagnosticFormat::colored;
+    if (format == DiagnosticFormat::json_lines || format == DiagnosticFormat::sarif) {
+      //  Keep the output machine-readable, unless later arguments ask otherwise.
+      show_local_function_types = false;
+      show_diagnostics = false;
+    }
+    return MatchResult{true, 2};
+  });
+  arguments.emplace_back(ParameterName("--independent-roots", "-ir"), "`n`",
+    "Check each root identifier independently of the others, on up to `n` threads.",
+    [this](int i, int argc, char** argv) {
+    if (i >= argc-1) {
+      return MatchResult{false, 1};
+    }
+    auto maybe_n = parse_int(argv[i + 1]);
+    if (!maybe_n || maybe_n.value() < 1) {
+      return MatchResult{false, 2};
+    } else {
+      num_root_threads = maybe_n.value();
+      return MatchResult{true, 2};
+    }
+  });
 }
 
 void Arguments::make_silent() {
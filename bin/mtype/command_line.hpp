@@ -1,6 +1,7 @@
 #pragma once
 
 #include "mt/mt.hpp"
+#include "diagnostics.hpp"
 
 namespace mt::cmd {
 
@@ -56,6 +57,7 @@ public:
   std::vector<mt::FilePath> search_paths;
   std::vector<std::string> pre_imports;
   std::vector<std::string> error_filter_identifiers;
+  Optional<DiagnosticFormat> diagnostic_format;
 
   bool show_ast = false;
   bool show_local_variable_types = false;
@@ -81,9 +83,18 @@ public:
   bool show_explicit_aliases = false;
   bool use_arrow_function_notation = false;
   bool show_application_outputs = false;
+  bool classify_identifiers_during_parse = false;
+  bool defer_annotated_function_bodies = false;
+  bool trust_annotated_functions = false;
+  bool collect_types = false;
 
   bool had_parse_error = false;
   int initial_store_capacity = 100000;
   int max_num_type_variables = 3;
+  int num_unify_threads = 1;
+  int num_root_threads = 0;
+  int num_resolution_threads = 1;
+  int num_constraint_threads = 1;
+  int type_collection_threshold = 0;
 };
 }
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include "diagnostics.hpp"
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+
+namespace mt {
+
+namespace {
+  void append_json_string(std::ostream& out, std::string_view str) {
+    out << '"';
+    for (const char c : str) {
+      switch (c) {
+        case '"':
+          out << "\\\"";
+          break;
+        case '\\':
+          out << "\\\\";
+          break;
+        case '\n':
+          out << "\\n";
+          break;
+        case '\r':
+          out << "\\r";
+          break;
+        case '\t':
+          out << "\\t";
+          break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", int(c));
+            out << escaped;
+          } else {
+            out << c;
+          }
+      }
+    }
+    out << '"';
+  }
+
+  constexpr const char* sarif_header =
+    R"({"version":"2.1.0",)"
+    R"("$schema":"https://json.schemastore.org/sarif-2.1.0.json",)"
+    R"("runs":[{"tool":{"driver":{"name":"mtype"}},"results":[)";
+
+  constexpr const char* sarif_footer = "]}]}";
+}
+
+Optional<DiagnosticFormat> parse_diagnostic_format(std::string_view name) {
+  if (name == "plain") {
+    return Optional<DiagnosticFormat>(DiagnosticFormat::plain);
+  } else if (name == "color") {
+    return Optional<DiagnosticFormat>(DiagnosticFormat::colored);
+  } else if (name == "jsonl") {
+    return Optional<DiagnosticFormat>(DiagnosticFormat::json_lines);
+  } else if (name == "sarif") {
+    return Optional<DiagnosticFormat>(DiagnosticFormat::sarif);
+  } else {
+    return NullOpt{};
+  }
+}
+
+/*
+ * DiagnosticSink
+ */
+
+DiagnosticSink::DiagnosticSink(DiagnosticFormat format,
+                               const TokenSourceMap& source_data_by_token,
+                               const TypeToString& type_to_string) :
+  format(format),
+  source_data_by_token(source_data_by_token),
+  show_type_errors(type_to_string),
+  num_parse_errors(0),
+  num_type_errors(0),
+  num_records(0),
+  finished(false) {
+  //
+  show_parse_errors.is_rich_text = format == DiagnosticFormat::colored;
+  show_parse_errors.out = &buffer;
+  show_type_errors.out = &buffer;
+
+  if (format == DiagnosticFormat::sarif) {
+    buffer << sarif_header;
+  }
+}
+
+void DiagnosticSink::emit(const ParseError& err) {
+  assert(!finished);
+  num_parse_errors++;
+
+  if (format == DiagnosticFormat::plain || format == DiagnosticFormat::colored) {
+    show_parse_errors.show(err, source_data_by_token, num_parse_errors);
+
+  } else if (!err.get_message().empty()) {
+    Location location{"<anonymous>", -1, -1};
+    if (const auto maybe_source_data = source_data_by_token.lookup(err.get_source_token())) {
+      location = make_location(maybe_source_data.value(), err.source_offset());
+    }
+    if (const auto* descriptor = err.get_descriptor()) {
+      location.file_path = descriptor->file_path.str();
+    }
+
+    emit_record("parse-error", location, err.get_message());
+  }
+
+  maybe_flush();
+}
+
+void DiagnosticSink::emit(const TypeError& err) {
+  assert(!finished);
+  num_type_errors++;
+
+  if (format == DiagnosticFormat::plain || format == DiagnosticFormat::colored) {
+    show_type_errors.show(err, num_type_errors, source_data_by_token);
+
+  } else {
+    const auto at_token = err.get_source_token();
+    const auto maybe_source_data = source_data_by_token.lookup(at_token);
+    assert(maybe_source_data);
+    const auto& source_data = maybe_source_data.value();
+
+    const auto offset = at_token.is_null() ? 0 : at_token.lexeme.data() - source_data.source.data();
+    emit_record("type-error", make_location(source_data, offset), err.get_text(show_type_errors));
+  }
+
+  maybe_flush();
+}
+
+void DiagnosticSink::emit_record(const char* kind, const Location& location,
+                                 const std::string& message) {
+  if (format == DiagnosticFormat::json_lines) {
+    buffer << R"({"kind":")" << kind << R"(","file":)";
+    append_json_string(buffer, location.file_path);
+    buffer << R"(,"line":)" << location.row << R"(,"column":)" << location.column;
+    buffer << R"(,"message":)";
+    append_json_string(buffer, message);
+    buffer << "}\n";
+
+  } else {
+    assert(format == DiagnosticFormat::sarif);
+    if (num_records > 0) {
+      buffer << ',';
+    }
+    buffer << R"({"ruleId":")" << kind << R"(","level":"error","message":{"text":)";
+    append_json_string(buffer, message);
+    buffer << R"(},"locations":[{"physicalLocation":{"artifactLocation":{"uri":)";
+    append_json_string(buffer, location.file_path);
+    buffer << '}';
+    if (location.row > 0) {
+      buffer << R"(,"region":{"startLine":)" << location.row
+             << R"(,"startColumn":)" << location.column << '}';
+    }
+    buffer << "}}]}";
+  }
+
+  num_records++;
+}
+
+DiagnosticSink::Location DiagnosticSink::make_location(const ParseSourceData& source_data,
+                                                       int64_t offset) {
+  Location location{"<anonymous>", -1, -1};
+  if (source_data.file_descriptor) {
+    location.file_path = source_data.file_descriptor->file_path.str();
+  }
+
+  if (source_data.row_col_indices) {
+    if (auto line_info = source_data.row_col_indices->line_info(offset)) {
+      location.row = line_info.value().row;
+    }
+  }
+
+  //  Column is the 1-based byte offset of the error within its line.
+  const auto& source = source_data.source;
+  if (offset >= 0 && offset <= int64_t(source.size())) {
+    const auto line_begin = offset == 0 ? std::string_view::npos : source.rfind('\n', offset - 1);
+    location.column = line_begin == std::string_view::npos ? offset + 1 : offset - int64_t(line_begin);
+  }
+
+  return location;
+}
+
+void DiagnosticSink::maybe_flush() {
+  if (buffer.tellp() >= flush_threshold) {
+    flush();
+  }
+}
+
+void DiagnosticSink::flush() {
+  const auto contents = buffer.str();
+  if (!contents.empty()) {
+    std::cout.write(contents.data(), contents.size());
+    std::cout.flush();
+    buffer.str(std::string());
+  }
+}
+
+void DiagnosticSink::finish() {
+  if (finished) {
+    return;
+  }
+
+  if (format == DiagnosticFormat::sarif) {
+    buffer << sarif_footer << "\n";
+  }
+
+  flush();
+  finished = true;
+}
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "mt/mt.hpp"
+#include <sstream>
+
+namespace mt {
+
+enum class DiagnosticFormat {
+  plain,
+  colored,
+  json_lines,
+  sarif
+};
+
+Optional<DiagnosticFormat> parse_diagnostic_format(std::string_view name);
+
+/*
+ * DiagnosticSink
+ *
+ * Buffers formatted errors and writes them to std::cout in large blocks, rather than flushing on
+ * each line. Source locations are computed only for the errors that are actually emitted. The
+ * plain and colored formats match the output of ShowParseErrors and ShowTypeErrors; the
+ * json_lines format writes one object per error, and the sarif format writes a single SARIF log
+ * once `finish` is called.
+ */
+
+class DiagnosticSink {
+public:
+  DiagnosticSink(DiagnosticFormat format,
+                 const TokenSourceMap& source_data_by_token,
+                 const TypeToString& type_to_string);
+  ~DiagnosticSink() = default;
+
+  DiagnosticSink(const DiagnosticSink& other) = delete;
+  DiagnosticSink& operator=(const DiagnosticSink& other) = delete;
+
+  void emit(const ParseError& err);
+  void emit(const TypeError& err);
+
+  void flush();
+  void finish();
+
+private:
+  struct Location {
+    std::string_view file_path;
+    int64_t row;
+    int64_t column;
+  };
+
+  void emit_record(const char* kind, const Location& location, const std::string& message);
+  void maybe_flush();
+
+  static Location make_location(const ParseSourceData& source_data, int64_t offset);
+
+private:
+  static constexpr int64_t flush_threshold = 64 * 1024;
+
+  DiagnosticFormat format;
+  const TokenSourceMap& source_data_by_token;
+
+  ShowParseErrors show_parse_errors;
+  ShowTypeErrors show_type_errors;
+
+  std::ostringstream buffer;
+  int64_t num_parse_errors;
+  int64_t num_type_errors;
+  int64_t num_records;
+  bool finished;
+};
+
+}
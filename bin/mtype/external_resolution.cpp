@@ -30,19 +30,18 @@ Optional<HandleSearchResult> find_search_handle(const AstStore::Entry* entry,
 
     store.use<Store::ReadConst>([&](const auto& reader) {
       const auto& class_def = reader.at(entry->file_entry_class_def);
+      const auto maybe_method = class_def.lookup_method(candidate.function_name);
+      if (!maybe_method) {
+        return;
+      }
+
+      const auto& method = maybe_method.value();
+      const auto attrs = store.get_attributes(method);
+      const bool is_accessible = attrs.is_constructor() || attrs.is_static();
 
-      for (const auto& method : class_def.methods) {
-        //  @TODO: Needless linear search here.
-        const auto& func_def = reader.at(method);
-        const auto& attrs = func_def.attributes;
-        const bool is_accessible = attrs.is_constructor() || attrs.is_static();
-
-        if (is_accessible &&
-            func_def.header.name == candidate.function_name) {
-          maybe_def_handle = method;
-          maybe_source_token = *func_def.header.name_token;
-          return;
-        }
+      if (is_accessible) {
+        maybe_def_handle = method;
+        maybe_source_token = *reader.at(method).header.name_token;
       }
     });
 
@@ -71,13 +70,18 @@ resolve_external_functions(ResolutionInstance& resolution_instance,
 
   ResolutionPairs result;
 
-  for (auto& ext_candidate : external_functions.pending_functions) {
-    const auto& candidate = ext_candidate.first;
-    auto& pending_funcs = ext_candidate.second;
+  //  Only candidates that gained pending functions, or whose files have since been visited,
+  //  can have become resolvable.
+  for (const auto& candidate : external_functions.take_ready_candidates()) {
+    auto& pending_funcs = external_functions.pending_functions.at(candidate);
+    if (pending_funcs.empty()) {
+      continue;
+    }
 
     auto maybe_entry = ast_store.lookup(candidate.resolved_file->defining_file);
     if (!maybe_entry || !maybe_entry->root_block) {
       //  Didn't parse this file yet, or else failed to parse it.
+      external_functions.await_file(candidate);
       continue;
     }
 
@@ -96,6 +100,7 @@ resolve_external_functions(ResolutionInstance& resolution_instance,
     auto maybe_type = library.lookup_local_function(look_for_type.value().def_handle);
     if (!maybe_type) {
       //  We haven't yet registered the function's type, so defer.
+      external_functions.await_file(candidate);
       continue;
     }
 
@@ -1,6 +1,10 @@
 #include "mt/mt.hpp"
 #include "app.hpp"
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <future>
+#include <thread>
 
 using namespace mt;
 
@@ -12,6 +16,72 @@ namespace {
       return build_search_path_from_paths(args.search_paths);
     }
   }
+
+  bool check(App& app) {
+    bool lookup_success = app.locate_root_identifiers();
+    if (!lookup_success) {
+      return false;
+    }
+
+    //  Visiting a file can discover further candidates, which are queued in turn.
+    auto& external_functions = app.external_functions;
+
+    do {
+      while (external_functions.has_unvisited_candidates()) {
+        const auto candidate = external_functions.next_unvisited_candidate();
+        app.visit_file(candidate.resolved_file->defining_file);
+      }
+      //  Checking the deferred body of an annotated function can discover further candidates.
+    } while (app.check_deferred_function_bodies());
+
+    //  No more files are pending, so we should expect each function
+    //  in each visited file to have a concrete type.
+    app.check_for_concrete_function_types();
+    return true;
+  }
+
+  void check_independent_roots(const cmd::Arguments& arguments, const SearchPath& search_path) {
+    //  Each root is checked by its own app, which shares only the search path with the others,
+    //  and which begins with a copy of the known types, made once up front. Results are shown in
+    //  the order in which the roots were given, as they become available.
+    const BaseLibrary base_library(arguments, search_path);
+    const auto& roots = arguments.root_identifiers;
+    const auto num_roots = int64_t(roots.size());
+    std::vector<std::promise<std::unique_ptr<App>>> checked_apps(num_roots);
+
+    std::atomic<int64_t> next_root{0};
+    auto worker = [&]() {
+      int64_t i;
+      while ((i = next_root++) < num_roots) {
+        auto root_arguments = arguments;
+        root_arguments.root_identifiers = {roots[i]};
+
+        auto app = std::make_unique<App>(root_arguments, search_path, base_library);
+        if (!check(*app)) {
+          app = nullptr;
+        }
+
+        checked_apps[i].set_value(std::move(app));
+      }
+    };
+
+    std::vector<std::thread> threads;
+    const auto num_workers = std::min(int64_t(arguments.num_root_threads), num_roots);
+    for (int64_t i = 0; i < num_workers; i++) {
+      threads.emplace_back(worker);
+    }
+
+    for (auto& checked_app : checked_apps) {
+      auto app = checked_app.get_future().get();
+      if (app) {
+        app->maybe_show();
+      }
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
 }
 
 int main(int argc, char** argv) {
@@ -27,32 +97,21 @@ int main(int argc, char** argv) {
     return 0;
   }
 
-  App app(arguments, std::move(maybe_search_path.value()));
+  const auto& search_path = maybe_search_path.value();
 
-  bool lookup_success = app.locate_root_identifiers();
-  if (!lookup_success) {
+  if (arguments.num_root_threads > 0) {
+    check_independent_roots(arguments, search_path);
     return 0;
   }
 
-  auto& external_functions = app.external_functions;
-  auto external_it = external_functions.visited_candidates.begin();
+  App app(arguments, search_path);
 
-  while (external_it != external_functions.visited_candidates.end()) {
-    const auto candidate = external_it++;
-    const auto& file_path = candidate->resolved_file->defining_file;
-
-    bool should_reset = app.visit_file(file_path);
-    if (should_reset) {
-      external_it = external_functions.visited_candidates.begin();
-    }
+  if (!check(app)) {
+    return 0;
   }
 
-  //  No more files are pending, so we should expect each function
-  //  in each visited file to have a concrete type.
-  app.check_for_concrete_function_types();
-
   //  Display results.
   app.maybe_show();
 
   return 0;
-}
\ No newline at end of file
+}
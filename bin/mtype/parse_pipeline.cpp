@@ -6,9 +6,14 @@
 namespace mt {
 namespace {
 
-void parse_file(ParseInstance* instance, const std::vector<Token>& tokens) {
+void parse_file(ParseInstance* instance, const std::vector<Token>& tokens, bool single_pass) {
+  IdentifierClassifier classifier(instance->string_registry, instance->store, instance->source_data);
   AstGenerator ast_gen(instance, tokens);
 
+  if (single_pass) {
+    ast_gen.classify_identifiers_with(&classifier);
+  }
+
   instance->on_before_parse(ast_gen, *instance);
   ast_gen.parse();
 
@@ -16,8 +21,9 @@ void parse_file(ParseInstance* instance, const std::vector<Token>& tokens) {
     return;
   }
 
-  IdentifierClassifier classifier(instance->string_registry, instance->store, instance->source_data);
-  classifier.transform_root(instance->root_block);
+  if (!single_pass) {
+    classifier.transform_root(instance->root_block);
+  }
 
   auto& errs = classifier.get_errors();
   if (!errs.empty()) {
@@ -129,7 +135,7 @@ AstStore::Entry* run_parse_file(ParseInstance& parse_instance,
   const auto& file_path = scan_result.file_descriptor.file_path;
   auto& ast_store = pipeline_instance.ast_store;
 
-  parse_file(&parse_instance, scan_info.tokens);
+  parse_file(&parse_instance, scan_info.tokens, pipeline_instance.arguments.classify_identifiers_during_parse);
 
   if (parse_instance.had_error) {
     pipeline_instance.add_errors(parse_instance.errors);
@@ -150,6 +156,7 @@ AstStore::Entry* run_parse_file(ParseInstance& parse_instance,
 
   AstStore::Entry entry(std::move(root_block), maybe_class_def,
                         maybe_function_def, maybe_function_def_node, file_type);
+  entry.deferred_function_bodies = std::move(parse_instance.deferred_function_bodies);
 
   return ast_store.insert(file_path, std::move(entry));
 }
@@ -186,7 +193,8 @@ bool traverse_imports(const PendingTypeImports& pending_type_imports,
                       ParsePipelineInstanceData& pipe_instance,
                       const ParseSourceData& source_data) {
   bool success = true;
-  const auto search_dir = fs::directory_name(source_data.file_descriptor->file_path);
+  const auto search_dir =
+    pipe_instance.search_path.directory_id(fs::directory_name(source_data.file_descriptor->file_path));
 
   for (auto& pending_import : pending_type_imports) {
     const auto ident_str = pipe_instance.string_registry.at(pending_import.identifier);
@@ -225,7 +233,8 @@ bool traverse_superclasses(const ClassDefHandle& class_def,
   });
 
   bool success = true;
-  const auto search_dir = fs::directory_name(source_data.file_descriptor->file_path);
+  const auto search_dir =
+    pipe_instance.search_path.directory_id(fs::directory_name(source_data.file_descriptor->file_path));
 
   for (int64_t i = 0; i < int64_t(superclasses.size()); i++) {
     const auto& superclass = superclasses[i];
@@ -497,6 +506,7 @@ ParsePipelineInstanceData::ParsePipelineInstanceData(const SearchPath& search_pa
   functions_by_file(functions_by_file),
   pre_imports(pre_imports),
   source_data_by_token(source_data_by_token),
+  eager_files(nullptr),
   arguments(arguments),
   parse_errors(parse_errors),
   parse_warnings(parse_warnings) {
@@ -535,6 +545,11 @@ std::vector<AstStore::Entry*> ParsePipelineInstanceData::gather_root_entries() c
   return entries;
 }
 
+bool ParsePipelineInstanceData::defers_annotated_function_bodies(const FilePath& file_path) const {
+  return arguments.defer_annotated_function_bodies &&
+    (!eager_files || eager_files->count(file_path) == 0);
+}
+
 void ParsePipelineInstanceData::add_error(const ParseError& err) {
   parse_errors.push_back(err);
 }
@@ -573,6 +588,8 @@ AstStore::Entry* file_entry(ParsePipelineInstanceData& pipe_instance,
   ParseInstance parse_instance(&pipe_instance.store, &pipe_instance.type_store, &pipe_instance.library,
     &pipe_instance.string_registry, &pipe_instance.functions_by_file, source_data,
     scan_result->scan_info.functions_are_end_terminated, std::move(on_before_parse));
+  parse_instance.defer_annotated_function_bodies = pipe_instance.defers_annotated_function_bodies(file_path);
+  parse_instance.function_terminators = &scan_result->scan_info.function_terminators;
 
   const auto root_res = run_parse_file(parse_instance, *scan_result, pipe_instance);
   if (!root_res) {
@@ -588,6 +605,8 @@ AstStore::Entry* file_entry(ParsePipelineInstanceData& pipe_instance,
       traverse_superclasses(parse_instance.file_entry_class_def, pipe_instance, source_data);
 
     if (!super_success) {
+      //  The entry remains in the store; mark it so that a later visit does not use it.
+      root_res->parsed_successfully = false;
       return nullptr;
     }
 
@@ -598,6 +617,7 @@ AstStore::Entry* file_entry(ParsePipelineInstanceData& pipe_instance,
     bool external_method_success =
       traverse_external_methods(pipe_instance, source_data, class_dir_path, external_methods);
     if (!external_method_success) {
+      root_res->parsed_successfully = false;
       return nullptr;
     }
   }
@@ -606,6 +626,7 @@ AstStore::Entry* file_entry(ParsePipelineInstanceData& pipe_instance,
   auto type_scope = root_res->root_block->type_scope;
   bool pre_import_success = traverse_pre_imports(pipe_instance, type_scope);
   if (!pre_import_success) {
+    root_res->parsed_successfully = false;
     return nullptr;
   }
 
@@ -613,6 +634,7 @@ AstStore::Entry* file_entry(ParsePipelineInstanceData& pipe_instance,
     traverse_imports(parse_instance.pending_type_imports, pipe_instance, source_data);
 
   if (!import_success) {
+    root_res->parsed_successfully = false;
     return nullptr;
   }
 
@@ -624,4 +646,43 @@ ParseSourceData FileScanSuccess::to_parse_source_data() const {
   return ParseSourceData(*contents, &file_descriptor, &scan_info.row_column_indices);
 }
 
+bool parse_deferred_function_body(ParsePipelineInstanceData& pipe_instance,
+                                  const AstStore::Entry& entry,
+                                  const DeferredFunctionBody& deferred) {
+  const auto& file_path = entry.root_block->scope->file_descriptor->file_path;
+  const auto& scan_result = *pipe_instance.scan_results.at(file_path);
+  const auto& scan_info = scan_result.scan_info;
+  const auto source_data = scan_result.to_parse_source_data();
+
+  ParseInstance parse_instance(&pipe_instance.store, &pipe_instance.type_store, &pipe_instance.library,
+    &pipe_instance.string_registry, &pipe_instance.functions_by_file, source_data,
+    scan_info.functions_are_end_terminated, on_before_parse_no_op);
+  //  Functions are only deferred in function files.
+  parse_instance.register_file_type(CodeFileType::function_def);
+  parse_instance.mark_visited_function();
+
+  AstGenerator ast_gen(&parse_instance, scan_info.tokens);
+  ast_gen.parse_deferred_function_body(deferred);
+
+  if (!parse_instance.had_error) {
+    IdentifierClassifier classifier(&pipe_instance.string_registry, &pipe_instance.store, source_data);
+    classifier.transform_deferred_function_def(deferred.root_scope, *deferred.node);
+
+    auto& errs = classifier.get_errors();
+    if (!errs.empty()) {
+      parse_instance.had_error = true;
+      parse_instance.errors = std::move(errs);
+    }
+
+    pipe_instance.add_warnings(classifier.get_warnings());
+  }
+
+  if (parse_instance.had_error) {
+    pipe_instance.add_errors(parse_instance.errors);
+    return false;
+  }
+
+  return true;
+}
+
 }
@@ -76,6 +76,7 @@ struct ParsePipelineInstanceData {
   void remove_root(const FilePath& file_path);
 
   std::vector<AstStore::Entry*> gather_root_entries() const;
+  bool defers_annotated_function_bodies(const FilePath& file_path) const;
 
   const SearchPath& search_path;
   Store& store;
@@ -89,6 +90,8 @@ struct ParsePipelineInstanceData {
   TokenSourceMap& source_data_by_token;
   std::unordered_set<RootBlock*> roots;
   std::unordered_set<FilePath, FilePath::Hash> root_files;
+  //  Files whose function bodies are always parsed in full, regardless of arguments.
+  const std::unordered_set<FilePath, FilePath::Hash>* eager_files;
   const cmd::Arguments& arguments;
 
   ParseErrors& parse_errors;
@@ -99,4 +102,8 @@ AstStore::Entry* file_entry(ParsePipelineInstanceData& pipe_instance, const File
                             OnBeforeParse on_before_parse);
 AstStore::Entry* file_entry(ParsePipelineInstanceData& pipe_instance, const FilePath& file_path);
 
+bool parse_deferred_function_body(ParsePipelineInstanceData& pipe_instance,
+                                  const AstStore::Entry& entry,
+                                  const DeferredFunctionBody& deferred);
+
 }
\ No newline at end of file
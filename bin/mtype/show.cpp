@@ -1,6 +1,8 @@
 #include "show.hpp"
 #include "command_line.hpp"
 #include "ast_store.hpp"
+#include <algorithm>
+#include <thread>
 
 namespace mt {
 
@@ -10,6 +12,10 @@ namespace {
   }
 }
 
+int num_render_threads() {
+  return int(std::max(1u, std::thread::hardware_concurrency()));
+}
+
 void configure_type_to_string(TypeToString& type_to_string, const cmd::Arguments& args) {
   type_to_string.explicit_destructured_tuples = args.show_explicit_destructured_tuples;
   type_to_string.explicit_aliases = args.show_explicit_aliases;
@@ -30,28 +36,46 @@ void show_parse_errors(const ParseErrors& errors,
 
 void show_function_types(const FunctionsByFile& functions_by_file,
                          const TypeToString& type_to_string,
-                         const Store& store,
-                         const StringRegistry& string_registry,
-                         const Library& library) {
+                         const Library& library,
+                         int num_threads) {
+  //  Render every type up front, in parallel, then print them in file order. Files are ordered
+  //  by path, rather than by the address of their descriptors, so that the order does not depend
+  //  on where the descriptors happen to be allocated.
+  std::vector<const FunctionsByFile::ByFile::value_type*> files;
   for (const auto& file_it : functions_by_file.store) {
-    const auto& def_handles = file_it.second;
-    std::cout << type_to_string.color(style::underline)
-              << file_it.first->file_path
-              << type_to_string.color(style::dflt) << std::endl;
+    files.push_back(&file_it);
+  }
+
+  std::sort(files.begin(), files.end(), [](const auto* a, const auto* b) {
+    return a->first->file_path.str() < b->first->file_path.str();
+  });
 
-    int64_t def_index = 1;
-    for (const auto& def_handle : def_handles) {
-      const auto maybe_type = library.lookup_local_function(def_handle);
-      if (!maybe_type) {
-        continue;
+  std::vector<const Type*> types;
+  std::vector<int64_t> num_types_per_file;
+
+  for (const auto* file_it : files) {
+    int64_t num_types = 0;
+    for (const auto& def_handle : file_it->second) {
+      if (const auto maybe_type = library.lookup_local_function(def_handle)) {
+        types.push_back(maybe_type.value());
+        num_types++;
       }
+    }
+    num_types_per_file.push_back(num_types);
+  }
 
-      const auto& type = maybe_type.value();
-      const auto func_ident = store.get_name(def_handle);
-      const auto func_name = string_registry.at(func_ident.full_name());
+  const auto type_strs = type_to_string.apply(types, num_threads);
+  int64_t type_index = 0;
+  int64_t file_index = 0;
+
+  for (const auto* file_it : files) {
+    std::cout << type_to_string.color(style::underline)
+              << file_it->first->file_path
+              << type_to_string.color(style::dflt) << std::endl;
 
-      std::cout << mt::spaces(2) << (def_index++) << "."
-                << type_to_string.apply(type) << std::endl;
+    const auto num_types = num_types_per_file[file_index++];
+    for (int64_t i = 0; i < num_types; i++) {
+      std::cout << mt::spaces(2) << (i + 1) << "." << type_strs[type_index++] << std::endl;
     }
 
     std::cout << std::endl;
@@ -24,11 +24,12 @@ void show_type_errors(const std::vector<T>& errors,
                       const TokenSourceMap& source_data,
                       const TypeToString& type_to_string);
 
+int num_render_threads();
+
 void show_function_types(const FunctionsByFile& functions_by_file,
                          const TypeToString& type_to_string,
-                         const Store& store,
-                         const StringRegistry& string_registry,
-                         const Library& library);
+                         const Library& library,
+                         int num_threads);
 
 void show_asts(const AstStore& ast_store,
                const Store& def_store,
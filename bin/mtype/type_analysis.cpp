@@ -131,17 +131,13 @@ bool can_show_untyped_function_errors(const Store& store,
                                       const AstStore& ast_store,
                                       const FunctionDefHandle& def_handle) {
   //  Only show untyped function errors for files for which constraints
-  //  were sucessfully generated.
-  const CodeFileDescriptor* file_descriptor;
-
-  store.use<Store::ReadConst>([&](const auto& reader) {
-    file_descriptor = reader.at(def_handle).scope->file_descriptor;
-  });
-
+  //  were sucessfully generated, and whose function bodies were all checked.
+  const auto* file_descriptor = store.get_scope(def_handle)->file_descriptor;
   const auto& file_path = file_descriptor->file_path;
   const auto maybe_entry = ast_store.lookup(file_path);
 
-  return maybe_entry && maybe_entry->generated_type_constraints;
+  return maybe_entry && maybe_entry->generated_type_constraints &&
+    maybe_entry->deferred_function_bodies.empty();
 }
 
 CheckRecursiveTypesInstance::CheckRecursiveTypesInstance(const PendingSchemes* pending_schemes) :
@@ -0,0 +1,21 @@
+function [c, d] = test_single_pass()
+
+% Classified identically with and without --single-pass-parse: `nested` 
+% sees `later`, which is assigned after it, and `local_after` is called 
+% before it is defined.
+
+a = 1;
+c = nested();
+
+  function y = nested()
+    y = a + later;
+  end
+
+later = 2;
+d = local_after( a );
+
+end
+
+function y = local_after(x)
+y = x;
+end
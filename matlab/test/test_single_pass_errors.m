@@ -0,0 +1,19 @@
+function test_single_pass_errors()
+
+% Reported identically with and without --single-pass-parse.
+
+% `helper` is a local function, even before it is defined.
+helper = 1;
+disp( helper );
+
+  function helper()
+  end
+
+shadowed( 1 );
+shadowed = 3;
+
+end
+
+function shadowed(x)
+disp( x );
+end
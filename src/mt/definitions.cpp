@@ -143,4 +143,22 @@ bool ClassDef::has_superclass(const MatlabIdentifier& test_name) const {
   return false;
 }
 
+void ClassDef::index_method(const FunctionDefHandle& method, const MatlabIdentifier& method_name,
+                            const FunctionAttributes& attributes) {
+  methods_by_name.emplace(method_name, method);
+
+  if (attributes.is_constructor() && !constructor.is_valid()) {
+    constructor = method;
+  }
+}
+
+Optional<FunctionDefHandle> ClassDef::lookup_method(const MatlabIdentifier& method_name) const {
+  const auto it = methods_by_name.find(method_name);
+  if (it == methods_by_name.end()) {
+    return NullOpt{};
+  } else {
+    return Optional<FunctionDefHandle>(it->second);
+  }
+}
+
 }
@@ -334,6 +334,8 @@ struct ClassDef {
 
   using Properties = std::vector<Property>;
   using Methods = std::vector<FunctionDefHandle>;
+  using MethodsByName =
+    std::unordered_map<MatlabIdentifier, FunctionDefHandle, MatlabIdentifier::Hash>;
   using Superclasses = std::vector<Superclass>;
 
   ClassDef() = default;
@@ -355,11 +357,19 @@ struct ClassDef {
 
   bool has_superclass(const MatlabIdentifier& name) const;
 
+  void index_method(const FunctionDefHandle& method, const MatlabIdentifier& method_name,
+                    const FunctionAttributes& attributes);
+  Optional<FunctionDefHandle> lookup_method(const MatlabIdentifier& method_name) const;
+
   Token source_token;
   MatlabIdentifier name;
   Superclasses superclasses;
   Properties properties;
   Methods methods;
+
+  //  Index of `methods`, built when the class is parsed.
+  MethodsByName methods_by_name;
+  FunctionDefHandle constructor;
 };
 
 
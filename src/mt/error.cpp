@@ -6,22 +6,45 @@
 #include "keyword.hpp"
 #include "fs/code_file.hpp"
 #include "source_data.hpp"
+#include <algorithm>
 #include <cassert>
 
 namespace mt {
 
 namespace {
+inline bool is_message_delimiter(char c) {
+  return c == '\n' || c == ' ' || c == '\t';
+}
+
 inline std::string colorize_message(const std::string& msg) {
-  auto split_msg = split_whitespace_copy(msg.c_str(), msg.size(), true);
+  //  Highlight each delimited piece of the message that begins with a keyword, in one pass.
+  const std::string_view view(msg);
+  const auto size = int64_t(view.size());
+
+  std::string result;
+  result.reserve(msg.size());
+
+  int64_t begin = 0;
+  for (int64_t i = 0; i <= size; i++) {
+    if (i < size && !is_message_delimiter(view[i])) {
+      continue;
+    }
 
-  for (auto& m : split_msg) {
-    if (matlab::begins_with_keyword(m)) {
-      m.insert(0, style::yellow);
-      m.append(style::dflt);
+    const auto end = std::min(i + 1, size);
+    const auto piece = view.substr(begin, end - begin);
+
+    if (matlab::begins_with_keyword(piece)) {
+      result += style::yellow;
+      result += piece;
+      result += style::dflt;
+    } else {
+      result += piece;
     }
+
+    begin = end;
   }
 
-  return join(split_msg, "");
+  return result;
 }
 }
 
@@ -29,9 +52,13 @@ bool ParseError::is_null_token() const {
   return at_token.is_null();
 }
 
+int64_t ParseError::source_offset() const {
+  return is_null_token() ? 0 : at_token.lexeme.data() - text.data();
+}
+
 std::string ParseError::make_message(bool colorize) const {
   const bool is_null = is_null_token();
-  const auto start = is_null ? 0 : at_token.lexeme.data() - text.data();
+  const auto start = source_offset();
   const auto stop = is_null ? 0 : at_token.lexeme.data() + at_token.lexeme.size() - text.data();
 
   std::string msg;
@@ -62,14 +89,14 @@ void ShowParseErrors::show(const ParseError& err, const TokenSourceMap& sources_
     const auto& row_col_indices = source_data.row_col_indices;
 
     const auto transformed = err.make_message(is_rich_text);
-    const auto start = err.is_null_token() ? 0 : err.at_token.lexeme.data() - err.text.data();
+    const auto start = err.source_offset();
 
-    std::cout << stylize(style::underline) << index;
+    *out << stylize(style::underline) << index;
 
     if (err.descriptor) {
-      std::cout << ". " << err.descriptor->file_path << " ";
+      *out << ". " << err.descriptor->file_path << " ";
     } else {
-      std::cout << ". <anonymous> ";
+      *out << ". <anonymous> ";
     }
 
     if (row_col_indices) {
@@ -77,11 +104,11 @@ void ShowParseErrors::show(const ParseError& err, const TokenSourceMap& sources_
       auto row = new_line_res ? new_line_res.value().row : -1;
       auto col = new_line_res ? new_line_res.value().column : -1;
 
-      std::cout << "" << row << ":" << col << "";
+      *out << "" << row << ":" << col << "";
     }
 
-    std::cout << stylize(style::dflt) << std::endl << std::endl;
-    std::cout << transformed << std::endl << std::endl << std::endl;
+    *out << stylize(style::dflt) << "\n\n";
+    *out << transformed << "\n\n\n";
   }
 }
 
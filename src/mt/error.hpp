@@ -4,6 +4,7 @@
 #include <string>
 #include <string_view>
 #include <memory>
+#include <iostream>
 
 namespace mt {
 
@@ -38,6 +39,16 @@ public:
     return at_token;
   }
 
+  const std::string& get_message() const {
+    return message;
+  }
+
+  const CodeFileDescriptor* get_descriptor() const {
+    return descriptor;
+  }
+
+  int64_t source_offset() const;
+
   ~ParseError() = default;
 
 private:
@@ -57,7 +68,7 @@ using ParseErrors = std::vector<ParseError>;
 
 class ShowParseErrors {
 public:
-  ShowParseErrors() : is_rich_text(true) {
+  ShowParseErrors() : is_rich_text(true), out(&std::cout) {
     //
   }
 
@@ -69,6 +80,7 @@ private:
 
 public:
   bool is_rich_text;
+  std::ostream* out;
 };
 
 std::string make_error_message_duplicate_type_identifier(std::string_view dup_ident);
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace mt {
+
+/*
+ * HandleMap
+ *
+ * Map from handles (dense, non-negative indices into a Store) to values, stored in fixed-size
+ * pages indexed directly by handle. A page is allocated only once a handle within it is
+ * inserted, so a map whose keys are clustered (e.g., the definitions of one set of files)
+ * stays small. Entries are visited in order of handle.
+ */
+
+template <typename Handle, typename T>
+class HandleMap {
+public:
+  using Entry = std::pair<Handle, T>;
+
+  static constexpr int64_t page_size_log2 = 8;
+  static constexpr int64_t page_size = int64_t(1) << page_size_log2;
+
+private:
+  struct Page {
+    Page() : num_occupied(0) {
+      //
+    }
+
+    //  An entry is unoccupied if its handle is invalid.
+    Entry entries[page_size];
+    int64_t num_occupied;
+  };
+
+  template <typename Map, typename Value>
+  class Iterator {
+    friend class HandleMap;
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Entry;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value*;
+    using reference = Value&;
+
+    reference operator*() const {
+      return map->pages[page]->entries[slot];
+    }
+
+    pointer operator->() const {
+      return &map->pages[page]->entries[slot];
+    }
+
+    Iterator& operator++() {
+      slot++;
+      seek();
+      return *this;
+    }
+
+    friend inline bool operator==(const Iterator& a, const Iterator& b) {
+      return a.page == b.page && a.slot == b.slot;
+    }
+
+    friend inline bool operator!=(const Iterator& a, const Iterator& b) {
+      return !(a == b);
+    }
+
+  private:
+    Iterator(Map* map, int64_t page, int64_t slot) : map(map), page(page), slot(slot) {
+      seek();
+    }
+
+    void seek() {
+      const auto num_pages = int64_t(map->pages.size());
+      while (page < num_pages) {
+        const auto* p = map->pages[page].get();
+        if (p && p->num_occupied > 0) {
+          for (; slot < page_size; slot++) {
+            if (p->entries[slot].first.is_valid()) {
+              return;
+            }
+          }
+        }
+        page++;
+        slot = 0;
+      }
+      slot = 0;
+    }
+
+    Map* map;
+    int64_t page;
+    int64_t slot;
+  };
+
+public:
+  using iterator = Iterator<HandleMap, Entry>;
+  using const_iterator = Iterator<const HandleMap, const Entry>;
+
+  HandleMap() : num_entries(0) {
+    //
+  }
+
+  HandleMap(HandleMap&& other) noexcept = default;
+  HandleMap& operator=(HandleMap&& other) noexcept = default;
+
+  HandleMap(const HandleMap& other) = delete;
+  HandleMap& operator=(const HandleMap& other) = delete;
+
+  T& operator[](const Handle& handle) {
+    auto& entry = require_entry(handle);
+    if (!entry.first.is_valid()) {
+      occupy(entry, handle);
+    }
+    return entry.second;
+  }
+
+  T& at(const Handle& handle) {
+    auto* entry = lookup_entry(handle);
+    assert(entry && "No such handle.");
+    return entry->second;
+  }
+
+  const T& at(const Handle& handle) const {
+    const auto* entry = lookup_entry(handle);
+    assert(entry && "No such handle.");
+    return entry->second;
+  }
+
+  iterator find(const Handle& handle) {
+    return lookup_entry(handle) ? make_iterator<iterator>(this, handle) : end();
+  }
+
+  const_iterator find(const Handle& handle) const {
+    return lookup_entry(handle) ? make_iterator<const_iterator>(this, handle) : end();
+  }
+
+  int64_t count(const Handle& handle) const {
+    return lookup_entry(handle) ? 1 : 0;
+  }
+
+  int64_t erase(const Handle& handle) {
+    auto* entry = lookup_entry(handle);
+    if (!entry) {
+      return 0;
+    }
+
+    *entry = Entry();
+    pages[handle.get_index() >> page_size_log2]->num_occupied--;
+    num_entries--;
+    return 1;
+  }
+
+  int64_t size() const {
+    return num_entries;
+  }
+
+  bool empty() const {
+    return num_entries == 0;
+  }
+
+  iterator begin() {
+    return iterator(this, 0, 0);
+  }
+
+  iterator end() {
+    return iterator(this, int64_t(pages.size()), 0);
+  }
+
+  const_iterator begin() const {
+    return const_iterator(this, 0, 0);
+  }
+
+  const_iterator end() const {
+    return const_iterator(this, int64_t(pages.size()), 0);
+  }
+
+private:
+  template <typename It, typename Map>
+  static It make_iterator(Map* map, const Handle& handle) {
+    const auto index = handle.get_index();
+    return It(map, index >> page_size_log2, index & (page_size - 1));
+  }
+
+  Entry* lookup_entry(const Handle& handle) const {
+    assert(handle.is_valid());
+    const auto index = handle.get_index();
+    const auto page = index >> page_size_log2;
+
+    if (page >= int64_t(pages.size()) || !pages[page]) {
+      return nullptr;
+    }
+
+    auto& entry = pages[page]->entries[index & (page_size - 1)];
+    return entry.first.is_valid() ? &entry : nullptr;
+  }
+
+  Entry& require_entry(const Handle& handle) {
+    assert(handle.is_valid());
+    const auto index = handle.get_index();
+    const auto page = index >> page_size_log2;
+
+    if (page >= int64_t(pages.size())) {
+      pages.resize(page + 1);
+    }
+    if (!pages[page]) {
+      pages[page] = std::make_unique<Page>();
+    }
+
+    return pages[page]->entries[index & (page_size - 1)];
+  }
+
+  void occupy(Entry& entry, const Handle& handle) {
+    entry.first = handle;
+    pages[handle.get_index() >> page_size_log2]->num_occupied++;
+    num_entries++;
+  }
+
+private:
+  std::vector<std::unique_ptr<Page>> pages;
+  int64_t num_entries;
+};
+
+}
@@ -1,4 +1,5 @@
 #include "ast_gen.hpp"
+#include "identifier_classification.hpp"
 #include "../string.hpp"
 #include "../keyword.hpp"
 #include "../type/type_store.hpp"
@@ -26,6 +27,11 @@ namespace {
       }};
   }
 
+  bool is_type_annotation_block_keyword(const Token& tok) {
+    //  Keywords within a type annotation that are terminated by `end`, as in the scanner.
+    return tok.type == from_symbol(tok.lexeme) && mt::is_end_terminated(tok.lexeme);
+  }
+
   std::array<TokenType, 5> sub_block_possible_types() {
     return {
       {TokenType::keyword_if, TokenType::keyword_for, TokenType::keyword_while,
@@ -301,6 +307,8 @@ ParseInstance::ParseInstance(Store* store,
   source_data(source_data),
   functions_are_end_terminated(functions_are_end_terminated),
   treat_root_as_external_method(false),
+  defer_annotated_function_bodies(false),
+  function_terminators(nullptr),
   on_before_parse(std::move(on_before_parse)),
   had_error(false),
   num_visited_functions(0),
@@ -374,6 +382,48 @@ struct BlockStmtScopeHelper {
   int* scope;
 };
 
+struct ClassifierContextHelper {
+  explicit ClassifierContextHelper(IdentifierClassifier* classifier) : classifier(classifier) {
+    if (classifier) {
+      classifier->push_context();
+    }
+  }
+  ~ClassifierContextHelper() {
+    if (classifier) {
+      classifier->pop_context();
+    }
+  }
+
+  IdentifierClassifier* classifier;
+};
+
+struct ClassifierAssignmentContextHelper {
+  explicit ClassifierAssignmentContextHelper(IdentifierClassifier* classifier) : classifier(classifier) {
+    if (classifier) {
+      classifier->push_variable_assignment_context();
+    }
+  }
+  ~ClassifierAssignmentContextHelper() {
+    if (classifier) {
+      classifier->pop_variable_assignment_context();
+    }
+  }
+
+  IdentifierClassifier* classifier;
+};
+
+struct DeferredClassificationHelper {
+  DeferredClassificationHelper(int* depth, bool defer) : depth(depth), defer(defer) {
+    *depth += defer;
+  }
+  ~DeferredClassificationHelper() {
+    *depth -= defer;
+  }
+
+  int* depth;
+  bool defer;
+};
+
 struct ParseScopeStack {
   static void push(AstGenerator& gen) {
     gen.push_scope();
@@ -408,10 +458,17 @@ AstGenerator::AstGenerator(ParseInstance* instance, const std::vector<Token>& to
   parse_instance(instance),
   iterator(TokenIterator(&tokens)),
   string_registry(instance->string_registry),
-  store(instance->store) {
+  store(instance->store),
+  next_function_def_annotation(nullptr),
+  identifier_classifier(nullptr),
+  deferred_classification_depth(0) {
   push_default_state();
 }
 
+void AstGenerator::classify_identifiers_with(IdentifierClassifier* classifier) {
+  identifier_classifier = classifier;
+}
+
 void AstGenerator::push_default_state() {
   //  No enclosing scheme
   enclosing_schemes.push_back(nullptr);
@@ -427,12 +484,33 @@ void AstGenerator::push_default_state() {
 }
 
 void AstGenerator::parse() {
-  auto result = block();
+  //  Files that cannot be classified in a single pass are classified once parsed.
+  auto* classifier = identifier_classifier;
+  const bool classify_after_parse = classifier && !find_held_function_classifications();
+  Optional<std::unique_ptr<Block>> result;
+
+  {
+    DeferredClassificationHelper defer_helper(&deferred_classification_depth, classify_after_parse);
+
+    if (auto* eager_classifier = eager_identifier_classifier()) {
+      eager_classifier->enter_root(current_scope());
+    }
+
+    result = block();
+
+    if (auto* eager_classifier = eager_identifier_classifier()) {
+      eager_classifier->exit_root();
+    }
+  }
 
   if (result) {
     auto block_node = std::move(result.rvalue());
     auto root_node = std::make_unique<RootBlock>(std::move(block_node), current_scope(), current_type_scope());
     parse_instance->root_block = std::move(root_node);
+
+    if (classify_after_parse) {
+      classifier->transform_root(parse_instance->root_block);
+    }
   } else {
     parse_instance->had_error = true;
   }
@@ -747,6 +825,9 @@ Optional<std::unique_ptr<FunctionDefNode>> AstGenerator::function_def() {
   const auto& source_token = iterator.peek();
   iterator.advance();
 
+  const auto* annotation = next_function_def_annotation;
+  next_function_def_annotation = nullptr;
+
   if (!parse_instance->registered_file_type) {
     parse_instance->register_file_type(CodeFileType::function_def);
   }
@@ -772,6 +853,13 @@ Optional<std::unique_ptr<FunctionDefNode>> AstGenerator::function_def() {
   Optional<std::unique_ptr<Block>> body_res;
   MatlabScope* child_scope = nullptr;
   TypeScope* child_type_scope = nullptr;
+  Optional<int64_t> deferred_body_begin;
+
+  auto* classifier = eager_identifier_classifier();
+
+  if (annotation && can_defer_function_body()) {
+    deferred_body_begin = skip_function_body(source_token);
+  }
 
   {
     //  Increment scope, and decrement upon block exit.
@@ -779,7 +867,21 @@ Optional<std::unique_ptr<FunctionDefNode>> AstGenerator::function_def() {
     child_scope = current_scope();
     child_type_scope = current_type_scope();
 
-    body_res = sub_block();
+    if (classifier) {
+      classifier->enter_function(child_scope, header_result.value());
+    }
+    MT_SCOPE_EXIT {
+      if (classifier) {
+        classifier->exit_function();
+      }
+    };
+
+    if (deferred_body_begin) {
+      //  The body is parsed (and classified) later, if at all.
+      body_res = std::unique_ptr<Block>(nullptr);
+    } else {
+      body_res = sub_block();
+    }
     if (!body_res) {
       return NullOpt{};
     }
@@ -832,15 +934,19 @@ Optional<std::unique_ptr<FunctionDefNode>> AstGenerator::function_def() {
     ref_handle = writer.make_local_reference(name, def_handle, child_scope);
   }
 
-  Store::ReadMut reader(*store);
-  auto& parent_scope = *current_scope();
-
   bool register_success = true;
+  bool registered_in_parent = false;
 
-  if (root_is_external_method() || !is_within_class() || !is_within_top_level_function()) {
-    //  In a classdef file, adjacent top-level methods are not visible to one another, so we don't
-    //  register them in the parent's scope.
-    register_success = parent_scope.register_local_function(name, ref_handle);
+  {
+    Store::ReadMut reader(*store);
+    auto& parent_scope = *current_scope();
+
+    if (root_is_external_method() || !is_within_class() || !is_within_top_level_function()) {
+      //  In a classdef file, adjacent top-level methods are not visible to one another, so we don't
+      //  register them in the parent's scope.
+      register_success = parent_scope.register_local_function(name, ref_handle);
+      registered_in_parent = true;
+    }
   }
 
   if (!register_success) {
@@ -848,9 +954,18 @@ Optional<std::unique_ptr<FunctionDefNode>> AstGenerator::function_def() {
     return NullOpt{};
   }
 
+  if (registered_in_parent && classifier) {
+    classifier->register_local_function(source_token, ref_handle);
+  }
+
   auto ast_node = std::make_unique<FunctionDefNode>(source_token, def_handle, ref_handle,
                                                     child_scope, child_type_scope);
 
+  if (deferred_body_begin) {
+    parse_instance->deferred_function_bodies.emplace_back(
+      ast_node.get(), annotation, deferred_body_begin.value(), root_scope(), root_type_scope());
+  }
+
   //  Mark this function as the function accessible to external files by its filename.
   if (parse_instance->is_file_entry_function() || attrs.is_constructor()) {
     parse_instance->set_file_entry_function_ref(ref_handle, ast_node.get());
@@ -861,6 +976,251 @@ Optional<std::unique_ptr<FunctionDefNode>> AstGenerator::function_def() {
   return Optional<std::unique_ptr<FunctionDefNode>>(std::move(ast_node));
 }
 
+Optional<std::unique_ptr<FunctionDefNode>>
+AstGenerator::held_function_def(const Token& source_token, std::vector<FunctionDefNode*>& held_functions) {
+  auto* classifier = eager_identifier_classifier();
+  if (!classifier || !holds_function_classification(source_token)) {
+    return function_def();
+  }
+
+  Optional<std::unique_ptr<FunctionDefNode>> def_res;
+  {
+    DeferredClassificationHelper defer_helper(&deferred_classification_depth, true);
+    def_res = function_def();
+  }
+
+  if (def_res) {
+    //  The function is visible to the rest of the block as soon as it is defined.
+    auto* def_node = def_res.value().get();
+    classifier->register_local_function(def_node->source_token, def_node->ref_handle);
+    held_functions.push_back(def_node);
+  }
+
+  return def_res;
+}
+
+bool AstGenerator::can_defer_function_body() const {
+  //  Only top-level functions of end-terminated function files are deferred, so that the body
+  //  can be re-entered given just the file's root scope.
+  return parse_instance->defer_annotated_function_bodies &&
+    parse_instance->function_terminators &&
+    parse_instance->functions_are_end_terminated &&
+    parse_instance->is_function_file() &&
+    is_within_top_level_function() &&
+    !is_within_class() &&
+    !root_is_external_method();
+}
+
+bool AstGenerator::find_held_function_classifications() {
+  //  Finds the functions whose classification must be held until the end of their block, with a
+  //  pass over the file's tokens. Returns false if the file cannot be classified in a single pass.
+  struct Level {
+    int64_t function_begin = -1;
+    int64_t terminator = -1;
+    bool holds_functions = false;
+    std::vector<int64_t> pending_functions;
+  };
+
+  const bool end_terminated = parse_instance->functions_are_end_terminated;
+  const auto* terminators = parse_instance->function_terminators;
+
+  if (end_terminated && !terminators) {
+    return false;
+  }
+
+  const auto source = parse_instance->source_text();
+  std::vector<Level> levels(1);
+  bool is_class_file = false;
+  //  Depth of end-terminated blocks within the current type annotation, or -1 if not within one.
+  int annotation_depth = -1;
+
+  for (int64_t i = 0; ; i++) {
+    const auto& tok = iterator.peek_nth(i);
+    if (tok.type == TokenType::null) {
+      break;
+    }
+
+    const int64_t offset = tok.lexeme.data() - source.data();
+
+    if (levels.size() > 1 && offset == levels.back().terminator) {
+      //  End of the current function.
+      levels.pop_back();
+      continue;
+    }
+
+    if (annotation_depth >= 0) {
+      //  Within a type annotation, which ends as in the scanner.
+      if (tok.type == TokenType::keyword_end_type) {
+        if (annotation_depth == 0 || --annotation_depth == 0) {
+          annotation_depth = -1;
+        }
+      } else if (is_type_annotation_block_keyword(tok)) {
+        annotation_depth++;
+      }
+      continue;
+    }
+
+    switch (tok.type) {
+      case TokenType::new_line:
+      case TokenType::semicolon:
+      case TokenType::comma:
+        continue;
+
+      case TokenType::type_annotation_macro:
+        annotation_depth = 0;
+        break;
+
+      case TokenType::keyword_function: {
+        if (!end_terminated && levels.size() > 1) {
+          //  A non-end-terminated function ends where the next one begins.
+          levels.pop_back();
+        }
+
+        auto& level = levels.back();
+        if (level.holds_functions) {
+          held_function_classifications.insert(offset);
+        } else {
+          level.pending_functions.push_back(offset);
+        }
+
+        Level function_level;
+        function_level.function_begin = offset;
+
+        if (end_terminated) {
+          const auto terminator_it = terminators->find(offset);
+          if (terminator_it == terminators->end()) {
+            return false;
+          }
+          function_level.terminator = terminator_it->second;
+        }
+
+        levels.push_back(std::move(function_level));
+        continue;
+      }
+
+      case TokenType::keyword_classdef:
+        is_class_file = true;
+        break;
+
+      case TokenType::keyword_import:
+        //  The separate pass registers a scope's imports before classifying any of its
+        //  identifiers, so the enclosing function is classified once complete. Imports at the
+        //  top level and in methods are not held.
+        if (levels.size() == 1 || is_class_file) {
+          return false;
+        }
+        held_function_classifications.insert(levels.back().function_begin);
+        break;
+
+      default:
+        break;
+    }
+
+    //  This token is part of a statement (or type annotation) of the current block, which the
+    //  separate pass classifies before any of the block's functions.
+    auto& level = levels.back();
+    if (!level.pending_functions.empty()) {
+      held_function_classifications.insert(level.pending_functions.begin(), level.pending_functions.end());
+      level.pending_functions.clear();
+      level.holds_functions = true;
+    }
+
+  }
+
+  return true;
+}
+
+bool AstGenerator::holds_function_classification(const Token& function_token) const {
+  if (!identifier_classifier || held_function_classifications.empty()) {
+    return false;
+  }
+
+  const int64_t offset = function_token.lexeme.data() - parse_instance->source_text().data();
+  return held_function_classifications.count(offset) > 0;
+}
+
+void AstGenerator::classify_held_functions(const std::vector<FunctionDefNode*>& held_functions) {
+  auto* classifier = eager_identifier_classifier();
+  if (!classifier) {
+    //  Classified with the enclosing node.
+    return;
+  }
+
+  for (auto* def_node : held_functions) {
+    classifier->function_def_node(*def_node);
+  }
+}
+
+Optional<int64_t> AstGenerator::skip_function_body(const Token& function_token) {
+  const auto source = parse_instance->source_text();
+  const auto& terminators = *parse_instance->function_terminators;
+  const auto terminator_it = terminators.find(function_token.lexeme.data() - source.data());
+
+  if (terminator_it == terminators.end()) {
+    return NullOpt{};
+  }
+
+  const char* terminator = source.data() + terminator_it->second;
+  int64_t num_tokens = 0;
+
+  while (true) {
+    const auto& tok = iterator.peek_nth(num_tokens);
+
+    if (tok.type == TokenType::null) {
+      return NullOpt{};
+
+    } else if (tok.type == TokenType::type_annotation_macro) {
+      //  Type annotations within the body can introduce type identifiers and imports that must be
+      //  visible when the file's types are resolved; parse the body now.
+      return NullOpt{};
+
+    } else if (tok.type == TokenType::keyword_end && tok.lexeme.data() == terminator) {
+      break;
+    }
+
+    num_tokens++;
+  }
+
+  const auto body_begin = iterator.next_index();
+  iterator.advance(num_tokens);
+
+  return Optional<int64_t>(body_begin);
+}
+
+void AstGenerator::parse_deferred_function_body(const DeferredFunctionBody& deferred) {
+  scopes.clear();
+  type_scopes.clear();
+
+  scopes.push_back(deferred.root_scope);
+  type_scopes.push_back(deferred.root_type_scope);
+  scopes.push_back(deferred.node->scope);
+  type_scopes.push_back(deferred.node->type_scope);
+
+  BlockStmtScopeHelper block_depth_helper(&block_depths.function_def);
+
+  assert(iterator.next_index() == 0);
+  iterator.advance(deferred.body_begin);
+
+  auto body_res = sub_block();
+  if (body_res) {
+    auto err = consume(TokenType::keyword_end);
+    if (err) {
+      add_error(err.rvalue());
+      body_res = NullOpt{};
+    }
+  }
+
+  if (!body_res) {
+    parse_instance->had_error = true;
+    return;
+  }
+
+  Store::ReadMut reader(*store);
+  auto& def = reader.at(deferred.node->def_handle);
+  assert(!def.body);
+  def.body = std::move(body_res.rvalue());
+}
+
 Optional<MatlabIdentifier> AstGenerator::superclass_name() {
   auto superclass_res = compound_identifier_components();
   if (!superclass_res) {
@@ -1062,6 +1422,10 @@ Optional<BoxedAstNode> AstGenerator::class_def() {
   ClassDef class_def(source_token, qualified_name, std::move(supers),
                      std::move(properties), std::move(methods));
 
+  for (const auto& method : class_def.methods) {
+    class_def.index_method(method, store->get_name(method), store->get_attributes(method));
+  }
+
   {
     Store::Write writer(*store);
     writer.emplace_definition(class_handle, std::move(class_def));
@@ -1623,6 +1987,7 @@ Optional<std::unique_ptr<Block>> AstGenerator::block() {
 
   std::vector<BoxedAstNode> functions;
   std::vector<BoxedAstNode> non_functions;
+  std::vector<FunctionDefNode*> held_functions;
 
   while (iterator.has_next() && should_proceed) {
     BoxedAstNode node;
@@ -1660,7 +2025,7 @@ Optional<std::unique_ptr<Block>> AstGenerator::block() {
         break;
       }
       case TokenType::keyword_function: {
-        auto def_res = function_def();
+        auto def_res = held_function_def(tok, held_functions);
         if (def_res) {
           node = def_res.rvalue();
           is_function = true;
@@ -1701,6 +2066,8 @@ Optional<std::unique_ptr<Block>> AstGenerator::block() {
   if (any_error) {
     return NullOpt{};
   } else {
+    classify_held_functions(held_functions);
+
     auto block_node = std::make_unique<Block>();
     block_node->append_many(non_functions);
     block_node->append_many(functions);
@@ -1714,6 +2081,7 @@ Optional<std::unique_ptr<Block>> AstGenerator::sub_block() {
 
   std::vector<BoxedAstNode> functions;
   std::vector<BoxedAstNode> non_functions;
+  std::vector<FunctionDefNode*> held_functions;
 
   while (iterator.has_next() && should_proceed) {
     BoxedAstNode node;
@@ -1748,7 +2116,7 @@ Optional<std::unique_ptr<Block>> AstGenerator::sub_block() {
       }
       case TokenType::keyword_function: {
         if (parse_instance->functions_are_end_terminated) {
-          auto def_res = function_def();
+          auto def_res = held_function_def(tok, held_functions);
           if (def_res) {
             node = def_res.rvalue();
             is_function = true;
@@ -1789,6 +2157,8 @@ Optional<std::unique_ptr<Block>> AstGenerator::sub_block() {
   if (any_error) {
     return NullOpt{};
   } else {
+    classify_held_functions(held_functions);
+
     auto block_node = std::make_unique<Block>();
     block_node->append_many(non_functions);
     block_node->append_many(functions);
@@ -1902,6 +2272,11 @@ Optional<BoxedExpr> AstGenerator::identifier_reference_expr(const Token& source_
   std::vector<Subscript> subscripts;
   SubscriptMethod prev_method = SubscriptMethod::unknown;
 
+  //  Subscript arguments are classified along with the reference itself, rather than as they
+  //  are parsed, so that they are visited in the same order as in a separate classification pass.
+  auto* classifier = eager_identifier_classifier();
+  DeferredClassificationHelper defer_helper(&deferred_classification_depth, classifier != nullptr);
+
   while (iterator.has_next()) {
     const auto& tok = iterator.peek();
 
@@ -1944,6 +2319,15 @@ Optional<BoxedExpr> AstGenerator::identifier_reference_expr(const Token& source_
   const int64_t primary_identifier_id = string_registry->register_string(main_ident_res.value());
   MatlabIdentifier primary_identifier(primary_identifier_id);
 
+  if (classifier && iterator.peek().type != TokenType::at) {
+    //  Classify the reference directly, without allocating an intermediate node. A reference
+    //  followed by `@` is part of a superclass method reference, and is classified with it.
+    IdentifierReferenceExpr reference_expr(source_token, primary_identifier, std::move(subscripts));
+    auto* classified_expr = classifier->identifier_reference_expr(reference_expr);
+    assert(classified_expr != &reference_expr);
+    return Optional<BoxedExpr>(BoxedExpr(classified_expr));
+  }
+
   auto node = std::make_unique<IdentifierReferenceExpr>(source_token, primary_identifier, std::move(subscripts));
   return Optional<BoxedExpr>(std::move(node));
 }
@@ -1962,6 +2346,11 @@ Optional<BoxedExpr> AstGenerator::function_reference_expr(const Token& source_to
   MatlabIdentifier identifier(compound_identifier, component_identifiers.size());
 
   auto node = std::make_unique<FunctionReferenceExpr>(source_token, identifier);
+
+  if (auto* classifier = eager_identifier_classifier()) {
+    classifier->function_reference_expr(*node);
+  }
+
   return Optional<BoxedExpr>(std::move(node));
 }
 
@@ -1985,6 +2374,16 @@ Optional<BoxedExpr> AstGenerator::anonymous_function_expr(const mt::Token& sourc
     return NullOpt{};
   }
 
+  auto* classifier = eager_identifier_classifier();
+  if (classifier) {
+    classifier->enter_anonymous_function(scope, source_token, input_res.value());
+  }
+  MT_SCOPE_EXIT {
+    if (classifier) {
+      classifier->exit_anonymous_function();
+    }
+  };
+
   //  @Hack: Expect artificially-inserted comma to mark the beginning of the anonymous function
   //  expression. This is necessary to correctly parse expressions that begin with the prefix unary
   //  operators +/-, e.g. in @(a) -1; Otherwise, the right parens would cause `expr()` to parse the
@@ -2108,103 +2507,134 @@ Optional<BoxedExpr> AstGenerator::ignore_argument_expr(const Token& source_token
   return Optional<BoxedExpr>(std::move(source_node));
 }
 
-std::unique_ptr<UnaryOperatorExpr> AstGenerator::pending_unary_prefix_expr(const mt::Token& source_token) {
-  iterator.advance();
-  const auto op = unary_operator_from_token_type(source_token.type);
-  //  Awaiting expr.
-  return std::make_unique<UnaryOperatorExpr>(source_token, op, nullptr);
-}
+Optional<BoxedExpr> AstGenerator::unary_expr(bool is_exponent) {
+  auto& prefix_operators = expr_stack.prefix_operators;
+  const auto prefix_begin = int64_t(prefix_operators.size());
 
-Optional<ParseError> AstGenerator::postfix_unary_expr(const mt::Token& source_token,
-                                                      std::vector<BoxedExpr>& completed) {
-  iterator.advance();
+  MT_SCOPE_EXIT {
+    prefix_operators.erase(prefix_operators.begin() + prefix_begin, prefix_operators.end());
+  };
 
-  if (completed.empty()) {
-    return Optional<ParseError>(make_error_expected_lhs(parse_instance, source_token));
+  while (is_unary_prefix_expr(iterator.peek()) && !is_ignore_argument_expr(iterator.peek())) {
+    prefix_operators.push_back(iterator.peek());
+    iterator.advance();
   }
 
-  const auto op = unary_operator_from_token_type(source_token.type);
-  auto node = std::make_unique<UnaryOperatorExpr>(source_token, op, std::move(completed.back()));
-  completed.back() = std::move(node);
+  const auto& tok = iterator.peek();
 
-  return NullOpt{};
-}
+  if (represents_expr_terminator(tok.type)) {
+    if (is_exponent || int64_t(prefix_operators.size()) > prefix_begin) {
+      //  e.g. `a = -;` or `a = b^;`
+      add_error(make_error_incomplete_expr(parse_instance, tok));
+      return NullOpt{};
+    }
+    //  No operand.
+    return Optional<BoxedExpr>(nullptr);
+  }
 
-Optional<ParseError> AstGenerator::handle_postfix_unary_exprs(std::vector<BoxedExpr>& completed) {
-  while (iterator.has_next()) {
-    const auto& curr = iterator.peek();
-    const auto& prev = iterator.peek_prev();
+  auto operand_res = primary_expr(tok);
+  if (!operand_res) {
+    return NullOpt{};
+  }
 
-    if (represents_postfix_unary_operator(curr.type) && can_precede_postfix_unary_operator(prev.type)) {
-      auto err = postfix_unary_expr(curr, completed);
-      if (err) {
-        return err;
-      }
-    } else {
-      break;
+  auto operand = std::move(operand_res.rvalue());
+  postfix_unary_exprs(operand);
+
+  //  Power operators bind more tightly than prefix operators, e.g. `-a^2` is `-(a^2)`, and are
+  //  left-associative, e.g. `a^b^c` is `(a^b)^c`. Prefix operators in an exponent apply to that
+  //  operand alone, e.g. `a^-b^c` is `(a^(-b))^c`.
+  while (!is_exponent && represents_power_operator(iterator.peek().type)) {
+    const auto& op_token = iterator.peek();
+    iterator.advance();
+
+    auto exponent_res = unary_expr(true);
+    if (!exponent_res) {
+      return NullOpt{};
     }
+
+    const auto op = binary_operator_from_token_type(op_token.type);
+    operand = std::make_unique<BinaryOperatorExpr>(op_token, op, std::move(operand), std::move(exponent_res.rvalue()));
   }
 
-  return NullOpt{};
-}
+  //  Prefix operators bind more tightly than the remaining binary operators, e.g. `-a*b` is
+  //  `(-a)*b`, and less tightly than postfix operators, e.g. `-a'` is `-(a')`.
+  while (int64_t(prefix_operators.size()) > prefix_begin) {
+    const auto source_token = prefix_operators.back();
+    prefix_operators.pop_back();
 
-void AstGenerator::handle_prefix_unary_exprs(std::vector<BoxedExpr>& completed,
-                                             std::vector<BoxedUnaryOperatorExpr>& unaries) {
-  while (!unaries.empty()) {
-    auto un = std::move(unaries.back());
-    unaries.pop_back();
-    assert(!un->expr && "Unary already had an expression.");
-    un->expr = std::move(completed.back());
-    completed.back() = std::move(un);
+    const auto op = unary_operator_from_token_type(source_token.type);
+    operand = std::make_unique<UnaryOperatorExpr>(source_token, op, std::move(operand));
   }
+
+  return Optional<BoxedExpr>(std::move(operand));
 }
 
-void AstGenerator::handle_binary_exprs(std::vector<BoxedExpr>& completed,
-                                       std::vector<BoxedBinaryOperatorExpr>& binaries,
-                                       std::vector<BoxedBinaryOperatorExpr>& pending_binaries) {
-  assert(!binaries.empty() && "Binaries were empty.");
-  auto bin = std::move(binaries.back());
-  binaries.pop_back();
+Optional<BoxedExpr> AstGenerator::primary_expr(const Token& source_token) {
+  if (source_token.type == TokenType::identifier) {
+    auto node_res = identifier_reference_expr(source_token);
+    if (node_res && iterator.peek().type == TokenType::at) {
+      //  method@superclass()
+      node_res = presumed_superclass_method_reference_expr(iterator.peek(), std::move(node_res.rvalue()));
+    }
+    return node_res;
+
+  } else if (is_ignore_argument_expr(source_token)) {
+    return ignore_argument_expr(source_token);
 
-  auto prec_curr = precedence(bin->op);
-  const auto op_next = binary_operator_from_token_type(iterator.peek().type);
-  const auto prec_next = precedence(op_next);
+  } else if (represents_grouping_initiator(source_token.type)) {
+    return grouping_expr(source_token);
+
+  } else if (represents_literal(source_token.type)) {
+    return literal_expr(source_token);
+
+  } else if (source_token.type == TokenType::op_end) {
+    iterator.advance();
+    return Optional<BoxedExpr>(std::make_unique<EndOperatorExpr>(source_token));
+
+  } else if (is_colon_subscript_expr(source_token)) {
+    return colon_subscript_expr(source_token);
+
+  } else if (source_token.type == TokenType::at) {
+    return function_expr(source_token);
+
+  } else if (represents_binary_operator(source_token.type)) {
+    //  e.g. `a = * b;`
+    add_error(make_error_expected_lhs(parse_instance, source_token));
+    return NullOpt{};
 
-  if (prec_curr < prec_next) {
-    pending_binaries.emplace_back(std::move(bin));
   } else {
-    assert(!bin->right && "Binary already had an expression.");
-    auto complete = std::move(completed.back());
-    bin->right = std::move(complete);
-    completed.back() = std::move(bin);
-
-    while (!pending_binaries.empty() && prec_next < prec_curr) {
-      auto pend = std::move(pending_binaries.back());
-      pending_binaries.pop_back();
-      prec_curr = precedence(pend->op);
-      pend->right = std::move(completed.back());
-      completed.back() = std::move(pend);
-    }
+    add_error(make_error_invalid_expr_token(parse_instance, source_token));
+    return NullOpt{};
   }
 }
 
-Optional<ParseError> AstGenerator::pending_binary_expr(const mt::Token& source_token,
-                                                       std::vector<BoxedExpr>& completed,
-                                                       std::vector<BoxedBinaryOperatorExpr>& binaries) {
-  iterator.advance(); //  Consume operator token.
+void AstGenerator::postfix_unary_exprs(BoxedExpr& operand) {
+  while (iterator.has_next()) {
+    const auto& curr = iterator.peek();
+    const auto& prev = iterator.peek_prev();
+
+    if (!represents_postfix_unary_operator(curr.type) || !can_precede_postfix_unary_operator(prev.type)) {
+      break;
+    }
 
-  if (completed.empty()) {
-    return Optional<ParseError>(make_error_expected_lhs(parse_instance, source_token));
+    iterator.advance();
+    const auto op = unary_operator_from_token_type(curr.type);
+    operand = std::make_unique<UnaryOperatorExpr>(curr, op, std::move(operand));
   }
+}
 
-  auto left = std::move(completed.back());
-  completed.pop_back();
+void AstGenerator::reduce_binary_expr() {
+  auto& operands = expr_stack.operands;
+  auto& operators = expr_stack.operators;
+  assert(operands.size() >= 2 && !operators.empty());
 
-  const auto op = binary_operator_from_token_type(source_token.type);
-  auto pending = std::make_unique<BinaryOperatorExpr>(source_token, op, std::move(left), nullptr);
-  binaries.emplace_back(std::move(pending));
+  auto right = std::move(operands.back());
+  operands.pop_back();
 
-  return NullOpt{};
+  const auto& pending = operators.back();
+  auto& left = operands.back();
+  left = std::make_unique<BinaryOperatorExpr>(pending.source_token, pending.op, std::move(left), std::move(right));
+  operators.pop_back();
 }
 
 Optional<BoxedExpr> AstGenerator::function_expr(const Token& source_token) {
@@ -2224,7 +2654,14 @@ Optional<BoxedExpr> AstGenerator::presumed_superclass_method_reference_expr(cons
   //  to a plain identifier, implicitly deleting `method_reference_expr` when this function returns.
   iterator.advance(); //  consume @
 
-  auto superclass_res = expr();
+  auto* classifier = eager_identifier_classifier();
+  Optional<BoxedExpr> superclass_res;
+
+  {
+    DeferredClassificationHelper defer_helper(&deferred_classification_depth, true);
+    superclass_res = expr();
+  }
+
   if (!superclass_res) {
     return NullOpt{};
   }
@@ -2248,105 +2685,93 @@ Optional<BoxedExpr> AstGenerator::presumed_superclass_method_reference_expr(cons
 
   auto node = std::make_unique<SuperclassMethodReferenceExpr>(source_token,
                                                               invoking_argument, std::move(superclass_method_expr));
+  if (classifier) {
+    classifier->superclass_method_reference_expr(*node);
+  }
 
   return Optional<BoxedExpr>(std::move(node));
 }
 
 Optional<BoxedExpr> AstGenerator::expr(bool allow_empty) {
-  std::vector<BoxedBinaryOperatorExpr> pending_binaries;
-  std::vector<BoxedBinaryOperatorExpr> binaries;
-  std::vector<BoxedUnaryOperatorExpr> unaries;
-  std::vector<BoxedExpr> completed;
-
-  while (iterator.has_next()) {
-    Optional<BoxedExpr> node_res(nullptr);
-    const auto& tok = iterator.peek();
+  //  Operator-precedence parse of a sequence of unary expressions separated by binary operators.
+  //  The operands and operators of this expression are pushed above those of any enclosing
+  //  expression, and are popped before returning.
+  auto& operands = expr_stack.operands;
+  auto& operators = expr_stack.operators;
+  const auto operand_begin = int64_t(operands.size());
+  const auto operator_begin = int64_t(operators.size());
 
-    if (tok.type == TokenType::identifier) {
-      node_res = identifier_reference_expr(tok);
-      if (node_res && iterator.peek().type == TokenType::at) {
-        //  method@superclass()
-        node_res = presumed_superclass_method_reference_expr(iterator.peek(), std::move(node_res.rvalue()));
-      }
-
-    } else if (is_ignore_argument_expr(tok)) {
-      node_res = ignore_argument_expr(tok);
-
-    } else if (represents_grouping_initiator(tok.type)) {
-      node_res = grouping_expr(tok);
-
-    } else if (represents_literal(tok.type)) {
-      node_res = literal_expr(tok);
-
-    } else if (tok.type == TokenType::op_end) {
-      iterator.advance();
-      node_res = Optional<BoxedExpr>(std::make_unique<EndOperatorExpr>(tok));
+  MT_SCOPE_EXIT {
+    operands.erase(operands.begin() + operand_begin, operands.end());
+    operators.erase(operators.begin() + operator_begin, operators.end());
+  };
 
-    } else if (is_unary_prefix_expr(tok)) {
-      unaries.emplace_back(pending_unary_prefix_expr(tok));
+  while (true) {
+    auto operand_res = unary_expr(false);
+    if (!operand_res) {
+      //  An error occurred in one of the sub-expressions.
+      return NullOpt{};
+    }
 
-    } else if (represents_binary_operator(tok.type)) {
-      if (is_colon_subscript_expr(tok)) {
-        node_res = colon_subscript_expr(tok);
+    if (!operand_res.value()) {
+      const bool is_empty = int64_t(operands.size()) == operand_begin;
+      if (is_empty && allow_empty) {
+        return Optional<BoxedExpr>(nullptr);
       } else {
-        //  @TODO: Tertiary colon operator is not parsed correctly. E.g., 1:2:3:4:5:6 should parse
-        //  as (((1:2:3):4:5):6)
-        auto bin_res = pending_binary_expr(tok, completed, binaries);
-        if (bin_res) {
-          add_error(bin_res.rvalue());
-          return NullOpt{};
-        }
+        add_error(make_error_incomplete_expr(parse_instance, iterator.peek()));
+        return NullOpt{};
       }
+    }
 
-    } else if (tok.type == TokenType::at) {
-      node_res = function_expr(tok);
+    operands.emplace_back(operand_res.rvalue());
 
-    } else if (represents_expr_terminator(tok.type)) {
+    const auto& tok = iterator.peek();
+    if (represents_expr_terminator(tok.type)) {
       break;
 
-    } else {
-      add_error(make_error_invalid_expr_token(parse_instance, tok));
+    } else if (!represents_binary_operator(tok.type)) {
+      //  e.g. `a ~b`
+      add_error(make_error_incomplete_expr(parse_instance, tok));
       return NullOpt{};
     }
 
-    if (!node_res) {
-      //  An error occurred in one of the sub-expressions.
-      return NullOpt{};
-    }
+    iterator.advance(); //  Consume operator token.
 
-    if (node_res.value()) {
-      completed.emplace_back(node_res.rvalue());
+    const auto op = binary_operator_from_token_type(tok.type);
+    const auto prec = precedence(op);
 
-      auto err = handle_postfix_unary_exprs(completed);
-      if (err) {
-        add_error(err.rvalue());
-        return NullOpt{};
+    //  The second colon of a range `a:b:c` does not reduce the first; the range is represented
+    //  as `a:(b:c)`, where `b:c` is not a grouping expression. A further colon begins a new
+    //  range, so `1:2:3:4:5:6` parses as (((1:2:3):4:5):6).
+    bool is_range_step = false;
+
+    if (op == BinaryOperator::colon) {
+      while (int64_t(operators.size()) > operator_begin && operators.back().precedence > prec) {
+        reduce_binary_expr();
       }
-    }
 
-    if (!completed.empty()) {
-      handle_prefix_unary_exprs(completed, unaries);
+      const bool has_pending_range = int64_t(operators.size()) > operator_begin &&
+        operators.back().op == BinaryOperator::colon;
+      is_range_step = has_pending_range && !operators.back().is_range_step;
     }
 
-    if (!completed.empty() && !binaries.empty()) {
-      handle_binary_exprs(completed, binaries, pending_binaries);
+    if (!is_range_step) {
+      //  Binary operators are otherwise left-associative, so pending operators of greater or
+      //  equal precedence are reduced first.
+      while (int64_t(operators.size()) > operator_begin && operators.back().precedence >= prec) {
+        reduce_binary_expr();
+      }
     }
-  }
-
-  if (completed.size() == 1) {
-    return Optional<BoxedExpr>(std::move(completed.back()));
 
-  } else {
-    const bool is_complete = completed.empty() && pending_binaries.empty() && binaries.empty() && unaries.empty();
-    const bool is_valid = is_complete && allow_empty;
+    operators.push_back(PendingBinaryOperator{tok, op, prec, is_range_step});
+  }
 
-    if (!is_valid) {
-      add_error(make_error_incomplete_expr(parse_instance, iterator.peek()));
-      return NullOpt{};
-    } else {
-      return Optional<BoxedExpr>(nullptr);
-    }
+  while (int64_t(operators.size()) > operator_begin) {
+    reduce_binary_expr();
   }
+
+  assert(int64_t(operands.size()) == operand_begin + 1);
+  return Optional<BoxedExpr>(std::move(operands.back()));
 }
 
 Optional<BoxedStmt> AstGenerator::control_stmt(const Token& source_token) {
@@ -2371,6 +2796,7 @@ Optional<SwitchCase> AstGenerator::switch_case(const mt::Token& source_token) {
     return NullOpt{};
   }
 
+  ClassifierContextHelper context_helper(eager_identifier_classifier());
   auto block_res = sub_block();
   if (!block_res) {
     return NullOpt{};
@@ -2385,6 +2811,8 @@ Optional<BoxedStmt> AstGenerator::switch_stmt(const mt::Token& source_token) {
 
   //  Register an increase in the switch statement scope depth.
   BlockStmtScopeHelper scope_helper(&block_depths.switch_stmt);
+  auto* classifier = eager_identifier_classifier();
+  ClassifierAssignmentContextHelper assignment_context_helper(classifier);
 
   auto condition_expr_res = expr();
   if (!condition_expr_res) {
@@ -2421,6 +2849,7 @@ Optional<BoxedStmt> AstGenerator::switch_stmt(const mt::Token& source_token) {
           return NullOpt{};
         }
 
+        ClassifierContextHelper context_helper(classifier);
         auto block_res = sub_block();
         if (!block_res) {
           return NullOpt{};
@@ -2437,6 +2866,10 @@ Optional<BoxedStmt> AstGenerator::switch_stmt(const mt::Token& source_token) {
     }
   }
 
+  if (classifier && !otherwise) {
+    classifier->register_new_context();
+  }
+
   auto err = consume(TokenType::keyword_end);
   if (err) {
     add_error(err.rvalue());
@@ -2460,7 +2893,13 @@ Optional<BoxedStmt> AstGenerator::while_stmt(const Token& source_token) {
     return NullOpt{};
   }
 
-  auto body_res = sub_block();
+  Optional<BoxedBlock> body_res;
+
+  {
+    ClassifierContextHelper context_helper(eager_identifier_classifier());
+    body_res = sub_block();
+  }
+
   if (!body_res) {
     return NullOpt{};
   }
@@ -2500,6 +2939,13 @@ Optional<BoxedStmt> AstGenerator::for_stmt(const Token& source_token) {
     return NullOpt{};
   }
 
+  MatlabIdentifier loop_variable_id = MatlabIdentifier(string_registry->register_string(loop_var_res.value()));
+
+  auto* classifier = eager_identifier_classifier();
+  if (classifier) {
+    classifier->register_loop_variable(source_token, loop_variable_id);
+  }
+
   auto initializer_res = expr();
   if (!initializer_res) {
     return NullOpt{};
@@ -2512,7 +2958,13 @@ Optional<BoxedStmt> AstGenerator::for_stmt(const Token& source_token) {
     }
   }
 
-  auto block_res = sub_block();
+  Optional<BoxedBlock> block_res;
+
+  {
+    ClassifierContextHelper context_helper(classifier);
+    block_res = sub_block();
+  }
+
   if (!block_res) {
     return NullOpt{};
   }
@@ -2523,8 +2975,6 @@ Optional<BoxedStmt> AstGenerator::for_stmt(const Token& source_token) {
     return NullOpt{};
   }
 
-  MatlabIdentifier loop_variable_id = MatlabIdentifier(string_registry->register_string(loop_var_res.value()));
-
   auto node = std::make_unique<ForStmt>(source_token, loop_variable_id,
     initializer_res.rvalue(), block_res.rvalue());
 
@@ -2534,6 +2984,8 @@ Optional<BoxedStmt> AstGenerator::for_stmt(const Token& source_token) {
 Optional<BoxedStmt> AstGenerator::if_stmt(const Token& source_token) {
   //  Register an increase in the if statement scope depth.
   BlockStmtScopeHelper scope_helper(&block_depths.if_stmt);
+  auto* classifier = eager_identifier_classifier();
+  ClassifierAssignmentContextHelper assignment_context_helper(classifier);
 
   auto main_branch_res = if_branch(source_token);
   if (!main_branch_res) {
@@ -2557,12 +3009,15 @@ Optional<BoxedStmt> AstGenerator::if_stmt(const Token& source_token) {
   if (maybe_else_token.type == TokenType::keyword_else) {
     iterator.advance();
 
+    ClassifierContextHelper context_helper(classifier);
     auto else_block_res = sub_block();
     if (!else_block_res) {
       return NullOpt{};
     } else {
       else_branch = ElseBranch(maybe_else_token, else_block_res.rvalue());
     }
+  } else if (classifier) {
+    classifier->register_new_context();
   }
 
   auto err = consume(TokenType::keyword_end);
@@ -2586,6 +3041,7 @@ Optional<IfBranch> AstGenerator::if_branch(const Token& source_token) {
     return NullOpt{};
   }
 
+  ClassifierContextHelper context_helper(eager_identifier_classifier());
   auto block_res = sub_block();
   if (!block_res) {
     return NullOpt{};
@@ -2609,6 +3065,12 @@ Optional<BoxedStmt> AstGenerator::assignment_stmt(BoxedExpr lhs, const Token& in
   }
 
   auto assign_stmt = std::make_unique<AssignmentStmt>(std::move(lhs), rhs_res.rvalue());
+
+  if (auto* classifier = eager_identifier_classifier()) {
+    //  The right-hand side has been classified as it was parsed.
+    classifier->lhs_expr(assign_stmt->to_expr);
+  }
+
   return Optional<BoxedStmt>(std::move(assign_stmt));
 }
 
@@ -2643,6 +3105,11 @@ Optional<BoxedStmt> AstGenerator::variable_declaration_stmt(const Token& source_
 
   const auto var_qualifier = variable_declaration_qualifier_from_token_type(source_token.type);
   auto node = std::make_unique<VariableDeclarationStmt>(source_token, var_qualifier, std::move(identifiers));
+
+  if (auto* classifier = eager_identifier_classifier()) {
+    classifier->variable_declaration_stmt(*node);
+  }
+
   return Optional<BoxedStmt>(std::move(node));
 }
 
@@ -2754,7 +3221,16 @@ Optional<BoxedStmt> AstGenerator::command_stmt(const Token& source_token) {
 }
 
 Optional<BoxedStmt> AstGenerator::expr_stmt(const Token& source_token) {
-  auto expr_res = expr();
+  //  The target of an assignment is classified only after its right-hand side, so classification
+  //  of a leading expression that precedes `=` is deferred.
+  auto* classifier = eager_identifier_classifier();
+  const bool defer_classification = classifier && is_assignment_stmt_ahead();
+  Optional<BoxedExpr> expr_res;
+
+  {
+    DeferredClassificationHelper defer_helper(&deferred_classification_depth, defer_classification);
+    expr_res = expr();
+  }
 
   if (!expr_res) {
     return NullOpt{};
@@ -2763,9 +3239,19 @@ Optional<BoxedStmt> AstGenerator::expr_stmt(const Token& source_token) {
   const auto& curr_token = iterator.peek();
 
   if (curr_token.type == TokenType::equal) {
+    if (classifier && !defer_classification) {
+      //  The leading expression was classified as a reference, but is an assignment target.
+      add_error(make_error_invalid_assignment_target(parse_instance, source_token));
+      return NullOpt{};
+    }
+
     return assignment_stmt(expr_res.rvalue(), source_token);
   }
 
+  if (defer_classification) {
+    classifier->rhs_expr(expr_res.value());
+  }
+
   auto expr_stmt = std::make_unique<ExprStmt>(expr_res.rvalue());
   return Optional<BoxedStmt>(std::move(expr_stmt));
 }
@@ -2775,8 +3261,16 @@ Optional<BoxedStmt> AstGenerator::try_stmt(const mt::Token& source_token) {
 
   //  Register an increase in the try statement scope depth.
   BlockStmtScopeHelper scope_helper(&block_depths.try_stmt);
+  auto* classifier = eager_identifier_classifier();
+  ClassifierAssignmentContextHelper assignment_context_helper(classifier);
+
+  Optional<BoxedBlock> try_block_res;
+
+  {
+    ClassifierContextHelper context_helper(classifier);
+    try_block_res = sub_block();
+  }
 
-  auto try_block_res = sub_block();
   if (!try_block_res) {
     return NullOpt{};
   }
@@ -2788,18 +3282,31 @@ Optional<BoxedStmt> AstGenerator::try_stmt(const mt::Token& source_token) {
     iterator.advance();
 
     const bool allow_empty = true;  //  @Note: Allow empty catch expression.
-    auto catch_expr_res = expr(allow_empty);
+    Optional<BoxedExpr> catch_expr_res;
+
+    {
+      //  The catch expression, if present, is classified as a variable assignment.
+      DeferredClassificationHelper defer_helper(&deferred_classification_depth, classifier != nullptr);
+      catch_expr_res = expr(allow_empty);
+    }
 
     if (!catch_expr_res) {
       return NullOpt{};
     }
 
+    if (classifier && catch_expr_res.value()) {
+      classifier->catch_block_expr(catch_expr_res.value());
+    }
+
+    ClassifierContextHelper context_helper(classifier);
     auto catch_block_res = sub_block();
     if (!catch_block_res) {
       return NullOpt{};
     }
 
     catch_block = CatchBlock(maybe_catch_token, catch_expr_res.rvalue(), catch_block_res.rvalue());
+  } else if (classifier) {
+    classifier->register_new_context();
   }
 
   auto end_err = consume(TokenType::keyword_end);
@@ -2950,6 +3457,13 @@ Optional<BoxedTypeAnnot> AstGenerator::type_assertion(const Token& source_token,
   BoxedAstNode enclosing_node;
 
   if (expect_enclosing_node) {
+    const auto& has_type = type_res.value();
+    next_function_def_annotation = has_type->is_function_type() ?
+      static_cast<const FunctionTypeNode*>(has_type.get()) : nullptr;
+    MT_SCOPE_EXIT {
+      next_function_def_annotation = nullptr;
+    };
+
     auto enclosing_res = stmt_or_function_def();
     if (!enclosing_res) {
       return NullOpt{};
@@ -2965,7 +3479,15 @@ Optional<BoxedTypeAnnot> AstGenerator::type_assertion(const Token& source_token,
 }
 
 Optional<BoxedTypeAnnot> AstGenerator::type_fun_enclosing_anonymous_function(const Token& source_token) {
-  auto stmt_res = stmt();
+  //  The statement is validated in terms of its unclassified identifiers.
+  auto* classifier = eager_identifier_classifier();
+  Optional<BoxedStmt> stmt_res;
+
+  {
+    DeferredClassificationHelper defer_helper(&deferred_classification_depth, true);
+    stmt_res = stmt();
+  }
+
   if (!stmt_res) {
     return NullOpt{};
   }
@@ -2993,6 +3515,11 @@ Optional<BoxedTypeAnnot> AstGenerator::type_fun_enclosing_anonymous_function(con
   }
 
   auto node = std::make_unique<FunTypeNode>(source_token, std::move(stmt_node));
+
+  if (classifier) {
+    classifier->fun_type_node(*node);
+  }
+
   return Optional<BoxedTypeAnnot>(std::move(node));
 }
 
@@ -3197,7 +3724,14 @@ Optional<BoxedTypeAnnot> AstGenerator::type_begin(const mt::Token& source_token)
   //  Mark whether the contained identifiers are exported.
   TypeIdentifierExportState::Helper export_state_helper(type_identifier_export_state, is_exported);
 
-  auto contents_res = type_annotation_block();
+  Optional<std::vector<BoxedTypeAnnot>> contents_res;
+
+  {
+    //  Nodes within type blocks are not subject to identifier classification.
+    DeferredClassificationHelper defer_helper(&deferred_classification_depth, true);
+    contents_res = type_annotation_block();
+  }
+
   if (!contents_res) {
     return NullOpt{};
   }
@@ -3246,7 +3780,14 @@ Optional<BoxedTypeAnnot> AstGenerator::type_namespace(const Token& source_token)
   TypeIdentifier namespace_identifier(string_registry->register_string(ident_res.value()));
   TypeIdentifierNamespaceState::Helper namespace_helper(namespace_state, namespace_identifier);
 
-  auto contents_res = type_annotation_block();
+  Optional<std::vector<BoxedTypeAnnot>> contents_res;
+
+  {
+    //  Nodes within type blocks are not subject to identifier classification.
+    DeferredClassificationHelper defer_helper(&deferred_classification_depth, true);
+    contents_res = type_annotation_block();
+  }
+
   if (!contents_res) {
     return NullOpt{};
   }
@@ -3584,7 +4125,14 @@ Optional<BoxedTypeAnnot> AstGenerator::constructor_type(const Token& source_toke
     return NullOpt{};
   }
 
-  auto stmt_res = expr_stmt(iterator.peek());
+  auto* classifier = eager_identifier_classifier();
+  Optional<BoxedStmt> stmt_res;
+
+  {
+    DeferredClassificationHelper defer_helper(&deferred_classification_depth, true);
+    stmt_res = expr_stmt(iterator.peek());
+  }
+
   if (!stmt_res) {
     return NullOpt{};
   } else if (!stmt_res.value()->is_assignment_stmt()) {
@@ -3615,6 +4163,11 @@ Optional<BoxedTypeAnnot> AstGenerator::constructor_type(const Token& source_toke
   }
 
   auto node = std::make_unique<ConstructorTypeNode>(source_token, std::move(stmt), expr_ptr);
+
+  if (classifier) {
+    classifier->constructor_type_node(*node);
+  }
+
   return Optional<BoxedTypeAnnot>(std::move(node));
 }
 
@@ -4029,6 +4582,37 @@ bool AstGenerator::has_enclosing_type_scheme() const {
   return !enclosing_schemes.empty() && enclosing_schemes.back();
 }
 
+bool AstGenerator::is_assignment_stmt_ahead() const {
+  //  Scan to the end of the statement for a top-level `=`, e.g. `[a, b] = deal(1, 2)`.
+  int64_t grouping_depth = 0;
+
+  for (int64_t i = 0; ; i++) {
+    const auto type = iterator.peek_nth(i).type;
+
+    if (type == TokenType::null) {
+      return false;
+
+    } else if (represents_grouping_initiator(type)) {
+      grouping_depth++;
+
+    } else if (represents_grouping_terminator(type)) {
+      if (--grouping_depth < 0) {
+        return false;
+      }
+    } else if (grouping_depth == 0) {
+      if (type == TokenType::equal) {
+        return true;
+      } else if (represents_stmt_terminator(type)) {
+        return false;
+      }
+    }
+  }
+}
+
+IdentifierClassifier* AstGenerator::eager_identifier_classifier() const {
+  return deferred_classification_depth == 0 ? identifier_classifier : nullptr;
+}
+
 bool AstGenerator::is_within_loop() const {
   return block_depths.for_stmt > 0 || block_depths.parfor_stmt > 0 || block_depths.while_stmt > 0;
 }
@@ -9,9 +9,11 @@
 #include "../traversal.hpp"
 #include "../source_data.hpp"
 #include "../fs/code_file.hpp"
+#include "../scan/scan.hpp"
 #include <vector>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace mt {
 
@@ -20,6 +22,7 @@ class CodeFileDescriptor;
 class TypeStore;
 class Library;
 class AstGenerator;
+class IdentifierClassifier;
 struct ParseInstance;
 
 namespace types {
@@ -74,6 +77,32 @@ struct PendingExternalMethod {
 
 using PendingExternalMethods = std::vector<PendingExternalMethod>;
 
+/*
+ * DeferredFunctionBody
+ *
+ * A function whose header was parsed, but whose body was skipped, to be parsed later on
+ * demand. The function definition's body is null until then.
+ */
+
+struct DeferredFunctionBody {
+  DeferredFunctionBody(FunctionDefNode* node, const FunctionTypeNode* signature,
+                       int64_t body_begin, MatlabScope* root_scope, TypeScope* root_type_scope) :
+  node(node), signature(signature), body_begin(body_begin),
+  root_scope(root_scope), root_type_scope(root_type_scope) {
+    //
+  }
+
+  FunctionDefNode* node;
+  //  The annotation of the function; its type is resolved along with the file's type identifiers.
+  const FunctionTypeNode* signature;
+  //  Index of the first token of the body.
+  int64_t body_begin;
+  MatlabScope* root_scope;
+  TypeScope* root_type_scope;
+};
+
+using DeferredFunctionBodies = std::vector<DeferredFunctionBody>;
+
 /*
  * ParseInstance
  */
@@ -117,6 +146,10 @@ struct ParseInstance {
   std::string parent_package;
   bool functions_are_end_terminated;
   bool treat_root_as_external_method;
+  //  Skip the bodies of top-level functions with a function type annotation, recording them in
+  //  `deferred_function_bodies`. Requires `function_terminators`.
+  bool defer_annotated_function_bodies;
+  const FunctionTerminators* function_terminators;
   OnBeforeParse on_before_parse;
 
   BoxedRootBlock root_block;
@@ -126,6 +159,7 @@ struct ParseInstance {
 
   PendingTypeImports pending_type_imports;
   PendingExternalMethods pending_external_methods;
+  DeferredFunctionBodies deferred_function_bodies;
 
   int64_t num_visited_functions;
   bool registered_file_type;
@@ -157,6 +191,22 @@ class AstGenerator {
     int methods = 0;
   };
 
+  struct PendingBinaryOperator {
+    Token source_token;
+    BinaryOperator op;
+    int precedence;
+    //  True for the second colon of a range `a:b:c`.
+    bool is_range_step;
+  };
+
+  //  Operands and operators of the expressions being parsed. Nested expressions (e.g., subscript
+  //  arguments) push onto and pop from the same stacks, above those of their enclosing expression.
+  struct ExprStack {
+    std::vector<BoxedExpr> operands;
+    std::vector<PendingBinaryOperator> operators;
+    std::vector<Token> prefix_operators;
+  };
+
 public:
   AstGenerator(ParseInstance* parse_instance, const std::vector<Token>& tokens);
   ~AstGenerator() = default;
@@ -164,10 +214,26 @@ public:
   void parse();
   void push_default_state();
 
+  //  Parse the body of a function previously skipped by `function_def`, and assign it to the
+  //  function's definition.
+  void parse_deferred_function_body(const DeferredFunctionBody& deferred);
+
+  //  Classify identifiers with `classifier` while generating the AST, instead of in a separate
+  //  pass over the complete tree.
+  void classify_identifiers_with(IdentifierClassifier* classifier);
+
 //private:
   Optional<std::unique_ptr<Block>> block();
   Optional<std::unique_ptr<Block>> sub_block();
   Optional<std::unique_ptr<FunctionDefNode>> function_def();
+  bool can_defer_function_body() const;
+  Optional<int64_t> skip_function_body(const Token& function_token);
+
+  Optional<std::unique_ptr<FunctionDefNode>>
+  held_function_def(const Token& source_token, std::vector<FunctionDefNode*>& held_functions);
+  bool find_held_function_classifications();
+  bool holds_function_classification(const Token& function_token) const;
+  void classify_held_functions(const std::vector<FunctionDefNode*>& held_functions);
   Optional<FunctionHeader> function_header(bool* has_varargin, bool* has_varargout);
   Optional<MatlabIdentifier> compound_function_name(std::string_view first_component);
   Optional<FunctionParameters> function_inputs(bool* has_varargin);
@@ -227,22 +293,17 @@ public:
   Optional<BoxedExpr> ignore_argument_expr(const Token& source_token);
   Optional<BoxedExpr> literal_expr(const Token& source_token);
   Optional<BoxedExpr> colon_subscript_expr(const Token& source_token);
-  std::unique_ptr<UnaryOperatorExpr> pending_unary_prefix_expr(const Token& source_token);
-  Optional<ParseError> pending_binary_expr(const Token& source_token,
-                                           std::vector<BoxedExpr>& completed,
-                                           std::vector<BoxedBinaryOperatorExpr>& binaries);
-  Optional<ParseError> postfix_unary_expr(const Token& source_token, std::vector<BoxedExpr>& completed);
-  Optional<ParseError> handle_postfix_unary_exprs(std::vector<BoxedExpr>& completed);
-  void handle_prefix_unary_exprs(std::vector<BoxedExpr>& completed, std::vector<BoxedUnaryOperatorExpr>& unaries);
-  void handle_binary_exprs(std::vector<BoxedExpr>& completed,
-                           std::vector<BoxedBinaryOperatorExpr>& binaries,
-                           std::vector<BoxedBinaryOperatorExpr>& pending_binaries);
+  Optional<BoxedExpr> unary_expr(bool is_exponent);
+  Optional<BoxedExpr> primary_expr(const Token& source_token);
+  void postfix_unary_exprs(BoxedExpr& operand);
+  void reduce_binary_expr();
 
   bool is_unary_prefix_expr(const Token& curr_token) const;
   bool is_ignore_argument_expr(const Token& curr_token) const;
   bool is_colon_subscript_expr(const Token& curr_token) const;
 
   bool is_command_stmt(const Token& curr_token) const;
+  bool is_assignment_stmt_ahead() const;
 
   Optional<BoxedStmt> assignment_stmt(BoxedExpr lhs, const Token& initial_token);
   Optional<BoxedStmt> expr_stmt(const Token& source_token);
@@ -321,6 +382,8 @@ public:
 
   bool has_enclosing_type_scheme() const;
 
+  IdentifierClassifier* eager_identifier_classifier() const;
+
   void push_scope();
   void pop_scope();
   void push_scope(MatlabScope* current_scope, TypeScope* current_type_scope);
@@ -360,6 +423,20 @@ public:
   std::vector<TypeScope*> type_scopes;
   std::vector<FunctionAttributes> function_attributes;
   std::vector<types::Scheme*> enclosing_schemes;
+  ExprStack expr_stack;
+
+  //  Function type annotation enclosing the function definition about to be parsed, if any.
+  const FunctionTypeNode* next_function_def_annotation;
+
+  //  Classification is deferred within nodes that must be inspected in their unclassified form,
+  //  e.g. the target of an assignment, which is not known to be one until the `=` is reached.
+  IdentifierClassifier* identifier_classifier;
+  int deferred_classification_depth;
+
+  //  The separate pass classifies a block's functions after its other nodes, so a function that
+  //  is followed by a statement (or that contains an import) is classified at the end of its
+  //  block, rather than as it is parsed. Keyed by the offset of the `function` keyword.
+  std::unordered_set<int64_t> held_function_classifications;
 };
 
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "identifier_classification.hpp"
 #include "../string.hpp"
+#include <algorithm>
 #include <cassert>
 
 namespace mt {
@@ -257,6 +258,7 @@ IdentifierScope::IdentifierInfo
 IdentifierScope::make_external_function_reference_identifier_info(Store::Write& writer,
                                                                   const MatlabIdentifier& id) {
   auto ref = writer.make_external_reference(id, matlab_scope);
+  classifier->register_external_function_reference(ref);
   IdentifierInfo info(id, IdentifierType::unresolved_external_function, current_context(), ref);
   return info;
 }
@@ -322,7 +324,9 @@ IdentifierClassifier::IdentifierClassifier(StringRegistry* string_registry,
   store(store),
   file_descriptor(source_data.file_descriptor),
   text(source_data.source),
-  scope_depth(-1) {
+  scope_depth(-1),
+  defers_local_function_resolution(false),
+  num_first_assignments(0) {
   //  Begin on rhs.
   expr_sides.push_rhs();
   //  Begin in non-superclass method application, etc.
@@ -379,37 +383,136 @@ IdentifierScope::AssignmentResult
 IdentifierClassifier::register_variable_assignment(const Token& source_token, const MatlabIdentifier& primary_identifier) {
   Store::Write read_write(*store);
 
-  auto primary_result = current_scope()->register_variable_assignment(read_write, primary_identifier);
+  auto* scope = current_scope();
+  const bool is_first_assignment = !scope->lookup_variable(primary_identifier, false);
+
+  auto primary_result = scope->register_variable_assignment(read_write, primary_identifier);
   if (!primary_result.success) {
     const auto err_type = primary_result.error_already_had_type;
-    auto err = make_error_assignment_to_non_variable(source_token, primary_identifier, err_type);
-    add_error_if_new_identifier(std::move(err), primary_identifier);
+    add_assignment_error(scope, source_token, primary_identifier, err_type);
 
-  } else if (primary_result.was_initialization) {
-    auto parse_scope = current_scope()->matlab_scope;
-    parse_scope->register_local_variable(primary_identifier, primary_result.variable_def_handle);
+  } else {
+    if (is_first_assignment) {
+      register_first_assignment(scope, source_token, primary_identifier);
+    }
+    if (primary_result.was_initialization) {
+      auto parse_scope = scope->matlab_scope;
+      parse_scope->register_local_variable(primary_identifier, primary_result.variable_def_handle);
+    }
   }
 
   return primary_result;
 }
 
+void IdentifierClassifier::register_first_assignment(IdentifierScope* scope,
+                                                     const Token& source_token,
+                                                     const MatlabIdentifier& identifier) {
+  if (defers_local_function_resolution) {
+    const auto error_index = int64_t(errors.size());
+    IdentifierScope::FirstAssignment assignment{source_token, error_index, num_first_assignments++};
+    scope->first_assignments.emplace(identifier, assignment);
+  }
+}
+
+void IdentifierClassifier::add_assignment_error(IdentifierScope* scope,
+                                                const Token& source_token,
+                                                const MatlabIdentifier& identifier,
+                                                IdentifierType present_type) {
+  const auto error_index = int64_t(errors.size());
+  auto err = make_error_assignment_to_non_variable(source_token, identifier, present_type);
+  add_error_if_new_identifier(std::move(err), identifier);
+
+  if (defers_local_function_resolution &&
+      int64_t(errors.size()) > error_index &&
+      present_type == IdentifierType::unresolved_external_function &&
+      !identifier.is_compound()) {
+    //  The identifier might be defined as a local function later in the file.
+    ForwardReferenceError forward_err{error_index, source_token, identifier, scope->matlab_scope};
+    forward_reference_errors.push_back(forward_err);
+  }
+}
+
+void IdentifierClassifier::resolve_forward_reference_errors() {
+  for (const auto& forward_err : forward_reference_errors) {
+    if (forward_err.scope->lookup_local_function(forward_err.identifier).is_valid()) {
+      errors[forward_err.index] = make_error_assignment_to_non_variable(
+        forward_err.source_token, forward_err.identifier, IdentifierType::local_function);
+    }
+  }
+
+  forward_reference_errors.clear();
+
+  if (inserted_errors.empty()) {
+    return;
+  }
+
+  std::sort(inserted_errors.begin(), inserted_errors.end(), [](const auto& a, const auto& b) {
+    return a.index < b.index || (a.index == b.index && a.order < b.order);
+  });
+
+  ParseErrors merged;
+  auto inserted_it = inserted_errors.begin();
+
+  for (int64_t i = 0; i <= int64_t(errors.size()); i++) {
+    while (inserted_it != inserted_errors.end() && inserted_it->index == i) {
+      merged.push_back(std::move(inserted_it->error));
+      ++inserted_it;
+    }
+    if (i < int64_t(errors.size())) {
+      merged.push_back(std::move(errors[i]));
+    }
+  }
+
+  errors = std::move(merged);
+  inserted_errors.clear();
+}
+
 void IdentifierClassifier::register_imports(IdentifierScope* scope) {
   for (const auto& import : scope->matlab_scope->fully_qualified_imports) {
-    Store::Write read_write(*store);
-    //  Fully qualified imports take precedence over variables, but cannot shadow local functions.
-    auto complete_identifier_id = string_registry->make_registered_compound_identifier(import.identifier_components);
+    register_import(scope, import);
+  }
+}
 
-    MatlabIdentifier complete_identifier(complete_identifier_id, import.identifier_components.size());
-    MatlabIdentifier import_alias(import.identifier_components.back());
+void IdentifierClassifier::register_import(IdentifierScope* scope, const Import& import) {
+  Store::Write read_write(*store);
+  //  Fully qualified imports take precedence over variables, but cannot shadow local functions.
+  auto complete_identifier_id = string_registry->make_registered_compound_identifier(import.identifier_components);
 
-    auto res = scope->register_fully_qualified_import(read_write, complete_identifier, import_alias);
+  MatlabIdentifier complete_identifier(complete_identifier_id, import.identifier_components.size());
+  MatlabIdentifier import_alias(import.identifier_components.back());
 
-    if (res.success && res.info.type == IdentifierType::unresolved_external_function) {
-      scope->matlab_scope->register_imported_function(complete_identifier, res.info.function_reference);
-    } else {
-      add_error(make_error_shadowed_import(import.source_token, res.info.type));
+  auto res = scope->register_fully_qualified_import(read_write, complete_identifier, import_alias);
+
+  if (res.success && res.info.type == IdentifierType::unresolved_external_function) {
+    scope->matlab_scope->register_imported_function(complete_identifier, res.info.function_reference);
+  } else {
+    add_error(make_error_shadowed_import(import.source_token, res.info.type));
+  }
+}
+
+void IdentifierClassifier::register_external_function_reference(const FunctionReferenceHandle& ref_handle) {
+  if (defers_local_function_resolution) {
+    external_function_references.push_back(ref_handle);
+  }
+}
+
+void IdentifierClassifier::resolve_external_function_references() {
+  Store::Write writer(*store);
+
+  for (const auto& ref_handle : external_function_references) {
+    const auto& ref = writer.at(ref_handle);
+    if (!ref.scope) {
+      continue;
+    }
+
+    //  The function was referenced before a local function of the same name was defined.
+    const auto local_ref_handle = ref.scope->lookup_local_function(ref.name);
+    if (local_ref_handle.is_valid()) {
+      writer.bind_local_reference(ref_handle, writer.at(local_ref_handle).def_handle);
     }
   }
+
+  external_function_references.clear();
 }
 
 void IdentifierClassifier::register_local_functions(IdentifierScope* scope) {
@@ -441,17 +544,31 @@ void IdentifierClassifier::register_function_parameters(Store::Write& read_write
 void IdentifierClassifier::register_function_parameter(Store::Write& read_write,
                                                        const Token& source_token,
                                                        const MatlabIdentifier& id) {
+  auto* scope = current_scope();
+  const auto& local_variables = scope->matlab_scope->local_variables;
+  const auto registered_it = local_variables.find(id);
+
+  if (registered_it != local_variables.end() && !scope->has_variable(id, false)) {
+    //  The parameter was registered with the header of a function whose body was deferred.
+    const auto type = IdentifierType::variable_assignment_or_initialization;
+    IdentifierScope::IdentifierInfo info(id, type, scope->current_context(), registered_it->second);
+    scope->classified_identifiers[id] = info;
+    return;
+  }
+
   //  Input and output parameters always introduce new local variables.
   const bool force_shadow_parent_assignment = true;
   auto assign_res =
-    current_scope()->register_variable_assignment(read_write, id, force_shadow_parent_assignment);
+    scope->register_variable_assignment(read_write, id, force_shadow_parent_assignment);
 
   if (!assign_res.success) {
-    auto err = make_error_assignment_to_non_variable(source_token, id, assign_res.error_already_had_type);
-    add_error_if_new_identifier(std::move(err), id);
+    add_assignment_error(scope, source_token, id, assign_res.error_already_had_type);
 
-  } else if (assign_res.was_initialization) {
-    current_scope()->matlab_scope->register_local_variable(id, assign_res.variable_def_handle);
+  } else {
+    register_first_assignment(scope, source_token, id);
+    if (assign_res.was_initialization) {
+      scope->matlab_scope->register_local_variable(id, assign_res.variable_def_handle);
+    }
   }
 }
 
@@ -711,12 +828,19 @@ IfStmt* IdentifierClassifier::if_stmt(IfStmt& stmt) {
 }
 
 AssignmentStmt* IdentifierClassifier::assignment_stmt(AssignmentStmt& stmt) {
-  conditional_reset(stmt.of_expr, stmt.of_expr->accept(*this));
+  rhs_expr(stmt.of_expr);
+  lhs_expr(stmt.to_expr);
+  return &stmt;
+}
+
+void IdentifierClassifier::rhs_expr(BoxedExpr& expr) {
+  conditional_reset(expr, expr->accept(*this));
+}
+
+void IdentifierClassifier::lhs_expr(BoxedExpr& expr) {
   expr_sides.push_lhs();
-  conditional_reset(stmt.to_expr, stmt.to_expr->accept(*this));
+  conditional_reset(expr, expr->accept(*this));
   expr_sides.pop_side();
-
-  return &stmt;
 }
 
 ExprStmt* IdentifierClassifier::expr_stmt(ExprStmt& stmt) {
@@ -769,6 +893,16 @@ Expr* IdentifierClassifier::catch_expr(IdentifierReferenceExpr& expr) {
   }
 }
 
+void IdentifierClassifier::catch_block_expr(BoxedExpr& expr) {
+  auto maybe_identifier_reference_expr = expr->extract_mut_identifier_reference_expr();
+
+  if (maybe_identifier_reference_expr) {
+    conditional_reset(expr, catch_expr(*maybe_identifier_reference_expr.value()));
+  } else {
+    conditional_reset(expr, expr->accept(*this));
+  }
+}
+
 TryStmt* IdentifierClassifier::try_stmt(TryStmt& stmt) {
   current_scope()->push_variable_assignment_context();
   block_new_context(stmt.try_block);
@@ -777,16 +911,7 @@ TryStmt* IdentifierClassifier::try_stmt(TryStmt& stmt) {
     auto& catch_block = stmt.catch_block.value();
 
     if (catch_block.expr) {
-      auto maybe_identifier_reference_expr =
-        catch_block.expr->extract_mut_identifier_reference_expr();
-
-      if (maybe_identifier_reference_expr) {
-        conditional_reset(catch_block.expr,
-          catch_expr(*maybe_identifier_reference_expr.value()));
-
-      } else {
-        conditional_reset(catch_block.expr, catch_block.expr->accept(*this));
-      }
+      catch_block_expr(catch_block.expr);
     }
 
     block_new_context(catch_block.block);
@@ -830,6 +955,12 @@ FunctionDefNode* IdentifierClassifier::function_def_node(FunctionDefNode& def_no
     function_body = std::move(def.body);
   }
 
+  if (!function_body) {
+    //  The body was deferred (see AstGenerator::function_def), and is classified once parsed.
+    pop_scope();
+    return &def_node;
+  }
+
   //  Enter function definition.
   FunctionDefState::Helper function_helper(function_state, def_node.def_handle);
   block_new_context(function_body);
@@ -916,6 +1047,105 @@ RootBlock* IdentifierClassifier::root_block(RootBlock& block) {
   return &block;
 }
 
+void IdentifierClassifier::transform_deferred_function_def(MatlabScope* root_scope,
+                                                           FunctionDefNode& def) {
+  push_scope(root_scope);
+
+  register_local_functions(current_scope());
+  register_imports(current_scope());
+
+  function_def_node(def);
+  pop_scope();
+}
+
+void IdentifierClassifier::enter_root(MatlabScope* parse_scope) {
+  //  Local functions are registered as they are defined, so references to functions defined
+  //  later in the file must be resolved once the file has been parsed.
+  defers_local_function_resolution = true;
+
+  push_scope(parse_scope);
+  register_local_functions(current_scope());
+  register_imports(current_scope());
+}
+
+void IdentifierClassifier::exit_root() {
+  pop_scope();
+  resolve_external_function_references();
+  resolve_forward_reference_errors();
+}
+
+void IdentifierClassifier::enter_function(MatlabScope* parse_scope, const FunctionHeader& header) {
+  push_scope(parse_scope);
+
+  {
+    Store::Write read_write(*store);
+    register_function_parameters(read_write, *header.name_token, header.inputs);
+    register_function_parameters(read_write, *header.name_token, header.outputs);
+  }
+
+  push_context();
+}
+
+void IdentifierClassifier::exit_function() {
+  pop_context();
+  pop_scope();
+}
+
+void IdentifierClassifier::enter_anonymous_function(MatlabScope* parse_scope,
+                                                    const Token& source_token,
+                                                    const std::vector<FunctionParameter>& inputs) {
+  push_scope(parse_scope);
+
+  Store::Write writer(*store);
+  register_function_parameters(writer, source_token, inputs);
+}
+
+void IdentifierClassifier::exit_anonymous_function() {
+  pop_scope();
+}
+
+void IdentifierClassifier::push_variable_assignment_context() {
+  current_scope()->push_variable_assignment_context();
+}
+
+void IdentifierClassifier::pop_variable_assignment_context() {
+  current_scope()->pop_variable_assignment_context();
+}
+
+void IdentifierClassifier::register_local_function(const Token& source_token,
+                                                   const FunctionReferenceHandle& ref_handle) {
+  Store::Write read_write(*store);
+  auto* scope = current_scope();
+  const auto name = read_write.at(ref_handle).name;
+  const auto* info = scope->lookup_variable(name, false);
+
+  if (info && is_variable(info->type)) {
+    //  The function is defined after its name was used as a variable. The separate pass
+    //  registers the function first, and so reports the variable's first assignment instead.
+    const auto first_it = scope->first_assignments.find(name);
+
+    if (first_it == scope->first_assignments.end()) {
+      auto err = make_error_function_reference_to_non_function(source_token, name, info->type);
+      add_error_if_new_identifier(std::move(err), name);
+
+    } else if (!added_error_for_identifier(name)) {
+      const auto& first = first_it->second;
+      const auto type = IdentifierType::local_function;
+      auto err = make_error_assignment_to_non_variable(first.source_token, name, type);
+      inserted_errors.push_back(InsertedError{first.error_index, first.order, std::move(err)});
+      mark_error_identifier(name);
+    }
+  } else {
+    //  Local functions take precedence over earlier (external) references.
+    scope->classified_identifiers[name] =
+      scope->make_local_function_reference_identifier_info(read_write, name, ref_handle);
+  }
+}
+
+void IdentifierClassifier::register_loop_variable(const Token& source_token, const MatlabIdentifier& identifier) {
+  register_variable_assignment(source_token, identifier);
+}
+
 Block* IdentifierClassifier::block(Block& block) {
   for (auto& node : block.nodes) {
     conditional_reset(node, node->accept(*this));
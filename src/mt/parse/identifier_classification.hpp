@@ -94,6 +94,15 @@ class IdentifierScope {
     };
   };
 
+  /*
+   * FirstAssignment
+   */
+  struct FirstAssignment {
+    Token source_token;
+    int64_t error_index;
+    int64_t order;
+  };
+
   /*
    * AssignmentResult
    */
@@ -196,6 +205,10 @@ private:
   std::unordered_map<MatlabIdentifier, IdentifierInfo, MatlabIdentifier::Hash> classified_identifiers;
 
   std::vector<VariableAssignmentContext> variable_assignment_contexts;
+
+  //  In single-pass classification, where each variable was first assigned in this scope, in case
+  //  a local function of the same name is defined later.
+  std::unordered_map<MatlabIdentifier, FirstAssignment, MatlabIdentifier::Hash> first_assignments;
 };
 
 /*
@@ -212,6 +225,33 @@ public:
   ~IdentifierClassifier() = default;
 
   void transform_root(BoxedRootBlock& block);
+  //  Classify the body of a top-level function parsed after the rest of its file (see
+  //  `AstGenerator::parse_deferred_function_body`).
+  void transform_deferred_function_def(MatlabScope* root_scope, FunctionDefNode& def);
+
+  //  Single-pass classification. Rather than transforming a complete tree with
+  //  `transform_root`, the classifier can be driven by the AstGenerator as it parses; see
+  //  `AstGenerator::classify_identifiers_with`.
+  void enter_root(MatlabScope* parse_scope);
+  void exit_root();
+  void enter_function(MatlabScope* parse_scope, const FunctionHeader& header);
+  void exit_function();
+  void enter_anonymous_function(MatlabScope* parse_scope, const Token& source_token,
+                                const std::vector<FunctionParameter>& inputs);
+  void exit_anonymous_function();
+
+  void push_context();
+  void pop_context();
+  void register_new_context();
+  void push_variable_assignment_context();
+  void pop_variable_assignment_context();
+
+  void register_local_function(const Token& source_token, const FunctionReferenceHandle& ref_handle);
+  void register_loop_variable(const Token& source_token, const MatlabIdentifier& identifier);
+
+  void rhs_expr(BoxedExpr& expr);
+  void lhs_expr(BoxedExpr& expr);
+  void catch_block_expr(BoxedExpr& expr);
 
   RootBlock* root_block(RootBlock& block);
   Block* block(Block& block);
@@ -270,10 +310,6 @@ private:
   void push_scope(MatlabScope* parse_scope);
   void pop_scope();
 
-  void push_context();
-  void pop_context();
-  void register_new_context();
-
   IdentifierScope* scope_at(int index);
   const IdentifierScope* scope_at(int index) const;
   IdentifierScope* current_scope();
@@ -286,6 +322,14 @@ private:
   IdentifierScope::AssignmentResult register_variable_assignment(const Token& source_token,
                                                                  const MatlabIdentifier& primary_identifier);
   void register_imports(IdentifierScope* in_scope);
+  void register_import(IdentifierScope* in_scope, const Import& import);
+  void register_external_function_reference(const FunctionReferenceHandle& ref_handle);
+  void resolve_external_function_references();
+  void register_first_assignment(IdentifierScope* scope, const Token& source_token,
+                                 const MatlabIdentifier& identifier);
+  void add_assignment_error(IdentifierScope* scope, const Token& source_token,
+                            const MatlabIdentifier& identifier, IdentifierType present_type);
+  void resolve_forward_reference_errors();
   void register_local_functions(IdentifierScope* in_scope);
 
   Expr* identifier_reference_expr_lhs(IdentifierReferenceExpr& expr);
@@ -334,6 +378,30 @@ private:
 
   ParseErrors errors;
   ParseErrors warnings;
+
+  //  In single-pass classification, a function can be referenced before it is defined, and so
+  //  external references are revisited once all of the local functions in the file are known.
+  bool defers_local_function_resolution;
+  std::vector<FunctionReferenceHandle> external_function_references;
+
+  //  Errors that depend on whether a name is (later) defined as a local function. They are
+  //  reported as the separate pass would, which registers a scope's local functions first.
+  struct ForwardReferenceError {
+    int64_t index;
+    Token source_token;
+    MatlabIdentifier identifier;
+    const MatlabScope* scope;
+  };
+
+  struct InsertedError {
+    int64_t index;
+    int64_t order;
+    ParseError error;
+  };
+
+  std::vector<ForwardReferenceError> forward_reference_errors;
+  std::vector<InsertedError> inserted_errors;
+  int64_t num_first_assignments;
 };
 
 template <typename T>
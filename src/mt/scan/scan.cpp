@@ -13,6 +13,7 @@ void swap(ScanInfo& lhs, ScanInfo& rhs) {
   swap(lhs.tokens, rhs.tokens);
   swap(lhs.functions_are_end_terminated, rhs.functions_are_end_terminated);
   swap(lhs.row_column_indices, rhs.row_column_indices);
+  swap(lhs.function_terminators, rhs.function_terminators);
 }
 
 bool EndTerminatedKeywordCounts::parent_is_classdef() const {
@@ -56,6 +57,7 @@ Optional<ScanError> EndTerminatedKeywordCounts::register_keyword(TokenType keywo
     const int64_t count = it == keyword_counts.end() ? 0 : it->second;
     keyword_counts[keyword_type] = count + 1;
     keyword_types.push_back(keyword_type);
+    keyword_starts.push_back(start);
     return NullOpt{};
 
   } else {
@@ -72,9 +74,15 @@ Optional<ScanError> EndTerminatedKeywordCounts::pop_keyword(const CharacterItera
   }
 
   const auto last_type = keyword_types.back();
+  const auto last_start = keyword_starts.back();
   keyword_types.pop_back();
+  keyword_starts.pop_back();
   keyword_counts[last_type] = keyword_counts[last_type] - 1;
 
+  if (last_type == TokenType::keyword_function) {
+    function_terminators[last_start] = start;
+  }
+
   return NullOpt{};
 }
 
@@ -107,6 +115,7 @@ ScanInfo Scanner::finalize_scan(std::vector<Token>& tokens) const {
   new_line_inds.scan(source_text.data(), source_text.size());
   ScanInfo info(std::move(tokens), std::move(new_line_inds));
   info.functions_are_end_terminated = !keyword_counts.is_non_end_terminated_function_file();
+  info.function_terminators = keyword_counts.function_terminators;
 
   return info;
 }
@@ -25,6 +25,15 @@ struct ScanError {
   static constexpr int context_amount = 30;
 };
 
+/*
+ * FunctionTerminators
+ *
+ * Maps the source offset of an end-terminated `function` keyword to the source offset of the
+ * `end` keyword that terminates it.
+ */
+
+using FunctionTerminators = std::unordered_map<int64_t, int64_t>;
+
 struct EndTerminatedKeywordCounts {
   EndTerminatedKeywordCounts() = default;
   ~EndTerminatedKeywordCounts() = default;
@@ -39,7 +48,9 @@ struct EndTerminatedKeywordCounts {
   Optional<ScanError> pop_keyword(const CharacterIterator& iterator, int64_t start);
 
   std::vector<TokenType> keyword_types;
+  std::vector<int64_t> keyword_starts;
   std::unordered_map<TokenType, int64_t> keyword_counts;
+  FunctionTerminators function_terminators;
 };
 
 using ScanErrors = std::vector<ScanError>;
@@ -61,6 +72,7 @@ struct ScanInfo {
   std::vector<Token> tokens;
   bool functions_are_end_terminated;
   TextRowColumnIndices row_column_indices;
+  FunctionTerminators function_terminators;
 };
 
 //  swap for ScanInfo
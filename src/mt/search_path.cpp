@@ -200,11 +200,25 @@ namespace {
 }
 
 SearchPath::CandidateMap& SearchPath::require_private_candidate_map(const FilePath& parent) {
-  auto it = private_candidates.find(parent);
-  if (it == private_candidates.end()) {
-    private_candidates[parent] = {};
+  auto it = private_directory_ids.find(parent);
+  if (it == private_directory_ids.end()) {
+    it = private_directory_ids.emplace(parent, int64_t(private_candidates.size())).first;
+    private_candidates.emplace_back();
+  }
+  return private_candidates[it->second];
+}
+
+int64_t SearchPath::directory_id(const FilePath& directory) const {
+  auto it = private_directory_ids.find(directory);
+  return it == private_directory_ids.end() ? no_private_directory : it->second;
+}
+
+int64_t SearchPath::containing_directory_id(const CodeFileDescriptor& file_descriptor) const {
+  if (file_descriptor.represents_known_file()) {
+    return directory_id(fs::directory_name(file_descriptor.file_path));
+  } else {
+    return no_private_directory;
   }
-  return private_candidates.at(parent);
 }
 
 Optional<const SearchCandidate*> SearchPath::search_for(const std::string& name) const {
@@ -212,12 +226,12 @@ Optional<const SearchCandidate*> SearchPath::search_for(const std::string& name)
 }
 
 Optional<const SearchCandidate*> SearchPath::search_for(const std::string& name,
-                                                        const FilePath& from_directory) const {
-  auto maybe_private_it = private_candidates.find(from_directory);
-  if (maybe_private_it != private_candidates.end()) {
+                                                        int64_t from_directory_id) const {
+  if (from_directory_id != no_private_directory) {
     //  The directory containing this `name` has a private directory, so see if `name` is a private
     //  function.
-    auto maybe_private_file = SearchPath::search_for(maybe_private_it->second, name);
+    assert(from_directory_id >= 0 && from_directory_id < int64_t(private_candidates.size()));
+    auto maybe_private_file = SearchPath::search_for(private_candidates[from_directory_id], name);
     if (maybe_private_file) {
       return maybe_private_file;
     }
@@ -226,14 +240,14 @@ Optional<const SearchCandidate*> SearchPath::search_for(const std::string& name,
   return search_for(name);
 }
 
+Optional<const SearchCandidate*> SearchPath::search_for(const std::string& name,
+                                                        const FilePath& from_directory) const {
+  return search_for(name, directory_id(from_directory));
+}
+
 Optional<const SearchCandidate*> SearchPath::search_for(const std::string& name,
                                                         const CodeFileDescriptor& file_descriptor) const {
-  if (file_descriptor.represents_known_file()) {
-    const auto containing_dir = fs::directory_name(file_descriptor.file_path);
-    return search_for(name, containing_dir);
-  } else {
-    return search_for(name);
-  }
+  return search_for(name, containing_directory_id(file_descriptor));
 }
 
 Optional<const SearchCandidate*> SearchPath::search_for(const SearchPath::CandidateMap& map, const std::string& key) {
@@ -31,6 +31,10 @@ class SearchPath {
 public:
   using CandidateMap = std::unordered_map<std::string, SearchCandidate>;
 
+  //  Directories containing a private directory are interned when the search path is built. Any
+  //  other directory has id `no_private_directory`, and so searches only the public candidates.
+  static constexpr int64_t no_private_directory = -1;
+
   SearchPath() = default;
   SearchPath(SearchPath&& other) MSVC_MISSING_NOEXCEPT = default;
   SearchPath& operator=(SearchPath&& other) MSVC_MISSING_NOEXCEPT = default;
@@ -40,6 +44,11 @@ public:
                                               const FilePath& from_directory) const;
   Optional<const SearchCandidate*> search_for(const std::string& name,
                                               const CodeFileDescriptor& file_descriptor) const;
+  Optional<const SearchCandidate*> search_for(const std::string& name,
+                                              int64_t from_directory_id) const;
+
+  int64_t directory_id(const FilePath& directory) const;
+  int64_t containing_directory_id(const CodeFileDescriptor& file_descriptor) const;
 
   int64_t size() const;
 
@@ -49,7 +58,8 @@ private:
 
 private:
   CandidateMap candidate_files;
-  std::unordered_map<FilePath, CandidateMap, FilePath::Hash> private_candidates;
+  std::unordered_map<FilePath, int64_t, FilePath::Hash> private_directory_ids;
+  std::vector<CandidateMap> private_candidates;
 };
 
 Optional<SearchPath> build_search_path_from_path_file(const FilePath& file);
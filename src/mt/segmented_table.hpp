@@ -0,0 +1,196 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace mt {
+
+namespace detail {
+  /*
+   * Segments
+   *
+   * Fixed-size blocks of uninitialized storage for `T`, allocated on first use. Segments are
+   * published with a compare-and-swap, so they can be required concurrently.
+   */
+
+  template <typename T>
+  class Segments {
+  public:
+    static constexpr int64_t segment_size_log2 = 10;
+    static constexpr int64_t segment_size = int64_t(1) << segment_size_log2;
+    static constexpr int64_t max_num_segments = int64_t(1) << 14;
+
+  public:
+    Segments();
+    ~Segments();
+
+    Segments(const Segments& other) = delete;
+    Segments& operator=(const Segments& other) = delete;
+
+    T* require(int64_t index);
+    T* element(int64_t index) const;
+
+  private:
+    std::unique_ptr<std::atomic<T*>[]> segments;
+  };
+
+  template <typename T>
+  Segments<T>::Segments() : segments(new std::atomic<T*>[max_num_segments]) {
+    for (int64_t i = 0; i < max_num_segments; i++) {
+      segments[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  template <typename T>
+  Segments<T>::~Segments() {
+    std::allocator<T> allocator;
+    for (int64_t i = 0; i < max_num_segments; i++) {
+      if (auto* segment = segments[i].load(std::memory_order_relaxed)) {
+        allocator.deallocate(segment, segment_size);
+      }
+    }
+  }
+
+  template <typename T>
+  T* Segments<T>::require(int64_t index) {
+    const auto segment_index = index >> segment_size_log2;
+    if (segment_index >= max_num_segments) {
+      //  Checked in every build, since appending past the last segment would write out of bounds.
+      std::fprintf(stderr, "Table is full.\n");
+      std::abort();
+    }
+
+    auto* segment = segments[segment_index].load(std::memory_order_acquire);
+    if (!segment) {
+      //  Another thread may allocate the same segment concurrently; the first to publish it wins.
+      std::allocator<T> allocator;
+      auto* allocated = allocator.allocate(segment_size);
+      if (segments[segment_index].compare_exchange_strong(segment, allocated,
+                                                          std::memory_order_acq_rel,
+                                                          std::memory_order_acquire)) {
+        segment = allocated;
+      } else {
+        allocator.deallocate(allocated, segment_size);
+      }
+    }
+
+    return segment + (index & (segment_size - 1));
+  }
+
+  template <typename T>
+  T* Segments<T>::element(int64_t index) const {
+    auto* segment = segments[index >> segment_size_log2].load(std::memory_order_acquire);
+    assert(segment);
+    return segment + (index & (segment_size - 1));
+  }
+}
+
+/*
+ * SegmentedTable
+ *
+ * Append-only table whose elements are stored in fixed-size segments, such that an element never
+ * moves once constructed. Indices are allocated atomically, so that threads appending to the same
+ * table do not contend on a lock; and an element can be read without synchronization once its
+ * index has been published to the reading thread.
+ */
+
+template <typename T>
+class SegmentedTable {
+public:
+  SegmentedTable();
+  ~SegmentedTable();
+
+  SegmentedTable(const SegmentedTable& other) = delete;
+  SegmentedTable& operator=(const SegmentedTable& other) = delete;
+
+  template <typename... Args>
+  int64_t emplace_back(Args&&... args);
+
+  T& operator[](int64_t index);
+  const T& operator[](int64_t index) const;
+
+  //  The number of indices allocated so far. While other threads are appending, this includes
+  //  indices whose elements may still be under construction; an element can only be read once
+  //  its index has been published to the reading thread.
+  int64_t size() const;
+
+private:
+  std::atomic<int64_t> next_index;
+  detail::Segments<T> segments;
+};
+
+template <typename T>
+SegmentedTable<T>::SegmentedTable() : next_index(0) {
+  //
+}
+
+template <typename T>
+SegmentedTable<T>::~SegmentedTable() {
+  //  No thread may append to the table while it is destroyed, so every allocated index refers
+  //  to a constructed element.
+  const auto num_elements = next_index.load();
+  for (int64_t i = 0; i < num_elements; i++) {
+    segments.element(i)->~T();
+  }
+}
+
+template <typename T>
+template <typename... Args>
+int64_t SegmentedTable<T>::emplace_back(Args&&... args) {
+  const auto index = next_index.fetch_add(1);
+  new (segments.require(index)) T(std::forward<Args>(args)...);
+  return index;
+}
+
+template <typename T>
+T& SegmentedTable<T>::operator[](int64_t index) {
+  assert(index >= 0 && index < size());
+  return *segments.element(index);
+}
+
+template <typename T>
+const T& SegmentedTable<T>::operator[](int64_t index) const {
+  assert(index >= 0 && index < size());
+  return *segments.element(index);
+}
+
+template <typename T>
+int64_t SegmentedTable<T>::size() const {
+  return next_index.load();
+}
+
+/*
+ * SegmentedColumn
+ *
+ * One field of the elements of a SegmentedTable, stored densely at the same indices, so that a
+ * scan over that field touches only that field. A value is set by the thread that creates the
+ * corresponding element, before the element's index is published.
+ */
+
+template <typename T>
+class SegmentedColumn {
+  static_assert(std::is_trivially_destructible<T>::value, "Column values are never destroyed.");
+
+public:
+  SegmentedColumn() = default;
+
+  void set(int64_t index, const T& value) {
+    new (segments.require(index)) T(value);
+  }
+
+  const T& operator[](int64_t index) const {
+    return *segments.element(index);
+  }
+
+private:
+  detail::Segments<T> segments;
+};
+
+}
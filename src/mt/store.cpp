@@ -8,15 +8,13 @@ namespace mt {
  */
 
 ClassDefHandle Store::make_class_definition() {
-  class_definitions.emplace_back();
-  return ClassDefHandle(class_definitions.size() - 1);
+  return ClassDefHandle(class_definitions.emplace_back());
 }
 
 FunctionDefHandle Store::make_function_declaration(FunctionHeader&& header,
                                                    const FunctionAttributes& attrs,
                                                    const MatlabScope* scope) {
-  function_definitions.emplace_back(std::move(header), attrs, scope);
-  return FunctionDefHandle(function_definitions.size() - 1);
+  return push_function_definition(FunctionDef(std::move(header), attrs, scope));
 }
 
 void Store::emplace_definition(const ClassDefHandle& at_handle, ClassDef&& def) {
@@ -32,23 +30,12 @@ ClassDef& Store::at(const ClassDefHandle& handle) {
 }
 
 Optional<FunctionDefHandle> Store::extract_constructor(const ClassDefHandle& for_class) const {
-  const auto& class_def = at(for_class);
-  const auto& methods = class_def.methods;
-
-  for (const auto& method : methods) {
-    FunctionDefHandle maybe_ctor_handle;
-
-    const auto& def = at(method);
-    if (def.attributes.is_constructor()) {
-      maybe_ctor_handle = method;
-    }
-
-    if (maybe_ctor_handle.is_valid()) {
-      return Optional<FunctionDefHandle>(maybe_ctor_handle);
-    }
+  const auto& ctor_handle = at(for_class).constructor;
+  if (ctor_handle.is_valid()) {
+    return Optional<FunctionDefHandle>(ctor_handle);
+  } else {
+    return NullOpt{};
   }
-
-  return NullOpt{};
 }
 
 /*
@@ -56,8 +43,7 @@ Optional<FunctionDefHandle> Store::extract_constructor(const ClassDefHandle& for
  */
 
 VariableDefHandle Store::emplace_definition(mt::VariableDef&& def) {
-  variable_definitions.emplace_back(std::move(def));
-  return VariableDefHandle(variable_definitions.size() - 1);
+  return VariableDefHandle(variable_definitions.emplace_back(std::move(def)));
 }
 
 VariableDefHandle Store::make_variable_def(VariableDef&& def) {
@@ -90,8 +76,7 @@ const FunctionReference& Store::at(const FunctionReferenceHandle& handle) const
 }
 
 FunctionReference Store::get(const FunctionReferenceHandle& handle) const {
-  assert(handle.is_valid() && handle.index < int64_t(function_references.size()));
-  Store::ReadConst reader(*this);
+  assert(handle.is_valid() && handle.index < function_references.size());
   return function_references[handle.index];
 }
 
@@ -106,8 +91,11 @@ MatlabIdentifier Store::get_name(const ClassDefHandle& handle) const {
 }
 
 MatlabIdentifier Store::get_name(const FunctionDefHandle& handle) const {
-  Store::ReadConst reader(*this);
-  return reader.at(handle).header.name;
+#if MT_STORE_SOA
+  return function_names[handle.index];
+#else
+  return at(handle).header.name;
+#endif
 }
 
 Token Store::get_name_token(const FunctionDefHandle& handle) const {
@@ -116,13 +104,42 @@ Token Store::get_name_token(const FunctionDefHandle& handle) const {
 }
 
 FunctionAttributes Store::get_attributes(const FunctionDefHandle& def_handle) const {
-  Store::ReadConst reader(*this);
-  return reader.at(def_handle).attributes;
+#if MT_STORE_SOA
+  return function_attributes[def_handle.index];
+#else
+  return at(def_handle).attributes;
+#endif
+}
+
+const MatlabScope* Store::get_scope(const FunctionDefHandle& def_handle) const {
+#if MT_STORE_SOA
+  return function_scopes[def_handle.index];
+#else
+  return at(def_handle).scope;
+#endif
 }
 
 FunctionDefHandle Store::emplace_definition(FunctionDef&& def) {
-  function_definitions.emplace_back(std::move(def));
-  return FunctionDefHandle(function_definitions.size() - 1);
+  return push_function_definition(std::move(def));
+}
+
+FunctionDefHandle Store::push_function_definition(FunctionDef&& def) {
+#if MT_STORE_SOA
+  const auto name = def.header.name;
+  const auto attributes = def.attributes;
+  const auto* scope = def.scope;
+#endif
+
+  const FunctionDefHandle handle(function_definitions.emplace_back(std::move(def)));
+
+#if MT_STORE_SOA
+  //  Names, attributes and scopes are not modified once the definition is created.
+  function_names.set(handle.index, name);
+  function_attributes.set(handle.index, attributes);
+  function_scopes.set(handle.index, scope);
+#endif
+
+  return handle;
 }
 
 FunctionReferenceHandle Store::make_external_reference(const MatlabIdentifier& to_identifier,
@@ -133,9 +150,12 @@ FunctionReferenceHandle Store::make_external_reference(const MatlabIdentifier& t
 FunctionReferenceHandle Store::make_local_reference(const MatlabIdentifier& to_identifier,
                                                     const FunctionDefHandle& with_def,
                                                     const MatlabScope* in_scope) {
-  FunctionReference reference(to_identifier, with_def, in_scope);
-  function_references.emplace_back(reference);
-  return FunctionReferenceHandle(function_references.size() - 1);
+  return FunctionReferenceHandle(function_references.emplace_back(to_identifier, with_def, in_scope));
+}
+
+void Store::bind_local_reference(const FunctionReferenceHandle& handle, const FunctionDefHandle& to_def) {
+  assert(handle.is_valid() && handle.index < function_references.size());
+  function_references[handle.index].def_handle = to_def;
 }
 
 /*
@@ -143,17 +163,11 @@ FunctionReferenceHandle Store::make_local_reference(const MatlabIdentifier& to_i
  */
 
 MatlabScope* Store::make_matlab_scope(const MatlabScope* parent, const CodeFileDescriptor* file_descriptor) {
-  auto new_scope = std::make_unique<MatlabScope>(parent, file_descriptor);
-  auto scope_ptr = new_scope.get();
-  matlab_scopes.push_back(std::move(new_scope));
-  return scope_ptr;
+  return &matlab_scopes[matlab_scopes.emplace_back(parent, file_descriptor)];
 }
 
 TypeScope* Store::make_type_scope(TypeScope* root, const TypeScope* parent) {
-  auto new_scope = std::make_unique<TypeScope>(root, parent);
-  auto scope_ptr = new_scope.get();
-  type_scopes.push_back(std::move(new_scope));
-  return scope_ptr;
+  return &type_scopes[type_scopes.emplace_back(root, parent)];
 }
 
 }
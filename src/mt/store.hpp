@@ -1,54 +1,53 @@
 #pragma once
 
-#define MT_USE_READ_WRITE_OPTIM (0)
+//  Keep the names, attributes and scopes of function definitions in dense columns alongside the
+//  definitions themselves, so that lookups and scans over those fields touch nothing else.
+#ifndef MT_STORE_SOA
+#define MT_STORE_SOA (1)
+#endif
 
 #include "handles.hpp"
 #include "definitions.hpp"
 #include "lang_components.hpp"
+#include "segmented_table.hpp"
 #include "type/type_scope.hpp"
 #include <mutex>
-
-#if MT_USE_READ_WRITE_OPTIM
-#include <condition_variable>
-#endif
+#include <shared_mutex>
+#include <type_traits>
 
 namespace mt {
 
 class CodeFileDescriptor;
 
 namespace detail {
-  using DefaultMutex = std::mutex;
+  using DefaultMutex = std::shared_mutex;
 }
 
+/*
+ * Store
+ *
+ * Definitions, references and scopes are kept in per-kind, append-only segmented tables. A
+ * `Write` allocates new entries without locking; the existing entries it modifies must be ones
+ * that have not yet been published to other threads. A `ReadMut`, which can modify any existing
+ * entry, excludes every other `ReadMut` and `ReadConst`; `ReadConst`s share access with one
+ * another.
+ */
+
 class Store {
 private:
   class StoreAccessor {
   public:
     template <typename T>
     class Read {
+      static constexpr bool is_mutable = !std::is_const<std::remove_reference_t<T>>::value;
+      using Lock = std::conditional_t<is_mutable,
+                                      std::unique_lock<detail::DefaultMutex>,
+                                      std::shared_lock<detail::DefaultMutex>>;
+
     public:
-#if MT_USE_READ_WRITE_OPTIM
-      explicit Read(T store) : store(store), accessor(store.accessor), lock(accessor.mutex) {
-        accessor.write_condition.wait(lock, [&]() {
-          return !accessor.is_writer_active && accessor.num_pending_writers == 0;
-        });
-        accessor.num_readers++;
-        lock.unlock();
-      }
-
-      ~Read() {
-        lock.lock();
-        accessor.num_readers--;
-        if (accessor.num_readers == 0) {
-          lock.unlock();
-          accessor.write_condition.notify_all();
-        }
-      }
-#else
-      explicit Read(T store) : store(store), accessor(store.accessor), lock(accessor.mutex) {
+      explicit Read(T store) : store(store), lock(store.accessor.mutex) {
         //
       }
-#endif
 
       template <typename... Args>
       const auto& at(Args&&... args) const {
@@ -71,34 +70,14 @@ private:
 
     private:
       T store;
-      StoreAccessor& accessor;
-      std::unique_lock<detail::DefaultMutex> lock;
+      Lock lock;
     };
 
     class Write {
     public:
-#if MT_USE_READ_WRITE_OPTIM
-      explicit Write(Store& store) : store(store), accessor(store.accessor), lock(accessor.mutex) {
-        accessor.num_pending_writers++;
-        accessor.write_condition.wait(lock, [&]() {
-          return accessor.num_readers == 0 && !accessor.is_writer_active;
-        });
-        accessor.num_pending_writers--;
-        accessor.is_writer_active = true;
-        lock.unlock();
-      }
-
-      ~Write() {
-        lock.lock();
-        accessor.is_writer_active = false;
-        lock.unlock();
-        accessor.write_condition.notify_all();
-      }
-#else
-      explicit Write(Store& store) : store(store), accessor(store.accessor), lock(accessor.mutex) {
+      explicit Write(Store& store) : store(store) {
         //
       }
-#endif
 
       template <typename... Args>
       auto emplace_definition(Args&&... args) {
@@ -131,6 +110,10 @@ private:
         return store.make_local_reference(std::forward<Args>(args)...);
       }
       template <typename... Args>
+      void bind_local_reference(Args&&... args) {
+        store.bind_local_reference(std::forward<Args>(args)...);
+      }
+      template <typename... Args>
       const auto& at(Args&&... args) const {
         return store.at(std::forward<Args>(args)...);
       }
@@ -141,28 +124,14 @@ private:
 
     private:
       Store& store;
-      StoreAccessor& accessor;
-      std::unique_lock<detail::DefaultMutex> lock;
     };
 
   public:
-#if MT_USE_READ_WRITE_OPTIM
-    StoreAccessor() : is_writer_active(false), num_pending_writers(0), num_readers(0) {
-      //
-    }
-#else
     StoreAccessor() = default;
-#endif
 
   private:
+    //  Held exclusively by `ReadMut`, and shared by `ReadConst`.
     mutable detail::DefaultMutex mutex;
-
-#if MT_USE_READ_WRITE_OPTIM
-    std::condition_variable write_condition;
-    bool is_writer_active;
-    int num_pending_writers;
-    int num_readers;
-#endif
   };
 
 public:
@@ -198,6 +167,7 @@ public:
   MatlabIdentifier get_name(const FunctionDefHandle& handle) const;
   Token get_name_token(const FunctionDefHandle& handle) const;
   FunctionAttributes get_attributes(const FunctionDefHandle& def_handle) const;
+  const MatlabScope* get_scope(const FunctionDefHandle& def_handle) const;
 
   VariableDefHandle make_variable_def(VariableDef&& def);
 
@@ -219,6 +189,7 @@ private:
   FunctionReferenceHandle make_local_reference(const MatlabIdentifier& to_identifier,
                                                const FunctionDefHandle& with_def,
                                                const MatlabScope* in_scope);
+  void bind_local_reference(const FunctionReferenceHandle& handle, const FunctionDefHandle& to_def);
 
   const ClassDef& at(const ClassDefHandle& handle) const;
   ClassDef& at(const ClassDefHandle& handle);
@@ -232,14 +203,21 @@ private:
 
   Optional<FunctionDefHandle> extract_constructor(const ClassDefHandle& for_class) const;
 
+  FunctionDefHandle push_function_definition(FunctionDef&& def);
+
 private:
   mutable StoreAccessor accessor;
-  std::vector<VariableDef> variable_definitions;
-  std::vector<ClassDef> class_definitions;
-  std::vector<FunctionDef> function_definitions;
-  std::vector<FunctionReference> function_references;
-  std::vector<std::unique_ptr<MatlabScope>> matlab_scopes;
-  std::vector<std::unique_ptr<TypeScope>> type_scopes;
+  SegmentedTable<VariableDef> variable_definitions;
+  SegmentedTable<ClassDef> class_definitions;
+  SegmentedTable<FunctionDef> function_definitions;
+#if MT_STORE_SOA
+  SegmentedColumn<MatlabIdentifier> function_names;
+  SegmentedColumn<FunctionAttributes> function_attributes;
+  SegmentedColumn<const MatlabScope*> function_scopes;
+#endif
+  SegmentedTable<FunctionReference> function_references;
+  SegmentedTable<MatlabScope> matlab_scopes;
+  SegmentedTable<TypeScope> type_scopes;
 };
 
 }
\ No newline at end of file
@@ -10,6 +10,12 @@
 
 namespace mt {
 
+StringRegistry::StringRegistry(const StringRegistry& other) {
+  std::lock_guard<std::mutex> lock(other.mutex);
+  string_registry = other.string_registry;
+  strings = other.strings;
+}
+
 int64_t StringRegistry::size() const {
   std::lock_guard<std::mutex> lock(mutex);
   return strings.size();
@@ -15,8 +15,11 @@ class Optional;
 class StringRegistry {
 public:
   StringRegistry() = default;
+  StringRegistry(const StringRegistry& other);
   ~StringRegistry() = default;
 
+  StringRegistry& operator=(const StringRegistry& other) = delete;
+
   int64_t register_string(std::string_view str);
   std::vector<int64_t> register_strings(const std::vector<std::string_view>& strs);
 
@@ -554,6 +554,10 @@ bool represents_postfix_unary_operator(TokenType type) {
   return type == TokenType::apostrophe || type == TokenType::dot_apostrophe;
 }
 
+bool represents_power_operator(TokenType type) {
+  return type == TokenType::carat || type == TokenType::dot_carat;
+}
+
 std::array<TokenType, 3> grouping_terminators() {
   return {{TokenType::right_parens, TokenType::right_bracket, TokenType::right_bracket}};
 }
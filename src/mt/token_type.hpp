@@ -117,6 +117,7 @@ bool represents_binary_operator(TokenType type);
 bool represents_unary_operator(TokenType type);
 bool represents_prefix_unary_operator(TokenType type);
 bool represents_postfix_unary_operator(TokenType type);
+bool represents_power_operator(TokenType type);
 bool represents_grouping_component(TokenType type);
 bool represents_grouping_initiator(TokenType type);
 bool represents_grouping_terminator(TokenType type);
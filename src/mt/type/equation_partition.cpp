@@ -0,0 +1,297 @@
+#include "equation_partition.hpp"
+#include <cassert>
+
+namespace mt {
+
+namespace {
+  inline bool is_leaf(const Type* type) {
+    //  Scalars and constant values are never modified by the unifier, so they
+    //  can be shared between components.
+    return type->is_scalar() || type->is_constant_value();
+  }
+}
+
+void EquationPartition::push_members(const Type* type, std::vector<const Type*>& into) {
+  switch (type->tag) {
+    case Type::Tag::abstraction: {
+      const auto& abstr = MT_ABSTR_REF(*type);
+      into.push_back(abstr.inputs);
+      into.push_back(abstr.outputs);
+      break;
+    }
+    case Type::Tag::application: {
+      const auto& app = MT_APP_REF(*type);
+      into.push_back(app.abstraction);
+      into.push_back(app.inputs);
+      into.push_back(app.outputs);
+      break;
+    }
+    case Type::Tag::tuple:
+      into.insert(into.end(), MT_TUPLE_REF(*type).members.begin(), MT_TUPLE_REF(*type).members.end());
+      break;
+    case Type::Tag::union_type:
+      into.insert(into.end(), MT_UNION_REF(*type).members.begin(), MT_UNION_REF(*type).members.end());
+      break;
+    case Type::Tag::destructured_tuple:
+      into.insert(into.end(), MT_DT_REF(*type).members.begin(), MT_DT_REF(*type).members.end());
+      break;
+    case Type::Tag::list:
+      into.insert(into.end(), MT_LIST_REF(*type).pattern.begin(), MT_LIST_REF(*type).pattern.end());
+      break;
+    case Type::Tag::subscript: {
+      const auto& sub = MT_SUBS_REF(*type);
+      into.push_back(sub.principal_argument);
+      for (const auto& s : sub.subscripts) {
+        into.insert(into.end(), s.arguments.begin(), s.arguments.end());
+      }
+      into.push_back(sub.outputs);
+      break;
+    }
+    case Type::Tag::assignment: {
+      const auto& assign = MT_ASSIGN_REF(*type);
+      into.push_back(assign.lhs);
+      into.push_back(assign.rhs);
+      break;
+    }
+    case Type::Tag::scheme: {
+      //  Free variables of a scheme's constraints are shared with its instances.
+      const auto& scheme = MT_SCHEME_REF(*type);
+      into.push_back(scheme.type);
+      into.insert(into.end(), scheme.parameters.begin(), scheme.parameters.end());
+      for (const auto& constraint : scheme.constraints) {
+        into.push_back(constraint.lhs.term);
+        into.push_back(constraint.rhs.term);
+      }
+      break;
+    }
+    case Type::Tag::class_type:
+      into.push_back(MT_CLASS_REF(*type).source);
+      break;
+    case Type::Tag::record:
+      for (const auto& field : MT_RECORD_REF(*type).fields) {
+        into.push_back(field.name);
+        into.push_back(field.type);
+      }
+      break;
+    case Type::Tag::alias:
+      into.push_back(MT_ALIAS_REF(*type).source);
+      break;
+    case Type::Tag::cast: {
+      const auto& cast = MT_CAST_REF(*type);
+      into.push_back(cast.from);
+      into.push_back(cast.to);
+      break;
+    }
+    case Type::Tag::variable:
+    case Type::Tag::parameters:
+    case Type::Tag::scalar:
+    case Type::Tag::constant_value:
+      break;
+    default:
+      assert(false && "Unhandled.");
+  }
+}
+
+int64_t EquationPartition::require_node(const Type* type, bool* inserted) {
+  auto node_it = node_indices.find(type);
+  if (node_it != node_indices.end()) {
+    *inserted = false;
+    return node_it->second;
+  }
+
+  const auto node = int64_t(parents.size());
+  node_indices[type] = node;
+  parents.push_back(node);
+  *inserted = true;
+
+  return node;
+}
+
+int64_t EquationPartition::find(int64_t node) {
+  while (parents[node] != node) {
+    parents[node] = parents[parents[node]];
+    node = parents[node];
+  }
+  return node;
+}
+
+void EquationPartition::unite(int64_t a, int64_t b) {
+  a = find(a);
+  b = find(b);
+
+  if (a != b) {
+    //  Keep the earliest node as the root, so that components are ordered
+    //  by first appearance.
+    if (a < b) {
+      parents[b] = a;
+    } else {
+      parents[a] = b;
+    }
+  }
+}
+
+int64_t EquationPartition::visit(const Type* type) {
+  if (is_leaf(type)) {
+    return no_component;
+  }
+
+  bool inserted;
+  const auto root = require_node(type, &inserted);
+  if (!inserted) {
+    return root;
+  }
+
+  std::vector<std::pair<const Type*, int64_t>> pending{{type, root}};
+  std::vector<const Type*> members;
+
+  while (!pending.empty()) {
+    const auto next = pending.back();
+    pending.pop_back();
+
+    members.clear();
+    push_members(next.first, members);
+
+    for (const auto& member : members) {
+      if (is_leaf(member)) {
+        continue;
+      }
+
+      const auto member_node = require_node(member, &inserted);
+      unite(next.second, member_node);
+
+      if (inserted) {
+        pending.emplace_back(member, member_node);
+      }
+    }
+  }
+
+  return root;
+}
+
+void EquationPartition::add_equation(int64_t index, const TypeEquation& eq) {
+  assert(index == int64_t(equation_nodes.size()) && "Equations must be added in order.");
+  (void) index;
+
+  const auto lhs = visit(eq.lhs.term);
+  const auto rhs = visit(eq.rhs.term);
+
+  if (lhs != no_component && rhs != no_component) {
+    unite(lhs, rhs);
+  }
+
+  equation_nodes.emplace_back(lhs, rhs);
+}
+
+void EquationPartition::add_binding(int64_t index, const TypeEquation& binding) {
+  assert(index == int64_t(binding_nodes.size()) && "Bindings must be added in order.");
+  (void) index;
+
+  const auto lhs = visit(binding.lhs.term);
+  const auto rhs = visit(binding.rhs.term);
+
+  if (lhs != no_component && rhs != no_component) {
+    unite(lhs, rhs);
+  }
+
+  binding_nodes.emplace_back(lhs, rhs);
+}
+
+void EquationPartition::add_root(const Type* type) {
+  visit(type);
+}
+
+void EquationPartition::link(const Type* a, const Type* b) {
+  const auto node_a = visit(a);
+  const auto node_b = visit(b);
+
+  if (node_a != no_component && node_b != no_component) {
+    unite(node_a, node_b);
+  }
+}
+
+void EquationPartition::finalize() {
+  std::vector<int64_t> root_components(parents.size(), inactive_component);
+  components.clear();
+
+  for (int64_t i = 0; i < int64_t(equation_nodes.size()); i++) {
+    const auto& nodes = equation_nodes[i];
+    const auto node = nodes.first != no_component ? nodes.first : nodes.second;
+
+    if (node == no_component) {
+      //  Equation between leaf types; it is its own component.
+      components.emplace_back();
+      components.back().equations.push_back(i);
+      continue;
+    }
+
+    auto& component_index = root_components[find(node)];
+    if (component_index == inactive_component) {
+      component_index = int64_t(components.size());
+      components.emplace_back();
+    }
+
+    components[component_index].equations.push_back(i);
+  }
+
+  for (int64_t i = 0; i < int64_t(binding_nodes.size()); i++) {
+    const auto& nodes = binding_nodes[i];
+    const auto node = nodes.first != no_component ? nodes.first : nodes.second;
+    if (node == no_component) {
+      continue;
+    }
+
+    const auto component_index = root_components[find(node)];
+    if (component_index != inactive_component) {
+      components[component_index].bindings.push_back(i);
+    }
+  }
+
+  node_components.resize(parents.size());
+  for (int64_t i = 0; i < int64_t(parents.size()); i++) {
+    node_components[i] = root_components[find(i)];
+  }
+}
+
+int64_t EquationPartition::num_components() const {
+  return components.size();
+}
+
+const EquationPartition::Component& EquationPartition::component(int64_t index) const {
+  return components[index];
+}
+
+int64_t EquationPartition::owning_component(const Type* type) const {
+  const auto node_it = node_indices.find(type);
+  if (node_it == node_indices.end()) {
+    return no_component;
+  } else {
+    return node_components[node_it->second];
+  }
+}
+
+bool EquationPartition::is_foreign(const Type* type, int64_t component) const {
+  std::vector<const Type*> pending{type};
+
+  while (!pending.empty()) {
+    const auto* next = pending.back();
+    pending.pop_back();
+
+    const auto owner = owning_component(next);
+    if (owner == component) {
+      //  Members of an owned type are owned as well.
+      continue;
+    } else if (owner != no_component) {
+      return true;
+    }
+
+    push_members(next, pending);
+  }
+
+  return false;
+}
+
+bool EquationPartition::is_foreign(const TypeEquation& eq, int64_t component) const {
+  return is_foreign(eq.lhs.term, component) || is_foreign(eq.rhs.term, component);
+}
+
+}
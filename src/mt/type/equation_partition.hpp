@@ -0,0 +1,70 @@
+#pragma once
+
+#include "types.hpp"
+#include <unordered_map>
+#include <vector>
+
+namespace mt {
+
+/*
+ * EquationPartition
+ *
+ * Groups pending type equations into connected components over the (non-leaf)
+ * types they reference, such that equations in different components share no
+ * mutable type and can be solved independently of one another.
+ */
+
+class EquationPartition {
+public:
+  //  The type is not referenced by any equation, binding, or root.
+  static constexpr int64_t no_component = -1;
+  //  The type is referenced, but not by any pending equation.
+  static constexpr int64_t inactive_component = -2;
+
+  struct Component {
+    std::vector<int64_t> equations;
+    std::vector<int64_t> bindings;
+  };
+
+public:
+  EquationPartition() = default;
+
+  void add_equation(int64_t index, const TypeEquation& eq);
+  void add_binding(int64_t index, const TypeEquation& binding);
+  void add_root(const Type* type);
+  void link(const Type* a, const Type* b);
+  void finalize();
+
+  int64_t num_components() const;
+  const Component& component(int64_t index) const;
+
+  int64_t owning_component(const Type* type) const;
+  //  True if `type`, or a member of `type` not owned by `component`, is referenced by
+  //  anything other than `component`.
+  bool is_foreign(const Type* type, int64_t component) const;
+  bool is_foreign(const TypeEquation& eq, int64_t component) const;
+
+  static void push_members(const Type* type, std::vector<const Type*>& into);
+
+private:
+  int64_t visit(const Type* type);
+  int64_t require_node(const Type* type, bool* inserted);
+  int64_t find(int64_t node);
+  void unite(int64_t a, int64_t b);
+
+private:
+  std::unordered_map<const Type*, int64_t> node_indices;
+  std::vector<int64_t> parents;
+
+  //  First node of each equation / binding, or `no_component` if the equation
+  //  references only leaf types.
+  std::vector<std::pair<int64_t, int64_t>> equation_nodes;
+  std::vector<std::pair<int64_t, int64_t>> binding_nodes;
+
+  //  Component of each node, fixed by `finalize()` so that lookups are
+  //  read-only (and can be made concurrently).
+  std::vector<int64_t> node_components;
+  std::vector<Component> components;
+};
+
+}
@@ -54,6 +54,11 @@ Token SimplificationFailure::get_source_token() const {
   return *lhs_token;
 }
 
+void SimplificationFailure::gather_types(std::vector<const Type*>& into) const {
+  into.push_back(lhs_type);
+  into.push_back(rhs_type);
+}
+
 /*
  * OccursCheckFailure
  */
@@ -70,6 +75,11 @@ Token OccursCheckFailure::get_source_token() const {
   return *lhs_token;
 }
 
+void OccursCheckFailure::gather_types(std::vector<const Type*>& into) const {
+  into.push_back(lhs_type);
+  into.push_back(rhs_type);
+}
+
 /*
  * UnresolvedFunctionError
  */
@@ -85,6 +95,10 @@ Token UnresolvedFunctionError::get_source_token() const {
   return *at_token;
 }
 
+void UnresolvedFunctionError::gather_types(std::vector<const Type*>& into) const {
+  into.push_back(function_type);
+}
+
 /*
  * UnknownIsaGuardedClass
  */
@@ -116,6 +130,10 @@ Token InvalidFunctionInvocationError::get_source_token() const {
   return *at_token;
 }
 
+void InvalidFunctionInvocationError::gather_types(std::vector<const Type*>& into) const {
+  into.push_back(function_type);
+}
+
 /*
  * NonConstantFieldReferenceExprError
  */
@@ -131,6 +149,10 @@ Token NonConstantFieldReferenceExprError::get_source_token() const {
   return *at_token;
 }
 
+void NonConstantFieldReferenceExprError::gather_types(std::vector<const Type*>& into) const {
+  into.push_back(arg_type);
+}
+
 /*
  * NonexistentFieldReferenceError
  */
@@ -147,6 +169,11 @@ Token NonexistentFieldReferenceError::get_source_token() const {
   return *at_token;
 }
 
+void NonexistentFieldReferenceError::gather_types(std::vector<const Type*>& into) const {
+  into.push_back(arg_type);
+  into.push_back(field_type);
+}
+
 /*
  * UnhandledCustomSubscriptsError
  */
@@ -161,6 +188,10 @@ Token UnhandledCustomSubscriptsError::get_source_token() const {
   return *at_token;
 }
 
+void UnhandledCustomSubscriptsError::gather_types(std::vector<const Type*>& into) const {
+  into.push_back(arg_type);
+}
+
 /*
  * DuplicateTypeIdentifierError
  */
@@ -189,6 +220,10 @@ Token CouldNotInferTypeError::get_source_token() const {
   return *source_token;
 }
 
+void CouldNotInferTypeError::gather_types(std::vector<const Type*>& into) const {
+  into.push_back(in_type);
+}
+
 /*
  * RecursiveTypeError
  */
@@ -216,6 +251,10 @@ Token BadCastError::get_source_token() const {
   return *source_token;
 }
 
+void BadCastError::gather_types(std::vector<const Type*>& into) const {
+  into.push_back(cast);
+}
+
 /*
  * ShowUnificationErrors
  */
@@ -238,16 +277,16 @@ void ShowTypeErrors::show(const TypeError& err, int64_t index, const TokenSource
   auto msg = mark_text_with_message_and_context(source_data.source, start, stop, context_amount, type_msg);
   msg = indent_spaces(msg, 2);
 
-  std::cout << stylize(style::underline) << index;
-  std::cout << ". " << descriptor.file_path << " ";
+  *out << stylize(style::underline) << index;
+  *out << ". " << descriptor.file_path << " ";
 
   auto new_line_res = row_col_indices.line_info(start);
   auto row = new_line_res ? new_line_res.value().row : -1;
   auto col = new_line_res ? new_line_res.value().column : -1;
 
-  std::cout << "" << row << ":" << col << "";
-  std::cout << stylize(style::dflt) << std::endl << std::endl;
-  std::cout << msg << std::endl << std::endl << std::endl;
+  *out << "" << row << ":" << col << "";
+  *out << stylize(style::dflt) << "\n\n";
+  *out << msg << "\n\n\n";
 }
 
 void ShowTypeErrors::show(const TypeErrors& errs, const TokenSourceMap& source_data) const {
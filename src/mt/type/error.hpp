@@ -5,6 +5,7 @@
 #include "../token.hpp"
 #include <string>
 #include <vector>
+#include <iostream>
 
 namespace mt {
 
@@ -16,6 +17,10 @@ class TokenSourceMap;
 struct TypeError {
   virtual std::string get_text(const ShowTypeErrors& shower) const = 0;
   virtual Token get_source_token() const = 0;
+  //  Types that must outlive the error, for it to be shown.
+  virtual void gather_types(std::vector<const Type*>&) const {
+    //
+  }
   virtual ~TypeError() = default;
 };
 
@@ -29,6 +34,7 @@ struct SimplificationFailure : public TypeError {
 
   std::string get_text(const ShowTypeErrors& shower) const override;
   Token get_source_token() const override;
+  void gather_types(std::vector<const Type*>& into) const override;
 
   const Token* lhs_token;
   const Token* rhs_token;
@@ -46,6 +52,7 @@ struct OccursCheckFailure : public TypeError {
 
   std::string get_text(const ShowTypeErrors& shower) const override;
   Token get_source_token() const override;
+  void gather_types(std::vector<const Type*>& into) const override;
 
   const Token* lhs_token;
   const Token* rhs_token;
@@ -61,6 +68,7 @@ struct UnresolvedFunctionError : public TypeError {
   ~UnresolvedFunctionError() override = default;
   std::string get_text(const ShowTypeErrors& shower) const override;
   Token get_source_token() const override;
+  void gather_types(std::vector<const Type*>& into) const override;
 
   const Token* at_token;
   const Type* function_type;
@@ -85,6 +93,7 @@ struct InvalidFunctionInvocationError : public TypeError {
   ~InvalidFunctionInvocationError() override = default;
   std::string get_text(const ShowTypeErrors& shower) const override;
   Token get_source_token() const override;
+  void gather_types(std::vector<const Type*>& into) const override;
 
   const Token* at_token;
   const Type* function_type;
@@ -98,6 +107,7 @@ struct NonConstantFieldReferenceExprError : public TypeError {
   ~NonConstantFieldReferenceExprError() override = default;
   std::string get_text(const ShowTypeErrors& shower) const override;
   Token get_source_token() const override;
+  void gather_types(std::vector<const Type*>& into) const override;
 
   const Token* at_token;
   const Type* arg_type;
@@ -111,6 +121,7 @@ struct NonexistentFieldReferenceError : public TypeError {
   ~NonexistentFieldReferenceError() override = default;
   std::string get_text(const ShowTypeErrors& shower) const override;
   Token get_source_token() const override;
+  void gather_types(std::vector<const Type*>& into) const override;
 
   const Token* at_token;
   const Type* arg_type;
@@ -125,6 +136,7 @@ struct UnhandledCustomSubscriptsError : public TypeError {
   ~UnhandledCustomSubscriptsError() override = default;
   std::string get_text(const ShowTypeErrors& shower) const override;
   Token get_source_token() const override;
+  void gather_types(std::vector<const Type*>& into) const override;
 
   const Token* at_token;
   const Type* arg_type;
@@ -156,6 +168,7 @@ struct CouldNotInferTypeError : public TypeError {
 
   std::string get_text(const ShowTypeErrors& shower) const override;
   Token get_source_token() const override;
+  void gather_types(std::vector<const Type*>& into) const override;
 
   const Token* source_token;
   std::string kind_str;
@@ -186,6 +199,7 @@ struct BadCastError : public TypeError {
 
   std::string get_text(const ShowTypeErrors& shower) const override;
   Token get_source_token() const override;
+  void gather_types(std::vector<const Type*>& into) const override;
 
   const Token* source_token;
   const Type* cast;
@@ -209,7 +223,7 @@ BoxedTypeError make_bad_cast_error(const Token* at_token, const Type* cast);
 class ShowTypeErrors {
 public:
   ShowTypeErrors(const TypeToString& type_to_string) :
-  type_to_string(type_to_string) {
+  type_to_string(type_to_string), out(&std::cout) {
     //
   }
 
@@ -225,6 +239,7 @@ private:
 
 public:
   const TypeToString& type_to_string;
+  std::ostream* out;
 };
 
 }
\ No newline at end of file
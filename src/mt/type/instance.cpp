@@ -115,18 +115,20 @@ Type* Instantiation::clone(const types::Subscript& sub, InstanceVars& replacing)
 }
 
 Type* Instantiation::clone(const types::Variable&, Type* source, InstanceVars& replacing) {
-  if (replacing.count(source) > 0) {
-    return replacing.at(source);
-  } else {
-    return source;
-  }
+  return replace(source, replacing);
 }
 
 Type* Instantiation::clone(const types::Parameters&, Type* source, InstanceVars& replacing) {
-  if (replacing.count(source) > 0) {
-    return replacing.at(source);
-  } else {
+  return replace(source, replacing);
+}
+
+Type* Instantiation::replace(Type* source, InstanceVars& replacing) {
+  auto it = replacing.find(source);
+  if (it == replacing.end()) {
     return source;
+  } else {
+    num_replaced++;
+    return it->second;
   }
 }
 
@@ -6,12 +6,20 @@
 
 namespace mt {
 
+/*
+ * Instantiation
+ *
+ * Every composite type is copied, since the unifier rewrites the members of a type in place,
+ * and an instance must not share them with its scheme or with other instances. Only leaves that
+ * are never rewritten (scalars, constant values, and variables that are not replaced) are shared.
+ */
+
 class Instantiation {
 public:
   using InstanceVars = std::unordered_map<Type*, Type*>;
 
 public:
-  explicit Instantiation(TypeStore& store) : store(store) {
+  explicit Instantiation(TypeStore& store) : store(store), num_replaced(0) {
     //
   }
 
@@ -20,6 +28,12 @@ public:
   Type* clone(Type* source, InstanceVars& replacing);
   InstanceVars make_instance_variables(const types::Scheme& from_scheme);
 
+  //  Number of variables replaced over all clones so far; a clone references one of the
+  //  replaced variables if this changes.
+  int64_t num_replaced_variables() const {
+    return num_replaced;
+  }
+
 private:
   void make_instance_variables(const types::Scheme& from_scheme, InstanceVars& into);
 
@@ -41,9 +55,11 @@ private:
   Type* clone(const types::ConstantValue& cv, Type* source, InstanceVars& replacing);
 
   TypePtrs clone(const TypePtrs& members, InstanceVars& replacing);
+  Type* replace(Type* source, InstanceVars& replacing);
 
 private:
   TypeStore& store;
+  int64_t num_replaced;
 };
 
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "../fs/code_file.hpp"
 #include <functional>
 #include <cassert>
+#include <mutex>
 
 namespace mt {
 
@@ -22,6 +23,7 @@ Library::Library(TypeStore& store, Store& def_store, const SearchPath&
   store(store),
   def_store(def_store),
   string_registry(string_registry),
+  class_hierarchy_version(0),
   search_path(search_path),
   scalar_store(store, string_registry),
   special_identifiers(string_registry),
@@ -30,6 +32,22 @@ Library::Library(TypeStore& store, Store& def_store, const SearchPath&
   make_known_types();
 }
 
+Library::Library(TypeStore& store, Store& def_store, const SearchPath& search_path,
+                 StringRegistry& string_registry, const Library& base) :
+  subtype_relation(*this),
+  type_eq(equiv_relation, store),
+  store(store),
+  def_store(def_store),
+  string_registry(string_registry),
+  class_hierarchy_version(base.class_hierarchy_version),
+  search_path(search_path),
+  scalar_store(store, string_registry),
+  special_identifiers(string_registry),
+  base_scope(nullptr) {
+  //
+  copy_known_types(base);
+}
+
 bool Library::subtype_related(const Type* lhs, const Type* rhs) const {
   auto maybe_lhs_cls = class_for_type(lhs);
   auto maybe_rhs_cls = class_for_type(rhs);
@@ -52,39 +70,70 @@ bool Library::subtype_related(const Type* lhs, const Type* rhs) const {
   return false;
 }
 
-Optional<FunctionSearchResult>
-Library::search_function(const FunctionReferenceHandle& ref_handle) const {
-  auto ref = def_store.get(ref_handle);
-  const auto& identifier = ref.name;
-  auto str_name = string_registry.at(identifier.full_name());
-  const auto& file_descriptor = *ref.scope->file_descriptor;
-
-  auto maybe_candidate = search_path.search_for(str_name, file_descriptor);
-  if (maybe_candidate) {
-    FunctionSearchCandidate candidate(maybe_candidate.value(), identifier);
-    return Optional<FunctionSearchResult>(std::move(candidate));
-
-  } else if (identifier.size() < 2) {
-    //  Not a valid static method name.
-    return NullOpt{};
+std::size_t Library::ExternalFunctionKey::Hash::operator()(const ExternalFunctionKey& key) const noexcept {
+  return std::hash<int64_t>{}(key.name) ^ (std::hash<int64_t>{}(key.directory_id) << 1u);
+}
+
+int64_t Library::containing_directory_id(const CodeFileDescriptor* file_descriptor) const {
+  {
+    std::shared_lock<std::shared_mutex> lock(search_mutex);
+    const auto it = directory_ids.find(file_descriptor);
+    if (it != directory_ids.end()) {
+      return it->second;
+    }
   }
 
-  auto components = mt::split(str_name, Character('.'));
-  assert(components.size() > 1);
+  const auto directory_id = search_path.containing_directory_id(*file_descriptor);
+  std::unique_lock<std::shared_mutex> lock(search_mutex);
+  directory_ids.emplace(file_descriptor, directory_id);
+  return directory_id;
+}
+
+Optional<FunctionSearchCandidate>
+Library::search_external_function(const MatlabIdentifier& identifier, int64_t directory_id) const {
+  const ExternalFunctionKey key{identifier.full_name(), directory_id};
+  {
+    std::shared_lock<std::shared_mutex> lock(search_mutex);
+    const auto it = external_function_candidates.find(key);
+    if (it != external_function_candidates.end()) {
+      return it->second;
+    }
+  }
 
-  auto presumed_class_name = join(components, ".", components.size()-1);
-  auto maybe_class = search_path.search_for(presumed_class_name, file_descriptor);
+  Optional<FunctionSearchCandidate> result;
+  const auto str_name = string_registry.at(identifier.full_name());
 
-  if (maybe_class) {
-    std::string presumed_method_name{components[components.size()-1]};
-    const auto name_ident =
-      MatlabIdentifier(string_registry.register_string(presumed_method_name));
+  if (auto maybe_candidate = search_path.search_for(str_name, directory_id)) {
+    result = FunctionSearchCandidate(maybe_candidate.value(), identifier);
 
-    FunctionSearchCandidate candidate(maybe_class.value(), name_ident);
-    return Optional<FunctionSearchResult>(std::move(candidate));
+  } else if (identifier.size() > 1) {
+    //  Possibly a static method, `package.Class.method`.
+    const auto last_dot = str_name.rfind('.');
+    assert(last_dot != std::string::npos);
+
+    const auto presumed_class_name = str_name.substr(0, last_dot);
+    if (auto maybe_class = search_path.search_for(presumed_class_name, directory_id)) {
+      const auto presumed_method_name = str_name.substr(last_dot + 1);
+      const auto name_ident = MatlabIdentifier(string_registry.register_string(presumed_method_name));
+      result = FunctionSearchCandidate(maybe_class.value(), name_ident);
+    }
   }
 
-  return NullOpt{};
+  std::unique_lock<std::shared_mutex> lock(search_mutex);
+  external_function_candidates[key] = result;
+  return result;
+}
+
+Optional<FunctionSearchResult>
+Library::search_function(const FunctionReferenceHandle& ref_handle) const {
+  const auto ref = def_store.get(ref_handle);
+  const auto directory_id = containing_directory_id(ref.scope->file_descriptor);
+
+  if (auto maybe_candidate = search_external_function(ref.name, directory_id)) {
+    return Optional<FunctionSearchResult>(maybe_candidate.rvalue());
+  } else {
+    return NullOpt{};
+  }
 }
 
 FunctionSearchResult Library::search_function(const types::Abstraction& func,
@@ -198,10 +247,19 @@ bool Library::emplace_local_class_type(const ClassDefHandle& handle, types::Clas
   assert(local_class_types.count(handle) == 0);
   local_class_types[handle] = type;
   class_types[type->name] = type;
+  class_hierarchy_changed();
 
   return true;
 }
 
+int64_t Library::get_class_hierarchy_version() const {
+  return class_hierarchy_version;
+}
+
+void Library::class_hierarchy_changed() {
+  class_hierarchy_version++;
+}
+
 void Library::emplace_local_variable_type(const VariableDefHandle& handle, Type* type) {
 //  assert(local_variables_types.count(handle) == 0);
   local_variables_types[handle] = type;
@@ -244,6 +302,7 @@ bool Library::emplace_declared_class_type(const TypeIdentifier& name, types::Cla
     return false;
   } else {
     class_types[name] = class_type;
+    class_hierarchy_changed();
     return true;
   }
 }
@@ -319,6 +378,44 @@ void Library::make_known_types() {
   make_subtype_debug();
 }
 
+void Library::copy_known_types(const Library& base) {
+  assert(base.local_function_types.empty() && base.local_class_types.empty() &&
+         base.local_variables_types.empty() && "Expected an unused library.");
+
+  const auto copies = store.copy_from(base.store);
+  make_base_type_scope();
+
+  for (const auto& source_ref : copies.type_references) {
+    assert(source_ref.first->scope == base.base_scope);
+    source_ref.second->scope = base_scope;
+  }
+  for (const auto& local_type : base.base_scope->local_types) {
+    base_scope->local_types[local_type.first] = copies.type_reference(local_type.second);
+  }
+  for (const auto& exported_type : base.base_scope->exports) {
+    base_scope->exports[exported_type.first] = copies.type_reference(exported_type.second);
+  }
+
+  for (const auto& function_type : base.function_types) {
+    auto abstr = types::Abstraction::clone(function_type.first,
+      copies.type(function_type.first.inputs), copies.type(function_type.first.outputs));
+    function_types[abstr] = copies.type(function_type.second);
+  }
+  for (const auto& class_type : base.class_types) {
+    class_types[class_type.first] = MT_CLASS_MUT_PTR(copies.type(class_type.second));
+  }
+
+  declared_function_types = base.declared_function_types;
+  double_id = base.double_id;
+  sub_double_id = base.sub_double_id;
+  char_id = base.char_id;
+  string_id = base.string_id;
+  logical_id = base.logical_id;
+
+  method_store.copy_from(base.method_store, copies);
+  scalar_store.copy_from(base.scalar_store, copies);
+}
+
 void Library::make_base_type_scope() {
   def_store.use<Store::Write>([&](auto& writer) {
     base_scope = writer.make_type_scope(nullptr, nullptr);
@@ -374,7 +471,7 @@ void Library::make_subtype_debug() {
   auto rec0 = store.make_record();
   auto f0_name = store.make_constant_value(TypeIdentifier(string_registry.register_string("x")));
   auto f0 = types::Record::Field{f0_name, get_number_type().value()};
-  rec0->fields.push_back(f0);
+  rec0->add_field(f0);
   auto cls0 = store.make_class(TypeIdentifier(string_registry.register_string("cls0")), rec0);
   auto method0 = make_simple_function("method1", TypePtrs{cls0}, TypePtrs{get_number_type().value()});
   class_types[cls0->name] = cls0;
@@ -455,6 +552,19 @@ const Library::LocalFunctionTypes& Library::get_local_function_types() const {
  * MethodStore
  */
 
+void MethodStore::copy_from(const MethodStore& source, const TypeStore::Copies& copies) {
+  for (const auto& class_methods : source.methods) {
+    const auto* cls = MT_CLASS_PTR(copies.type(class_methods.first));
+    auto& methods_this_class = require_methods(cls);
+
+    for (const auto& method : class_methods.second) {
+      auto abstr = types::Abstraction::clone(method.first,
+        copies.type(method.first.inputs), copies.type(method.first.outputs));
+      methods_this_class[abstr] = copies.type(method.second);
+    }
+  }
+}
+
 bool MethodStore::has_method(const types::Class* cls, const types::Abstraction& ref) const {
   if (methods.count(cls) == 0) {
     return false;
@@ -500,6 +610,12 @@ MethodStore::TypedMethods& MethodStore::require_methods(const types::Class* for_
  * ScalarTypeStore
  */
 
+void ScalarTypeStore::copy_from(const ScalarTypeStore& source, const TypeStore::Copies& copies) {
+  for (const auto& scalar_type : source.scalar_types) {
+    scalar_types[scalar_type.first] = copies.type(scalar_type.second);
+  }
+}
+
 types::Scalar* ScalarTypeStore::make_named_scalar_type(const char* name) {
   const auto identifier = TypeIdentifier(string_registry.register_string(name));
   return make_named_scalar_type(identifier);
@@ -4,20 +4,23 @@
 #include "type_relation.hpp"
 #include "type_relationships.hpp"
 #include "pending_external_functions.hpp"
+#include "type_store.hpp"
 #include "../Optional.hpp"
 #include "../handles.hpp"
+#include "../handle_map.hpp"
 #include "../store.hpp"
 #include <map>
+#include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 namespace mt {
 
-class TypeStore;
 class StringRegistry;
 class FunctionDefHandle;
 class SearchPath;
+class CodeFileDescriptor;
 struct SearchCandidate;
 struct TypeScope;
 
@@ -48,6 +51,8 @@ public:
     //
   }
 
+  void copy_from(const ScalarTypeStore& source, const TypeStore::Copies& copies);
+
   bool contains(const TypeIdentifier& name) const;
   types::Scalar* make_named_scalar_type(const char* name);
   types::Scalar* make_named_scalar_type(const TypeIdentifier& name);
@@ -71,6 +76,8 @@ class MethodStore {
 public:
   MethodStore() = default;
 
+  void copy_from(const MethodStore& source, const TypeStore::Copies& copies);
+
   Optional<Type*> lookup_method(const types::Class* cls, const types::Abstraction& by_header) const;
   void add_method(const types::Class* to_class, const types::Abstraction& ref, Type* type);
 
@@ -91,16 +98,18 @@ private:
 class Library {
   friend class Unifier;
 public:
-  using LocalFunctionTypes =
-    std::unordered_map<FunctionDefHandle, Type*, FunctionDefHandle::Hash>;
-  using LocalClassTypes =
-    std::unordered_map<ClassDefHandle, types::Class*, ClassDefHandle::Hash>;
-  using LocalVariableTypes =
-    std::unordered_map<VariableDefHandle, Type*, VariableDefHandle::Hash>;
+  using LocalFunctionTypes = HandleMap<FunctionDefHandle, Type*>;
+  using LocalClassTypes = HandleMap<ClassDefHandle, types::Class*>;
+  using LocalVariableTypes = HandleMap<VariableDefHandle, Type*>;
 
   Library(TypeStore& store, Store& def_store, const SearchPath& search_path,
           StringRegistry& string_registry);
 
+  //  Copies the known types of `base`, which must not yet have been used to check any file, into
+  //  `store`, which must be empty. `string_registry` must be a copy of that of `base`.
+  Library(TypeStore& store, Store& def_store, const SearchPath& search_path,
+          StringRegistry& string_registry, const Library& base);
+
   types::Scalar* make_named_scalar_type(const TypeIdentifier& name);
 
   MT_NODISCARD Optional<Type*> lookup_function(const types::Abstraction& func) const;
@@ -141,8 +150,14 @@ public:
 
   const LocalFunctionTypes& get_local_function_types() const;
 
+  //  Incremented whenever a class is added or gains a supertype, so that cached subtype
+  //  relations can be discarded.
+  int64_t get_class_hierarchy_version() const;
+  void class_hierarchy_changed();
+
 private:
   void make_known_types();
+  void copy_known_types(const Library& base);
   void make_base_type_scope();
 
   void make_builtin_types();
@@ -171,7 +186,27 @@ private:
   void process_scalar_type(types::Scalar* type);
   void add_type_to_base_scope(const TypeIdentifier& ident, Type* type);
 
+  int64_t containing_directory_id(const CodeFileDescriptor* file_descriptor) const;
+  Optional<FunctionSearchCandidate> search_external_function(const MatlabIdentifier& identifier,
+                                                             int64_t directory_id) const;
+
 private:
+  struct ExternalFunctionKey {
+    struct Hash {
+      std::size_t operator()(const ExternalFunctionKey& key) const noexcept;
+    };
+
+    friend bool operator==(const ExternalFunctionKey& a, const ExternalFunctionKey& b) {
+      return a.name == b.name && a.directory_id == b.directory_id;
+    }
+
+    int64_t name;
+    int64_t directory_id;
+  };
+
+  using ExternalFunctionCandidates =
+    std::unordered_map<ExternalFunctionKey, Optional<FunctionSearchCandidate>, ExternalFunctionKey::Hash>;
+
   SubtypeRelation subtype_relation;
   EquivalenceRelation equiv_relation;
   TypeRelation type_eq;
@@ -188,9 +223,16 @@ private:
 
   std::unordered_map<TypeIdentifier, types::Class*, TypeIdentifier::Hash> class_types;
   std::unordered_set<TypeIdentifier, TypeIdentifier::Hash> declared_function_types;
+  int64_t class_hierarchy_version;
 
   const SearchPath& search_path;
 
+  //  Results of searching the search path, by function name and by (interned) directory of the
+  //  file making the reference, so that a repeated search allocates nothing.
+  mutable std::shared_mutex search_mutex;
+  mutable std::unordered_map<const CodeFileDescriptor*, int64_t> directory_ids;
+  mutable ExternalFunctionCandidates external_function_candidates;
+
   TypeIdentifier double_id;
   TypeIdentifier sub_double_id;
   TypeIdentifier char_id;
@@ -2,6 +2,8 @@
 #include "type_store.hpp"
 #include "../fs/code_file.hpp"
 #include "../search_path.hpp"
+#include <algorithm>
+#include <cassert>
 #include <functional>
 
 namespace mt {
@@ -51,15 +53,77 @@ void PendingExternalFunctions::add_pending(const FunctionSearchCandidate& candid
   }
 
   auto& apps = pending_functions.at(candidate);
-  apps.insert(app);
+  if (apps.insert(app)) {
+    mark_ready(candidate);
+  }
 }
 
 void PendingExternalFunctions::add_visited_candidate(const FunctionSearchCandidate& candidate) {
-  visited_candidates.insert(candidate);
+  if (visited_candidates.insert(candidate).second) {
+    unvisited_candidates.push_back(candidate);
+    schedule_stats.max_queue_depth =
+      std::max(schedule_stats.max_queue_depth, int64_t(unvisited_candidates.size()));
+  }
 }
 
 int64_t PendingExternalFunctions::num_pending_candidate_files() const {
   return pending_functions.size();
 }
 
+bool PendingExternalFunctions::has_unvisited_candidates() const {
+  return !unvisited_candidates.empty();
+}
+
+FunctionSearchCandidate PendingExternalFunctions::next_unvisited_candidate() {
+  assert(has_unvisited_candidates());
+  auto candidate = unvisited_candidates.front();
+  unvisited_candidates.pop_front();
+  return candidate;
+}
+
+void PendingExternalFunctions::mark_ready(const FunctionSearchCandidate& candidate) {
+  if (ready_candidate_set.insert(candidate).second) {
+    ready_candidates.push_back(candidate);
+  }
+}
+
+bool PendingExternalFunctions::has_ready_candidates() const {
+  return !ready_candidates.empty();
+}
+
+PendingExternalFunctions::Candidates PendingExternalFunctions::take_ready_candidates() {
+  Candidates result;
+  std::swap(result, ready_candidates);
+  ready_candidate_set.clear();
+  return result;
+}
+
+void PendingExternalFunctions::await_file(const FunctionSearchCandidate& candidate) {
+  awaiting_candidates[candidate.resolved_file->defining_file].push_back(candidate);
+}
+
+void PendingExternalFunctions::mark_file_ready(const FilePath& file_path) {
+  auto it = awaiting_candidates.find(file_path);
+  if (it == awaiting_candidates.end()) {
+    return;
+  }
+
+  for (const auto& candidate : it->second) {
+    mark_ready(candidate);
+  }
+
+  awaiting_candidates.erase(it);
+}
+
+void PendingExternalFunctions::gather_types(std::vector<const Type*>& into) const {
+  for (const auto& resolved : resolved_candidates) {
+    into.push_back(resolved.second);
+  }
+  for (const auto& pending : pending_functions) {
+    for (const auto& func : pending.second) {
+      into.push_back(func.function);
+    }
+  }
+}
+
 }
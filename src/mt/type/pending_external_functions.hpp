@@ -2,9 +2,12 @@
 
 #include "../Optional.hpp"
 #include "../identifier.hpp"
+#include "../fs/path.hpp"
+#include <deque>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace mt {
 
@@ -84,11 +87,63 @@ struct PendingFunction {
   const Token* source_token;
 };
 
+/*
+ * PendingFunctionList
+ *
+ * Functions awaiting the type of a search candidate, in the order in which they were first
+ * requested, so that they are resolved in the same order from run to run.
+ */
+
+class PendingFunctionList {
+public:
+  using Functions = std::vector<PendingFunction>;
+
+  bool insert(const PendingFunction& func) {
+    if (!function_set.insert(func).second) {
+      return false;
+    }
+    functions.push_back(func);
+    return true;
+  }
+
+  void clear() {
+    functions.clear();
+    function_set.clear();
+  }
+
+  bool empty() const {
+    return functions.empty();
+  }
+
+  Functions::const_iterator begin() const {
+    return functions.begin();
+  }
+
+  Functions::const_iterator end() const {
+    return functions.end();
+  }
+
+private:
+  Functions functions;
+  std::unordered_set<PendingFunction, PendingFunction::Hash> function_set;
+};
+
 /*
  * PendingExternalFunctions
+ *
+ * Candidate files are visited in the order in which they are discovered; each is queued only
+ * once. A candidate with pending functions is marked ready when it gains a pending function,
+ * or when its defining file is visited, so that only those candidates are considered when
+ * resolving external functions.
  */
 
 struct PendingExternalFunctions {
+  struct ScheduleStats {
+    int64_t max_queue_depth = 0;
+    int64_t num_rounds = 0;
+    int64_t num_revisits = 0;
+  };
+
   using CandidateHash = FunctionSearchCandidate::Hash;
 
   using VisitedCandidates =
@@ -97,9 +152,9 @@ struct PendingExternalFunctions {
     std::unordered_map<FunctionSearchCandidate, Type*, CandidateHash>;
 
   using PendingFunctions =
-    std::unordered_map<FunctionSearchCandidate,
-                       std::unordered_set<PendingFunction, PendingFunction::Hash>,
-                       CandidateHash>;
+    std::unordered_map<FunctionSearchCandidate, PendingFunctionList, CandidateHash>;
+  using Candidates = std::vector<FunctionSearchCandidate>;
+  using CandidatesByFile = std::unordered_map<FilePath, Candidates, FilePath::Hash>;
 
   bool has_resolved(const FunctionSearchCandidate& candidate) const;
   void add_resolved(const FunctionSearchCandidate& candidate, Type* with_type);
@@ -110,9 +165,29 @@ struct PendingExternalFunctions {
 
   int64_t num_pending_candidate_files() const;
 
+  bool has_unvisited_candidates() const;
+  FunctionSearchCandidate next_unvisited_candidate();
+
+  bool has_ready_candidates() const;
+  Candidates take_ready_candidates();
+  void await_file(const FunctionSearchCandidate& candidate);
+  void mark_file_ready(const FilePath& file_path);
+
+  void gather_types(std::vector<const Type*>& into) const;
+
   VisitedCandidates visited_candidates;
   ResolvedCandidates resolved_candidates;
   PendingFunctions pending_functions;
+
+  std::deque<FunctionSearchCandidate> unvisited_candidates;
+  Candidates ready_candidates;
+  VisitedCandidates ready_candidate_set;
+  CandidatesByFile awaiting_candidates;
+
+  ScheduleStats schedule_stats;
+
+private:
+  void mark_ready(const FunctionSearchCandidate& candidate);
 };
 
 }
\ No newline at end of file
@@ -59,7 +59,7 @@ bool Simplifier::simplify(Type* lhs, Type* rhs, bool rev) {
 }
 
 bool Simplifier::relate(Type* lhs, Type* rhs, bool rev) const {
-  TypeRelation relation{unifier.subtype_relationship, unifier.store};
+  TypeRelation relation{unifier.subtype_relationship, unifier.store, &unifier.relation_cache};
   return relation.related_entry(lhs, rhs, rev);
 }
 
@@ -186,7 +186,7 @@ bool Simplifier::simplify_different_types(const types::Union& union_type, Type*
     return false;
   }
 
-  TypeRelation relation{unifier.subtype_relationship, unifier.store};
+  TypeRelation relation{unifier.subtype_relationship, unifier.store, &unifier.relation_cache};
   const bool success = relation.related_entry(&union_type, rhs, rev);
   check_emplace_simplification_failure(success, &union_type, rhs);
 
@@ -200,7 +200,7 @@ bool Simplifier::simplify_different_types(const DT&, Type* source, Type* rhs, bo
 
 bool Simplifier::simplify_different_types(Type* lhs, Type*, const types::Parameters&,
                                           const types::DestructuredTuple& b, int64_t offset_b, bool) {
-  if (unifier.expanded_parameters.count(lhs) > 0) {
+  if (unifier.lookup_expanded_parameters(lhs)) {
     assert(false);
     return true;
   }
@@ -211,7 +211,7 @@ bool Simplifier::simplify_different_types(Type* lhs, Type*, const types::Paramet
   }
 
   const auto lhs_tup = store.make_rvalue_destructured_tuple(std::move(match_members));
-  unifier.expanded_parameters[lhs] = lhs_tup;
+  unifier.register_expanded_parameters(lhs, lhs_tup);
   return true;
 }
 
@@ -276,13 +276,32 @@ bool Simplifier::simplify(const types::Class& t0, const types::Class& t1, bool r
 }
 
 bool Simplifier::simplify(const types::Record& t0, const types::Record& t1, bool rev) {
-  //  @TODO: Order-independent comparison.
   if (t0.num_fields() != t1.num_fields()) {
     return false;
   }
 
+  bool same_order = true;
+  if (t0.is_fully_indexed() && t1.is_fully_indexed() &&
+      !types::Record::match_fields(t0, t1, &same_order)) {
+    return false;
+  }
+
   const auto num_fields = t0.num_fields();
 
+  if (!same_order) {
+    //  Same field names, declared in a different order, so pair fields by name.
+    for (int64_t i = 0; i < num_fields; i++) {
+      const auto& field0 = t0.fields[t0.field_index[i].index];
+      const auto& field1 = t1.fields[t1.field_index[i].index];
+
+      if (!simplify(field0.type, field1.type, rev)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
   for (int64_t i = 0; i < num_fields; i++) {
     const auto& field0 = t0.fields[i];
     const auto& field1 = t1.fields[i];
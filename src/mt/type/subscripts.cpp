@@ -50,67 +50,86 @@ void SubscriptHandler::maybe_unify_non_function_subscript(Type* source, TermRef
                                                           types::Subscript& sub,
                                                           Type* arg0) {
   assert(!sub.subscripts.empty());
-  const auto& sub0 = sub.subscripts[0];
 
-  if (!unifier.are_concrete_arguments(sub0.arguments)) {
+  if (!unifier.are_concrete_arguments(sub.subscripts[0].arguments)) {
     return;
   }
 
   unifier.register_visited_type(source);
 
+  //  Resolve as many links of a chain like `a.b.c{1}(2)` as possible in one pass, deferring
+  //  the remainder only at the first link that is not yet resolvable.
+  while (true) {
+    const auto next_arg0 = non_function_subscript(source, term, sub.subscripts[0], arg0);
+    if (!next_arg0) {
+      return;
+    }
+
+    if (sub.subscripts.size() == 1) {
+      auto lhs_term = make_term(term.source_token, sub.outputs);
+      auto rhs_term = make_term(term.source_token, next_arg0);
+      unifier.substitution->push_type_equation(make_eq(lhs_term, rhs_term));
+      return;
+    }
+
+    sub.subscripts.erase(sub.subscripts.begin());
+    sub.principal_argument = next_arg0;
+
+    if (!is_resolvable_link(next_arg0, sub.subscripts[0])) {
+      unifier.unregister_visited_type(source);
+
+      auto rhs_term = make_term(term.source_token, unifier.store.make_fresh_type_variable_reference());
+      unifier.substitution->push_type_equation(make_eq(term, rhs_term));
+      return;
+    }
+
+    arg0 = next_arg0;
+  }
+}
+
+Type* SubscriptHandler::non_function_subscript(Type* source, TermRef term,
+                                               const types::Subscript::Sub& sub0,
+                                               Type* arg0) {
   if (has_custom_subsref_method(arg0)) {
     //  @TODO: Custom subsref implementations not yet handled.
     unifier.add_error(unifier.make_unhandled_custom_subscripts_error(term.source_token, arg0));
-    return;
+    return nullptr;
 
   } else if (!are_valid_subscript_arguments(arg0, sub0)) {
     unifier.add_error(make_unresolved_function_error(term.source_token, source));
-    return;
+    return nullptr;
   }
 
-  Type* next_arg0 = nullptr;
-
   if (sub0.is_parens()) {
     if (arg0->is_list() || arg0->is_union()) {
       //  E.g. If `a` == {list<double>}, then `a{1}(1)` is an error.
       unifier.add_error(make_unresolved_function_error(term.source_token, source));
-      return;
+      return nullptr;
     } else {
-      next_arg0 = arg0;
+      return arg0;
     }
 
   } else if (sub0.is_period() && arg0->is_class() && MT_CLASS_PTR(arg0)->source->is_record()) {
     const auto& class_type = MT_CLASS_REF(*arg0);
     const auto& record_type = MT_RECORD_REF(*class_type.source);
-    next_arg0 = record_period_subscript(arg0, term.source_token, sub0, record_type);
+    return record_period_subscript(arg0, term.source_token, sub0, record_type);
 
   } else if (sub0.is_period() && arg0->is_record()) {
-    next_arg0 = record_period_subscript(arg0, term.source_token, sub0, MT_RECORD_REF(*arg0));
+    return record_period_subscript(arg0, term.source_token, sub0, MT_RECORD_REF(*arg0));
 
   } else if (sub0.is_brace() && arg0->is_tuple()) {
-    next_arg0 = tuple_brace_subscript(source, term.source_token, MT_TUPLE_REF(*arg0));
-  }
-
-  if (!next_arg0) {
-    return;
+    return tuple_brace_subscript(source, term.source_token, MT_TUPLE_REF(*arg0));
   }
 
-  auto& store = unifier.store;
-  auto& substitution = unifier.substitution;
-
-  if (sub.subscripts.size() == 1) {
-    auto lhs_term = make_term(term.source_token, sub.outputs);
-    auto rhs_term = make_term(term.source_token, next_arg0);
-    substitution->push_type_equation(make_eq(lhs_term, rhs_term));
-
-  } else {
-    sub.subscripts.erase(sub.subscripts.begin());
-    sub.principal_argument = next_arg0;
-    unifier.unregister_visited_type(source);
+  return nullptr;
+}
 
-    auto rhs_term = make_term(term.source_token, store.make_fresh_type_variable_reference());
-    substitution->push_type_equation(make_eq(term, rhs_term));
-  }
+bool SubscriptHandler::is_resolvable_link(const Type* arg0, const types::Subscript::Sub& sub0) const {
+  //  Function-like principal arguments are dispatched on by `principal_argument_dispatch`, so
+  //  links with those are left to a subsequent pass.
+  return unifier.is_concrete_argument(arg0) &&
+    !arg0->is_alias() && !arg0->is_abstraction() && !arg0->is_scheme() &&
+    unifier.are_concrete_arguments(sub0.arguments);
 }
 
 Type* SubscriptHandler::match_members(const Type* source, const Token* source_token,
@@ -20,6 +20,10 @@ private:
   void maybe_unify_non_function_subscript(Type* source, TermRef term,
                                           types::Subscript& sub,
                                           Type* arg0);
+  Type* non_function_subscript(Type* source, TermRef term,
+                               const types::Subscript::Sub& sub0,
+                               Type* arg0);
+  bool is_resolvable_link(const Type* arg0, const types::Subscript::Sub& sub0) const;
 
   Type* record_period_subscript(Type* record_source,
                                 const Token* source_token,
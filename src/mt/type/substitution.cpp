@@ -1,28 +1,182 @@
 #include "substitution.hpp"
+#include <cassert>
+#include <functional>
 
 namespace mt {
 
+/*
+ * TypeEquationQueue
+ */
+
+std::size_t TypeEquationQueue::KeyHash::operator()(const Key& key) const noexcept {
+  std::size_t hash = 0;
+  auto combine = [&hash](const void* ptr) {
+    const auto ptr_hash = std::hash<const void*>{}(ptr);
+    hash ^= ptr_hash + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  };
+
+  combine(key.lhs_token);
+  combine(key.lhs);
+  combine(key.rhs_token);
+  combine(key.rhs);
+
+  return hash;
+}
+
+TypeEquationQueue::Key TypeEquationQueue::make_key(const TypeEquation& eq) {
+  return Key{eq.lhs.source_token, eq.lhs.term, eq.rhs.source_token, eq.rhs.term};
+}
+
+std::unique_ptr<TypeEquationQueue::Chunk> TypeEquationQueue::make_chunk() {
+  if (spare_chunk) {
+    return std::move(spare_chunk);
+  }
+
+  auto chunk = std::make_unique<Chunk>();
+  chunk->reserve(chunk_capacity);
+  return chunk;
+}
+
+void TypeEquationQueue::enqueue(const TypeEquation& eq) {
+  if (chunks.empty() || int64_t(chunks.back()->size()) == chunk_capacity) {
+    chunks.push_back(make_chunk());
+  }
+
+  chunks.back()->push_back(eq);
+  pending_keys.insert(make_key(eq));
+  size++;
+}
+
+bool TypeEquationQueue::push(const TypeEquation& eq) {
+  if (pending_keys.count(make_key(eq)) > 0) {
+    num.deduplicated++;
+    return false;
+  }
+
+  enqueue(eq);
+  num.enqueued++;
+  return true;
+}
+
+void TypeEquationQueue::restore(const TypeEquation& eq) {
+  if (pending_keys.count(make_key(eq)) == 0) {
+    enqueue(eq);
+  }
+}
+
+TypeEquation TypeEquationQueue::pop() {
+  assert(!empty());
+
+  auto& front = *chunks.front();
+  auto eq = front[head++];
+  pending_keys.erase(make_key(eq));
+  size--;
+  num.retired++;
+
+  if (head == int64_t(front.size()) && (head == chunk_capacity || size == 0)) {
+    //  Every equation in the chunk has been processed.
+    chunks.front()->clear();
+    spare_chunk = std::move(chunks.front());
+    chunks.pop_front();
+    head = 0;
+  }
+
+  return eq;
+}
+
+void TypeEquationQueue::clear() {
+  chunks.clear();
+  pending_keys.clear();
+  head = 0;
+  size = 0;
+}
+
+const TypeEquation& TypeEquationQueue::pending(int64_t index) const {
+  assert(index >= 0 && index < size);
+  const auto offset = head + index;
+  return (*chunks[offset / chunk_capacity])[offset % chunk_capacity];
+}
+
+int64_t TypeEquationQueue::num_pending() const {
+  return size;
+}
+
+bool TypeEquationQueue::empty() const {
+  return size == 0;
+}
+
+const TypeEquationQueue::Counts& TypeEquationQueue::counts() const {
+  return num;
+}
+
+void TypeEquationQueue::add_counts(const Counts& other) {
+  num.enqueued += other.enqueued;
+  num.deduplicated += other.deduplicated;
+  num.retired += other.retired;
+}
+
+/*
+ * Substitution
+ */
+
 int64_t Substitution::num_type_equations() const {
-  return type_equations.size();
+  return type_equations.counts().enqueued;
 }
 
 int64_t Substitution::num_bound_terms() const {
-  return bound_terms.size();
+  return bindings.size();
+}
+
+void Substitution::gather_types(std::vector<const Type*>& into) const {
+  for (const auto& binding : bindings) {
+    into.push_back(binding.lhs.term);
+    into.push_back(binding.rhs.term);
+  }
+  for (int64_t i = 0; i < type_equations.num_pending(); i++) {
+    const auto& eq = type_equations.pending(i);
+    into.push_back(eq.lhs.term);
+    into.push_back(eq.rhs.term);
+  }
+}
+
+const TypeEquationQueue::Counts& Substitution::type_equation_counts() const {
+  return type_equations.counts();
 }
 
 void Substitution::push_type_equation(const TypeEquation& eq) {
-  type_equations.push_back(eq);
+  type_equations.push(eq);
+}
+
+void Substitution::bind(const TypeEquationTerm& variable, const TypeEquationTerm& to_term) {
+  const auto binding_it = binding_indices.find(variable);
+
+  if (binding_it == binding_indices.end()) {
+    binding_indices[variable] = int64_t(bindings.size());
+    bindings.emplace_back(variable, to_term);
+  } else {
+    bindings[binding_it->second].rhs = to_term;
+  }
+}
+
+const TypeEquationTerm* Substitution::lookup_binding(const TypeEquationTerm& variable) const {
+  const auto binding_it = binding_indices.find(variable);
+  if (binding_it == binding_indices.end()) {
+    return nullptr;
+  } else {
+    return &bindings[binding_it->second].rhs;
+  }
 }
 
 Optional<Type*> Substitution::bound_type(Type* for_type) const {
   return bound_type(make_term(nullptr, for_type));
 }
 
-Optional<Type*> Substitution::bound_type(const TypeEquationTerm& for_type) const {
-  if (bound_terms.count(for_type) == 0) {
+Optional<Type*> Substitution::bound_type(const TypeEquationTerm& for_term) const {
+  const auto* maybe_bound = lookup_binding(for_term);
+  if (!maybe_bound) {
     return NullOpt{};
   } else {
-    return Optional<Type*>(bound_terms.at(for_type).term);
+    return Optional<Type*>(maybe_bound->term);
   }
 }
 
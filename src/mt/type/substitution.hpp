@@ -2,28 +2,121 @@
 
 #include "types.hpp"
 #include "../Optional.hpp"
+#include <deque>
+#include <memory>
+#include <unordered_set>
 #include <vector>
 
 namespace mt {
 
-class Substitution {
-  friend class Unifier;
+/*
+ * TypeEquationQueue
+ *
+ * FIFO of pending type equations, stored in fixed-size chunks. A chunk is recycled as soon as
+ * all of its equations have been processed, so memory is bounded by the number of pending
+ * (rather than all) equations. An equation is not enqueued while an identical one is still
+ * pending.
+ */
+
+class TypeEquationQueue {
+public:
+  struct Counts {
+    int64_t enqueued = 0;
+    int64_t deduplicated = 0;
+    int64_t retired = 0;
+  };
+
+  static constexpr int64_t chunk_capacity = 1024;
+
 public:
-  Substitution() : equation_index(0) {
+  TypeEquationQueue() : head(0), size(0) {
     //
   }
 
+  bool push(const TypeEquation& eq);
+  TypeEquation pop();
+
+  //  Re-enqueue an equation that has already been counted as enqueued.
+  void restore(const TypeEquation& eq);
+  //  Discard all pending equations, without counting them as retired.
+  void clear();
+
+  const TypeEquation& pending(int64_t index) const;
+  int64_t num_pending() const;
+  bool empty() const;
+
+  const Counts& counts() const;
+  void add_counts(const Counts& other);
+
+private:
+  using Chunk = std::vector<TypeEquation>;
+  //  Equations are identical if their terms refer to the same types and source tokens; the
+  //  tokens are included so that no error location is lost.
+  struct Key {
+    friend inline bool operator==(const Key& a, const Key& b) {
+      return a.lhs_token == b.lhs_token && a.lhs == b.lhs &&
+        a.rhs_token == b.rhs_token && a.rhs == b.rhs;
+    }
+
+    const Token* lhs_token;
+    const Type* lhs;
+    const Token* rhs_token;
+    const Type* rhs;
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const noexcept;
+  };
+
+  static Key make_key(const TypeEquation& eq);
+  void enqueue(const TypeEquation& eq);
+  std::unique_ptr<Chunk> make_chunk();
+
+private:
+  std::deque<std::unique_ptr<Chunk>> chunks;
+  std::unique_ptr<Chunk> spare_chunk;
+  int64_t head;
+  int64_t size;
+
+  std::unordered_set<Key, KeyHash> pending_keys;
+  Counts num;
+};
+
+/*
+ * Substitution
+ */
+
+class Substitution {
+  friend class Unifier;
+public:
+  //  Bindings are kept in the order in which they were made, so that sweeping
+  //  over them (e.g., to substitute a newly bound variable) is deterministic.
+  using Bindings = std::vector<TypeEquation>;
+  using BindingIndices =
+    std::unordered_map<TypeEquationTerm, int64_t, TypeEquationTerm::TypeHash>;
+
+  Substitution() = default;
+
   int64_t num_type_equations() const;
   int64_t num_bound_terms() const;
+  const TypeEquationQueue::Counts& type_equation_counts() const;
 
   void push_type_equation(const TypeEquation& eq);
   Optional<Type*> bound_type(const TypeEquationTerm& for_term) const;
   Optional<Type*> bound_type(Type* for_type) const;
 
+  //  Types referenced by bindings and pending equations.
+  void gather_types(std::vector<const Type*>& into) const;
+
 private:
-  std::vector<TypeEquation> type_equations;
-  int64_t equation_index;
-  BoundTerms bound_terms;
+  void bind(const TypeEquationTerm& variable, const TypeEquationTerm& to_term);
+  const TypeEquationTerm* lookup_binding(const TypeEquationTerm& variable) const;
+
+private:
+  TypeEquationQueue type_equations;
+
+  Bindings bindings;
+  BindingIndices binding_indices;
 };
 
-}
\ No newline at end of file
+}
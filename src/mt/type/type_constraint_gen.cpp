@@ -18,7 +18,16 @@ TypeConstraintGenerator::TypeConstraintGenerator(Substitution& substitution,
                                                  TypeStore& type_store,
                                                  Library& library,
                                                  StringRegistry& string_registry) :
-substitution(substitution),
+TypeConstraintGenerator(store, type_store, library, string_registry) {
+  //
+  this->substitution = &substitution;
+}
+
+TypeConstraintGenerator::TypeConstraintGenerator(Store& store,
+                                                 TypeStore& type_store,
+                                                 Library& library,
+                                                 StringRegistry& string_registry) :
+substitution(nullptr),
 store(store),
 type_store(type_store),
 library(library),
@@ -29,7 +38,49 @@ string_registry(string_registry) {
   push_monomorphic_functions();
 }
 
+void TypeConstraintGenerator::merge(TypeConstraintGenerator&& other) {
+  assert(substitution && !other.substitution);
+  assert(other.generalization_levels.empty());
+
+  const auto& made_variables = other.pending.made_variables;
+  type_store.assign_identifiers(made_variables.data(), int64_t(made_variables.size()));
+
+  for (const auto& eq : other.pending.type_equations) {
+    push_type_equation(eq);
+  }
+  for (const auto& method : other.pending.methods) {
+    add_method(method.to_class, method.method);
+  }
+  for (const auto& supertype : other.pending.supertypes) {
+    add_supertype(supertype.to_class, supertype.supertype);
+  }
+
+  for (const auto& var_it : other.variable_types) {
+    bind_type_variable_to_variable_def(var_it.first, var_it.second);
+  }
+  for (const auto& func_it : other.function_types) {
+    bind_type_variable_to_function_def(func_it.first, func_it.second);
+  }
+
+  for (auto& warning : other.warnings) {
+    warnings.push_back(std::move(warning));
+  }
+
+  other.pending = PendingOutput();
+  other.warnings.clear();
+}
+
 void TypeConstraintGenerator::root_block(const RootBlock& block) {
+  if (!substitution) {
+    //  Number type variables when merged, in file order, rather than as they are made.
+    TypeStore::defer_identifiers(&pending.made_variables);
+  }
+  MT_SCOPE_EXIT {
+    if (!substitution) {
+      TypeStore::defer_identifiers(nullptr);
+    }
+  };
+
   ScopeState<const MatlabScope>::Helper matlab_scope_helper(scopes, block.scope);
   ScopeState<const TypeScope>::Helper type_scope_helper(type_scopes, block.type_scope);
   BooleanState::Helper ctor_state_helper(struct_is_constructor_state, false);
@@ -43,20 +94,24 @@ void TypeConstraintGenerator::block(const Block& block) {
   }
 }
 
-void TypeConstraintGenerator::show_variable_types(const TypeToString& printer) const {
-  for (const auto& var_it : variable_types) {
-    const auto& def_handle = var_it.first;
-    const auto& maybe_type = substitution.bound_type(make_term(nullptr, var_it.second));
-    const auto& type = maybe_type ? maybe_type.value() : var_it.second;
+void TypeConstraintGenerator::show_variable_types(const TypeToString& printer,
+                                                 int num_threads) const {
+  std::vector<std::string> names;
+  std::vector<const Type*> types;
 
-    std::string name;
+  store.use<Store::ReadConst>([&](const auto& reader) {
+    for (const auto& var_it : variable_types) {
+      const auto& def = reader.at(var_it.first);
+      const auto& maybe_type = substitution->bound_type(make_term(nullptr, var_it.second));
 
-    store.use<Store::ReadConst>([&](const auto& reader) {
-      const auto& def = reader.at(def_handle);
-      name = string_registry.at(def.name.full_name());
-    });
+      names.push_back(string_registry.at(def.name.full_name()));
+      types.push_back(maybe_type ? maybe_type.value() : var_it.second);
+    }
+  });
 
-    std::cout << name << ": " << printer.apply(type) << std::endl;
+  const auto type_strs = printer.apply(types, num_threads);
+  for (int64_t i = 0; i < int64_t(names.size()); i++) {
+    std::cout << names[i] << ": " << type_strs[i] << std::endl;
   }
 }
 
@@ -138,41 +193,32 @@ void TypeConstraintGenerator::function_def_node(const FunctionDefNode& node) {
   const auto& scope = *scopes.current();
 
   if (are_functions_polymorphic() || scheme) {
-    push_constraint_repository();
+    enter_generalization_level();
   }
 
   store.use<Store::ReadConst>([&](const auto& reader) {
     const auto& def = reader.at(node.def_handle);
     function_name = def.header.name;
-    const auto& source_tok = node.source_token;
-
-    push_function_parameters(scope, function_inputs, def.header.inputs, source_tok);
-    push_function_parameters(scope, function_outputs, def.header.outputs, source_tok);
-
     function_body = def.body.get();
     function_attrs = def.attributes;
+
+    if (function_body) {
+      //  A deferred body introduces its parameters when it is parsed.
+      const auto& source_tok = node.source_token;
+      push_function_parameters(scope, function_inputs, def.header.inputs, source_tok);
+      push_function_parameters(scope, function_outputs, def.header.outputs, source_tok);
+    }
   });
 
   if (function_body) {
-    //  Push a null handle to indicate that we're no longer directly inside a class.
-    ClassDefState::Helper enclosing_class(class_state, ClassDefHandle{},
-                                          nullptr, MatlabIdentifier());
-    push_monomorphic_functions();
-    function_body->accept_const(*this);
-    pop_generic_function_state();
+    function_def_body(*function_body);
   }
 
   const auto func_var = require_bound_type_variable(node.def_handle);
 
   if (are_functions_polymorphic() || scheme) {
     assert(scheme);
-    auto current_constraints = std::move(current_constraint_repository());
-    pop_constraint_repository();
-
-    scheme->constraints.insert(scheme->constraints.end(),
-      current_constraints.constraints.begin(), current_constraints.constraints.end());
-    scheme->parameters.insert(scheme->parameters.end(),
-      current_constraints.variables.begin(), current_constraints.variables.end());
+    generalize(*scheme);
   }
 
   const auto lhs_term = make_term(&node.source_token, func_var);
@@ -192,6 +238,49 @@ void TypeConstraintGenerator::function_def_node(const FunctionDefNode& node) {
   push_type_equation_term(rhs_term);
 }
 
+void TypeConstraintGenerator::function_def_body(const Block& body) {
+  //  Push a null handle to indicate that we're no longer directly inside a class.
+  ClassDefState::Helper enclosing_class(class_state, ClassDefHandle{},
+                                        nullptr, MatlabIdentifier());
+  push_monomorphic_functions();
+  body.accept_const(*this);
+  pop_generic_function_state();
+}
+
+void TypeConstraintGenerator::deferred_function_def_body(const MatlabScope* root_scope,
+                                                         const TypeScope* root_type_scope,
+                                                         const FunctionDefNode& node) {
+  ScopeState<const MatlabScope>::Helper root_scope_helper(scopes, root_scope);
+  ScopeState<const TypeScope>::Helper root_type_scope_helper(type_scopes, root_type_scope);
+  BooleanState::Helper ctor_state_helper(struct_is_constructor_state, false);
+
+  ScopeState<const MatlabScope>::Helper matlab_scope_helper(scopes, node.scope);
+  ScopeState<const TypeScope>::Helper type_scope_helper(type_scopes, node.type_scope);
+
+  //  Only functions with a (non-generic) function type annotation are deferred.
+  const auto maybe_type = library.lookup_local_function(node.def_handle);
+  assert(maybe_type && maybe_type.value()->is_abstraction());
+  const auto& abstr = MT_ABSTR_REF(*maybe_type.value());
+  const auto& function_inputs = MT_DT_REF(*abstr.inputs).members;
+  const auto& function_outputs = MT_DT_REF(*abstr.outputs).members;
+
+  const Block* function_body = nullptr;
+  const auto& scope = *scopes.current();
+
+  store.use<Store::ReadConst>([&](const auto& reader) {
+    const auto& def = reader.at(node.def_handle);
+    const auto& source_tok = node.source_token;
+
+    push_function_parameters(scope, function_inputs, def.header.inputs, source_tok);
+    push_function_parameters(scope, function_outputs, def.header.outputs, source_tok);
+
+    function_body = def.body.get();
+  });
+
+  assert(function_body);
+  function_def_body(*function_body);
+}
+
 void TypeConstraintGenerator::handle_class_method(const TypePtrs& function_inputs,
                                                   const TypePtrs& function_outputs,
                                                   const FunctionAttributes& function_attrs,
@@ -233,7 +322,7 @@ void TypeConstraintGenerator::handle_class_method(const TypePtrs& function_input
     auto bin_term = make_term(rhs_term.source_token, bin_op);
     push_type_equation(make_eq(bin_term, rhs_term));
 
-    library.method_store.add_method(class_type, MT_ABSTR_REF(*bin_op), bin_op);
+    add_method(class_type, bin_op);
 
     if (represents_relation(maybe_binary_op.value()) && !function_outputs.empty()) {
       auto maybe_logical = library.get_logical_type();
@@ -251,7 +340,7 @@ void TypeConstraintGenerator::handle_class_method(const TypePtrs& function_input
     auto un_term = make_term(rhs_term.source_token, un_op);
     push_type_equation(make_eq(un_term, rhs_term));
 
-    library.method_store.add_method(class_type, MT_ABSTR_REF(*un_op), un_op);
+    add_method(class_type, un_op);
   }
 }
 
@@ -282,7 +371,7 @@ void TypeConstraintGenerator::class_def_node(const ClassDefNode& node) {
     const auto maybe_superclass = library.lookup_local_class(superclass.def_handle);
     assert(maybe_superclass);
     auto* superclass_type = maybe_superclass.value();
-    class_type->supertypes.push_back(superclass_type);
+    add_supertype(class_type, superclass_type);
   }
 
   for (const auto& prop : node.properties) {
@@ -468,7 +557,7 @@ void TypeConstraintGenerator::struct_as_constructor(const FunctionCallExpr& expr
       }
 
       types::Record::Field field{field_name, field_type};
-      record_type->fields.push_back(field);
+      record_type->add_field(field);
 
       field_name = nullptr;
       expect_char = true;
@@ -586,9 +675,8 @@ void TypeConstraintGenerator::anonymous_function_expr(const AnonymousFunctionExp
   ScopeState<const MatlabScope>::Helper scope_helper(scopes, expr.scope);
   ScopeState<const TypeScope>::Helper type_scope_helper(type_scopes, expr.type_scope);
 
-  //  Store constraints here.
   if (are_functions_polymorphic()) {
-    push_constraint_repository();
+    enter_generalization_level();
   }
 
   TypePtrs function_inputs;
@@ -609,15 +697,9 @@ void TypeConstraintGenerator::anonymous_function_expr(const AnonymousFunctionExp
   push_type_equation(make_eq(rhs_body_term, output_term));
 
   if (are_functions_polymorphic()) {
-    auto stored_constraints = std::move(current_constraint_repository());
-    pop_constraint_repository();
-
     const auto func_scheme = type_store.make_scheme(func, TypePtrs{});
     const auto func_scheme_term = make_term(&expr.source_token, func_scheme);
-
-    auto& scheme = MT_SCHEME_MUT_REF(*func_scheme);
-    scheme.constraints = std::move(stored_constraints.constraints);
-    scheme.parameters = std::move(stored_constraints.variables);
+    generalize(MT_SCHEME_MUT_REF(*func_scheme));
 
     push_type_equation_term(func_scheme_term);
 
@@ -1016,8 +1098,8 @@ TypeEquationTerm TypeConstraintGenerator::visit_expr(const BoxedExpr& expr, cons
 
 Type* TypeConstraintGenerator::make_fresh_type_variable_reference() {
   auto var_handle = type_store.make_fresh_type_variable_reference();
-  if (!constraint_repositories.empty()) {
-    constraint_repositories.back().variables.push_back(var_handle);
+  if (!generalization_levels.empty()) {
+    generalizable_variables.push_back(var_handle);
   }
   return var_handle;
 }
@@ -1075,11 +1157,32 @@ Type* TypeConstraintGenerator::require_bound_type_variable(const FunctionDefHand
 }
 
 void TypeConstraintGenerator::push_type_equation(const TypeEquation& eq) {
-  if (constraint_repositories.empty()) {
-    substitution.push_type_equation(eq);
+  if (substitution) {
+    substitution->push_type_equation(eq);
   } else {
-    substitution.push_type_equation(eq);
-    constraint_repositories.back().constraints.push_back(eq);
+    pending.type_equations.push_back(eq);
+  }
+
+  if (!generalization_levels.empty()) {
+    generalizable_constraints.push_back(eq);
+  }
+}
+
+void TypeConstraintGenerator::add_method(const types::Class* to_class,
+                                         types::Abstraction* method) {
+  if (substitution) {
+    library.method_store.add_method(to_class, *method, method);
+  } else {
+    pending.methods.push_back(PendingOutput::Method{to_class, method});
+  }
+}
+
+void TypeConstraintGenerator::add_supertype(types::Class* to_class, types::Class* supertype) {
+  if (substitution) {
+    to_class->supertypes.push_back(supertype);
+    library.class_hierarchy_changed();
+  } else {
+    pending.supertypes.push_back(PendingOutput::Supertype{to_class, supertype});
   }
 }
 
@@ -1099,18 +1202,28 @@ bool TypeConstraintGenerator::are_functions_polymorphic() const {
   return polymorphic_function_state.value();
 }
 
-void TypeConstraintGenerator::push_constraint_repository() {
-  constraint_repositories.emplace_back();
+void TypeConstraintGenerator::enter_generalization_level() {
+  generalization_levels.push_back(GeneralizationLevel{
+    int64_t(generalizable_variables.size()), int64_t(generalizable_constraints.size())
+  });
 }
 
-TypeConstraintGenerator::ConstraintRepository& TypeConstraintGenerator::current_constraint_repository() {
-  assert(!constraint_repositories.empty());
-  return constraint_repositories.back();
-}
+void TypeConstraintGenerator::generalize(types::Scheme& scheme) {
+  assert(!generalization_levels.empty() && "No level to generalize.");
+  const auto level = generalization_levels.back();
+  generalization_levels.pop_back();
+
+  //  Variables and constraints of the innermost level are moved into the scheme; those of
+  //  enclosing levels precede them, and are unaffected.
+  const auto variables_begin = generalizable_variables.begin() + level.first_variable;
+  const auto constraints_begin = generalizable_constraints.begin() + level.first_constraint;
+
+  scheme.parameters.insert(scheme.parameters.end(), variables_begin, generalizable_variables.end());
+  scheme.constraints.insert(scheme.constraints.end(),
+    std::make_move_iterator(constraints_begin), std::make_move_iterator(generalizable_constraints.end()));
 
-void TypeConstraintGenerator::pop_constraint_repository() {
-  assert(!constraint_repositories.empty() && "No constraints to pop.");
-  constraint_repositories.pop_back();
+  generalizable_variables.erase(variables_begin, generalizable_variables.end());
+  generalizable_constraints.erase(constraints_begin, generalizable_constraints.end());
 }
 
 bool TypeConstraintGenerator::struct_is_constructor() const {
@@ -6,6 +6,7 @@
 #include "library.hpp"
 #include "../ast.hpp"
 #include "../store.hpp"
+#include "../handle_map.hpp"
 #include "../ast/visitor.hpp"
 #include "../traversal.hpp"
 #include <cassert>
@@ -19,16 +20,45 @@ class TypeToString;
 
 class TypeConstraintGenerator : public TypePreservingVisitor {
 private:
-  struct ConstraintRepository {
-    std::vector<Type*> variables;
-    std::vector<TypeEquation> constraints;
+  //  Variables and constraints introduced within a (possibly nested) polymorphic function
+  //  are those at or beyond the function's offsets into the generalizable sets.
+  struct GeneralizationLevel {
+    int64_t first_variable;
+    int64_t first_constraint;
+  };
+
+  //  Output of a generator without a substitution, held back until it is merged.
+  struct PendingOutput {
+    struct Method {
+      const types::Class* to_class;
+      types::Abstraction* method;
+    };
+
+    struct Supertype {
+      types::Class* to_class;
+      types::Class* supertype;
+    };
+
+    std::vector<TypeEquation> type_equations;
+    std::vector<Method> methods;
+    std::vector<Supertype> supertypes;
+    //  Type variables and parameters made by the generator, in the order in which they were made.
+    std::vector<Type*> made_variables;
   };
 
 public:
   TypeConstraintGenerator(Substitution& substitution, Store& store, TypeStore& type_store,
                           Library& library, StringRegistry& string_registry);
+  //  Generates constraints without modifying the library, such that generators for different
+  //  files can run concurrently; see `merge`.
+  TypeConstraintGenerator(Store& store, TypeStore& type_store,
+                          Library& library, StringRegistry& string_registry);
+
+  //  Apply the constraints, library registrations, bound variables and warnings of a generator
+  //  made without a substitution, as if this generator had visited the same nodes.
+  void merge(TypeConstraintGenerator&& other);
 
-  void show_variable_types(const TypeToString& printer) const;
+  void show_variable_types(const TypeToString& printer, int num_threads = 1) const;
 
   void root_block(const RootBlock& block) override;
   void block(const Block& block) override;
@@ -62,6 +92,10 @@ public:
   void parens_grouping_expr_rhs(const GroupingExpr& expr);
 
   void function_def_node(const FunctionDefNode& node) override;
+  //  Generate constraints for the body of a top-level function parsed after the rest of its
+  //  file, whose header constraints have already been generated.
+  void deferred_function_def_body(const MatlabScope* root_scope, const TypeScope* root_type_scope,
+                                  const FunctionDefNode& node);
   void class_def_node(const ClassDefNode& node) override;
   void method_node(const MethodNode& node) override;
 
@@ -94,6 +128,7 @@ private:
   void push_function_parameters(const MatlabScope& scope, const TypePtrs& args,
                                 const FunctionParameters& params, const Token& source_token);
 
+  void function_def_body(const Block& body);
   void handle_class_method(const TypePtrs& function_inputs,
                            const TypePtrs& function_outputs,
                            const FunctionAttributes& function_attrs,
@@ -111,15 +146,16 @@ private:
   Optional<Type*> lookup_bound_type_variable(const VariableDefHandle& handle);
 
   void push_type_equation(const TypeEquation& eq);
+  void add_method(const types::Class* to_class, types::Abstraction* method);
+  void add_supertype(types::Class* to_class, types::Class* supertype);
 
   void push_monomorphic_functions();
   void push_polymorphic_functions();
   void pop_generic_function_state();
   bool are_functions_polymorphic() const;
 
-  void push_constraint_repository();
-  ConstraintRepository& current_constraint_repository();
-  void pop_constraint_repository();
+  void enter_generalization_level();
+  void generalize(types::Scheme& scheme);
 
   void push_type_equation_term(const TypeEquationTerm& term);
   TypeEquationTerm pop_type_equation_term();
@@ -128,7 +164,9 @@ private:
   void struct_as_constructor(const FunctionCallExpr& expr);
 
 private:
-  Substitution& substitution;
+  //  Null if the generator's output is pending.
+  Substitution* substitution;
+  PendingOutput pending;
 
   Store& store;
   TypeStore& type_store;
@@ -144,12 +182,15 @@ private:
   BooleanState polymorphic_function_state;
   BooleanState struct_is_constructor_state;
 
-  std::unordered_map<VariableDefHandle, Type*, VariableDefHandle::Hash> variable_types;
-  std::unordered_map<FunctionDefHandle, Type*, FunctionDefHandle::Hash> function_types;
+  HandleMap<VariableDefHandle, Type*> variable_types;
+  HandleMap<FunctionDefHandle, Type*> function_types;
+  //  Few variables are guarded at once.
   std::unordered_map<VariableDefHandle, Type*, VariableDefHandle::Hash> isa_guarded_types;
 
   std::vector<TypeEquationTerm> type_eq_terms;
-  std::vector<ConstraintRepository> constraint_repositories;
+  std::vector<GeneralizationLevel> generalization_levels;
+  std::vector<Type*> generalizable_variables;
+  std::vector<TypeEquation> generalizable_constraints;
 
   std::vector<BoxedTypeError> warnings;
 };
@@ -208,6 +208,33 @@ void TypeIdentifierResolverInstance::PendingScheme::instantiate(TypeStore& store
   target->source = instantiation.instantiate(*scheme, instance_vars);
 }
 
+/*
+ * TypeIdentifierResolutionOrder
+ */
+
+TypeIdentifierResolutionOrder::TypeIdentifierResolutionOrder(int64_t num_files) :
+resolved(num_files, false), num_leading_resolved(0) {
+  //
+}
+
+void TypeIdentifierResolutionOrder::wait_for_preceding_files(int64_t file_index) const {
+  std::unique_lock<std::mutex> lock(mutex);
+  resolved_condition.wait(lock, [&]() {
+    return num_leading_resolved >= file_index;
+  });
+}
+
+void TypeIdentifierResolutionOrder::mark_resolved(int64_t file_index) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    resolved[file_index] = true;
+    while (num_leading_resolved < int64_t(resolved.size()) && resolved[num_leading_resolved]) {
+      num_leading_resolved++;
+    }
+  }
+  resolved_condition.notify_all();
+}
+
 /*
  * TypeIdentifierResolverInstance
  */
@@ -218,10 +245,78 @@ TypeIdentifierResolverInstance::TypeIdentifierResolverInstance(TypeStore& type_s
                                                                const StringRegistry& string_registry,
                                                                const TokenSourceMap& source_map) :
 type_store(type_store), library(library), def_store(def_store), string_registry(string_registry),
-source_map(source_map) {
+source_map(source_map), order(nullptr), file_index(0) {
   //
 }
 
+void TypeIdentifierResolverInstance::resolve_concurrently(TypeIdentifierResolutionOrder* in_order,
+                                                          int64_t index) {
+  order = in_order;
+  file_index = index;
+}
+
+void TypeIdentifierResolverInstance::register_local_types() {
+  for (const auto& func_it : local_function_types) {
+    library.emplace_local_function_type(func_it.first, func_it.second);
+  }
+  for (const auto& var_it : local_variable_types) {
+    library.emplace_local_variable_type(var_it.first, var_it.second);
+  }
+
+  local_function_types = {};
+  local_variable_types = {};
+  order = nullptr;
+}
+
+void TypeIdentifierResolverInstance::wait_for_preceding_files() const {
+  if (order) {
+    order->wait_for_preceding_files(file_index);
+  }
+}
+
+Type* TypeIdentifierResolverInstance::require_local_variable_type(const VariableDefHandle& handle) {
+  if (!order) {
+    return library.require_local_variable_type(handle);
+  }
+
+  auto it = local_variable_types.find(handle);
+  if (it == local_variable_types.end()) {
+    auto var = type_store.make_fresh_type_variable_reference();
+    local_variable_types[handle] = var;
+    return var;
+  } else {
+    return it->second;
+  }
+}
+
+void TypeIdentifierResolverInstance::emplace_local_variable_type(const VariableDefHandle& handle,
+                                                                 Type* type) {
+  if (order) {
+    local_variable_types[handle] = type;
+  } else {
+    library.emplace_local_variable_type(handle, type);
+  }
+}
+
+void TypeIdentifierResolverInstance::emplace_local_function_type(const FunctionDefHandle& handle,
+                                                                 Type* type) {
+  if (order) {
+    assert(local_function_types.count(handle) == 0);
+    local_function_types[handle] = type;
+  } else {
+    library.emplace_local_function_type(handle, type);
+  }
+}
+
+Optional<Type*> TypeIdentifierResolverInstance::lookup_local_function(const FunctionDefHandle& handle) const {
+  const auto func_it = local_function_types.find(handle);
+  if (func_it != local_function_types.end()) {
+    return Optional<Type*>(func_it->second);
+  } else {
+    return library.lookup_local_function(handle);
+  }
+}
+
 void TypeIdentifierResolverInstance::add_error(const ParseError& err) {
   errors.push_back(err);
 }
@@ -563,7 +658,7 @@ void TypeIdentifierResolver::record_type_node(RecordTypeNode& node) {
     auto field_name = instance->type_store.make_constant_value(field.name);
     auto field_type = maybe_field_type.value();
 
-    node.type->fields.push_back(types::Record::Field{field_name, field_type});
+    node.type->add_field(types::Record::Field{field_name, field_type});
   }
 
   instance->collectors.current().push(node.type);
@@ -589,6 +684,8 @@ void TypeIdentifierResolver::scalar_type_declaration(DeclareTypeNode& node) {
 }
 
 void TypeIdentifierResolver::method_type_declaration(DeclareTypeNode& node) {
+  instance->wait_for_preceding_files();
+
   auto& library = instance->library;
   auto& method_store = library.method_store;
 
@@ -639,6 +736,7 @@ void TypeIdentifierResolver::declare_function_type_node(DeclareFunctionTypeNode&
   auto& abstr = MT_ABSTR_MUT_REF(*type->scheme_source());
   abstr.assign_kind(to_matlab_identifier(node.identifier));
 
+  instance->wait_for_preceding_files();
   bool success = instance->library.emplace_declared_function_type(abstr, type);
   if (!success) {
     instance->add_error(make_error_duplicate_function(*instance, node.source_token));
@@ -669,7 +767,7 @@ void TypeIdentifierResolver::namespace_type_node(NamespaceTypeNode& node) {
  */
 
 namespace {
-  void gather_function_parameters(const TypeIdentifierResolverInstance& instance,
+  void gather_function_parameters(TypeIdentifierResolverInstance& instance,
                                   const FunctionParameters& params,
                                   TypePtrs& current_types,
                                   TypePtrs& all_types) {
@@ -678,14 +776,14 @@ namespace {
     for (const auto& arg : params) {
       auto tvar = (arg.is_ignored() || arg.is_part_of_decl()) ?
         instance.type_store.make_fresh_type_variable_reference() :
-        instance.library.require_local_variable_type(matlab_scope.local_variables.at(arg.name));
+        instance.require_local_variable_type(matlab_scope.local_variables.at(arg.name));
 
       current_types.push_back(tvar);
       all_types.push_back(tvar);
     }
   }
 
-  void emplace_function_parameters(const TypeIdentifierResolverInstance& instance,
+  void emplace_function_parameters(TypeIdentifierResolverInstance& instance,
                                    const FunctionParameters& params,
                                    const TypePtrs& args) {
     const auto& matlab_scope = *instance.matlab_scopes.current();
@@ -696,7 +794,7 @@ namespace {
       const auto& param = params[i];
       if (!param.is_ignored() && !param.is_part_of_decl()) {
         const auto var_handle = matlab_scope.local_variables.at(param.name);
-        instance.library.emplace_local_variable_type(var_handle, args[i]);
+        instance.emplace_local_variable_type(var_handle, args[i]);
       }
     }
   }
@@ -792,27 +890,58 @@ void TypeIdentifierResolver::function_def_node(FunctionDefNode& node) {
     return;
   }
 
-  instance->library.emplace_local_function_type(node.def_handle, emplaced_type);
+  instance->emplace_local_function_type(node.def_handle, emplaced_type);
   Block* body = instance->def_store.get_block(node.def_handle);
 
   if (body) {
-    instance->collectors.push();
-    //  Push monomorphic functions.
-    instance->polymorphic_function_state.push(emplaced_type->is_scheme());
-    instance->push_presumed_type(nullptr);
-
-    MT_SCOPE_EXIT {
-      instance->collectors.pop();
-      instance->polymorphic_function_state.pop();
-      instance->pop_presumed_type();
-    };
-
-    body->accept(*this);
+    function_def_body(*body, emplaced_type->is_scheme());
   }
 
   instance->collectors.current().push(emplaced_type);
 }
 
+void TypeIdentifierResolver::function_def_body(Block& body, bool is_polymorphic) {
+  instance->collectors.push();
+  instance->polymorphic_function_state.push(is_polymorphic);
+  instance->push_presumed_type(nullptr);
+
+  MT_SCOPE_EXIT {
+    instance->collectors.pop();
+    instance->polymorphic_function_state.pop();
+    instance->pop_presumed_type();
+  };
+
+  body.accept(*this);
+}
+
+void TypeIdentifierResolver::deferred_function_def_body(MatlabScope* root_scope,
+                                                        TypeScope* root_type_scope,
+                                                        FunctionDefNode& node) {
+  instance->scopes.push(root_type_scope);
+  instance->matlab_scopes.push(root_scope);
+  instance->collectors.push();
+  //  Push monomorphic functions.
+  instance->polymorphic_function_state.push(false);
+
+  instance->matlab_scopes.push(node.scope);
+  instance->scopes.push(node.type_scope);
+
+  MT_SCOPE_EXIT {
+    instance->scopes.pop();
+    instance->matlab_scopes.pop();
+    instance->scopes.pop();
+    instance->matlab_scopes.pop();
+    instance->collectors.pop();
+    instance->polymorphic_function_state.pop();
+  };
+
+  const auto maybe_type = instance->lookup_local_function(node.def_handle);
+  Block* body = instance->def_store.get_block(node.def_handle);
+  assert(maybe_type && body);
+
+  function_def_body(*body, maybe_type.value()->is_scheme());
+}
+
 void TypeIdentifierResolver::property_node(PropertyNode& node) {
   Type* prop_type = nullptr;
 
@@ -877,6 +1006,7 @@ void TypeIdentifierResolver::class_def_node(ClassDefNode& node) {
   assert(!class_type->source);
 
   //  Register type with library.
+  instance->wait_for_preceding_files();
   bool register_success =
     instance->library.emplace_local_class_type(node.handle, class_type);
 
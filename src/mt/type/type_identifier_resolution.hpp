@@ -5,6 +5,10 @@
 #include "../identifier.hpp"
 #include "../error.hpp"
 #include "../source_data.hpp"
+#include "../handles.hpp"
+#include "../handle_map.hpp"
+#include <condition_variable>
+#include <mutex>
 #include <vector>
 
 namespace mt {
@@ -23,6 +27,31 @@ namespace types {
   struct Alias;
 }
 
+/*
+ * TypeIdentifierResolutionOrder
+ *
+ * Orders a batch of files whose type identifiers are resolved concurrently. Whether a class or
+ * declared function can be registered by name depends on the registrations of other files, so a
+ * file makes (or looks up) such a registration only once every preceding file is resolved. The
+ * result is then the same as if the files had been resolved one after another. Files must be
+ * started in order, so that a waiting file never waits on a file that has not started.
+ */
+
+class TypeIdentifierResolutionOrder {
+public:
+  explicit TypeIdentifierResolutionOrder(int64_t num_files);
+
+  void wait_for_preceding_files(int64_t file_index) const;
+  void mark_resolved(int64_t file_index);
+
+private:
+  std::vector<bool> resolved;
+  int64_t num_leading_resolved;
+
+  mutable std::mutex mutex;
+  mutable std::condition_variable resolved_condition;
+};
+
 class TypeIdentifierResolverInstance {
 public:
   friend class TypeIdentifierResolver;
@@ -89,6 +118,18 @@ public:
 
   void push_pending_scheme(PendingScheme&& pending_scheme);
 
+  //  Resolve this instance's file concurrently with the other files of `order`. The types of
+  //  local functions and variables are then kept by the instance, rather than registered with
+  //  the library, until `register_local_types` is called.
+  void resolve_concurrently(TypeIdentifierResolutionOrder* order, int64_t file_index);
+  void register_local_types();
+  void wait_for_preceding_files() const;
+
+  Type* require_local_variable_type(const VariableDefHandle& handle);
+  void emplace_local_variable_type(const VariableDefHandle& handle, Type* type);
+  void emplace_local_function_type(const FunctionDefHandle& handle, Type* type);
+  Optional<Type*> lookup_local_function(const FunctionDefHandle& handle) const;
+
 public:
   TypeStore& type_store;
   Library& library;
@@ -109,6 +150,14 @@ public:
   std::vector<SchemeVariables> scheme_variables;
   std::vector<types::Scheme*> enclosing_schemes;
   std::vector<Type*> presumed_types;
+
+  //  Null unless resolving concurrently.
+  TypeIdentifierResolutionOrder* order;
+  int64_t file_index;
+  HandleMap<FunctionDefHandle, Type*> local_function_types;
+  HandleMap<VariableDefHandle, Type*> local_variable_types;
+  //  Type variables and parameters made while resolving, numbered once every file is resolved.
+  std::vector<Type*> made_variables;
 };
 
 class TypeIdentifierResolver : public TypePreservingVisitor {
@@ -151,7 +200,13 @@ public:
   void switch_stmt(SwitchStmt& stmt) override;
   void if_branch(IfBranch& branch);
 
+  //  Resolve type identifiers in the body of a top-level function parsed after the rest of its
+  //  file, whose header has already been resolved.
+  void deferred_function_def_body(MatlabScope* root_scope, TypeScope* root_type_scope,
+                                  FunctionDefNode& node);
+
 private:
+  void function_def_body(Block& body, bool is_polymorphic);
   void add_unresolved_identifier(const Token& source_token, const TypeIdentifier& ident);
 
   void scalar_type_declaration(DeclareTypeNode& node);
@@ -35,6 +35,136 @@ public:
   const TypeRelation& relation;
 };
 
+/*
+ * TypeRelationCache
+ */
+
+std::size_t TypeRelationCache::Key::Hash::operator()(const Key& key) const noexcept {
+  auto hash = std::hash<const void*>{}(key.relationship);
+  hash ^= std::hash<const Type*>{}(key.a) + 0x9e3779b9u + (hash << 6u) + (hash >> 2u);
+  hash ^= std::hash<const Type*>{}(key.b) + 0x9e3779b9u + (hash << 6u) + (hash >> 2u);
+  return hash ^ std::size_t(key.rev);
+}
+
+Optional<bool> TypeRelationCache::lookup(const TypeRelationship* relationship,
+                                         const Type* a, const Type* b, bool rev) {
+  const auto it = results.find(Key{relationship, a, b, rev});
+  if (it == results.end()) {
+    stats.misses++;
+    return NullOpt{};
+  } else {
+    stats.hits++;
+    return Optional<bool>(it->second);
+  }
+}
+
+void TypeRelationCache::insert(const TypeRelationship* relationship,
+                               const Type* a, const Type* b, bool rev, bool related) {
+  results[Key{relationship, a, b, rev}] = related;
+}
+
+void TypeRelationCache::require_version(const Version& to_version) {
+  if (!(version == to_version)) {
+    if (!results.empty()) {
+      stats.invalidations++;
+    }
+    results.clear();
+    version = to_version;
+  }
+}
+
+void TypeRelationCache::add_stats(const Stats& other) {
+  stats.hits += other.hits;
+  stats.misses += other.misses;
+  stats.invalidations += other.invalidations;
+}
+
+const TypeRelationCache::Stats& TypeRelationCache::get_stats() const {
+  return stats;
+}
+
+bool TypeRelationCache::is_cacheable(const Type* type) {
+  //  Small types free of variables (and of types that are rewritten as they are unified). A
+  //  class is related by name alone, so its source is not visited.
+  constexpr int64_t max_num_visited = 64;
+  const Type* pending[max_num_visited];
+  int64_t num_pending = 0;
+  int64_t num_visited = 0;
+
+  auto push = [&](const Type* t) {
+    if (num_pending == max_num_visited || ++num_visited > max_num_visited) {
+      return false;
+    }
+    pending[num_pending++] = t;
+    return true;
+  };
+
+  auto push_all = [&](const TypePtrs& types) {
+    for (const auto* t : types) {
+      if (!push(t)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  if (!push(type)) {
+    return false;
+  }
+
+  while (num_pending > 0) {
+    const auto* next = pending[--num_pending];
+    bool proceed = true;
+
+    switch (next->tag) {
+      case Type::Tag::scalar:
+      case Type::Tag::constant_value:
+      case Type::Tag::class_type:
+        break;
+      case Type::Tag::tuple:
+        proceed = push_all(MT_TUPLE_REF(*next).members);
+        break;
+      case Type::Tag::union_type:
+        proceed = push_all(MT_UNION_REF(*next).members);
+        break;
+      case Type::Tag::destructured_tuple:
+        proceed = push_all(MT_DT_REF(*next).members);
+        break;
+      case Type::Tag::list:
+        proceed = push_all(MT_LIST_REF(*next).pattern);
+        break;
+      case Type::Tag::abstraction: {
+        const auto& abstr = MT_ABSTR_REF(*next);
+        proceed = push(abstr.inputs) && push(abstr.outputs);
+        break;
+      }
+      case Type::Tag::record:
+        for (const auto& field : MT_RECORD_REF(*next).fields) {
+          if (!push(field.name) || !push(field.type)) {
+            proceed = false;
+            break;
+          }
+        }
+        break;
+      case Type::Tag::alias:
+        proceed = push(MT_ALIAS_REF(*next).source);
+        break;
+      default:
+        proceed = false;
+    }
+
+    if (!proceed) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*
+ * TypeRelation
+ */
+
 DebugTypePrinter TypeRelation::type_printer() const {
   return DebugTypePrinter();
 }
@@ -57,7 +187,17 @@ bool TypeRelation::related_element_wise(const TypePtrs& a, const int64_t num_a,
 }
 
 bool TypeRelation::related_entry(const Type* a, const Type* b, bool rev) const {
-  return related(a, b, rev);
+  if (!cache || !TypeRelationCache::is_cacheable(a) || !TypeRelationCache::is_cacheable(b)) {
+    return related(a, b, rev);
+  }
+
+  if (const auto maybe_related = cache->lookup(&relationship, a, b, rev)) {
+    return maybe_related.value();
+  }
+
+  const bool result = related(a, b, rev);
+  cache->insert(&relationship, a, b, rev, result);
+  return result;
 }
 
 bool TypeRelation::operator()(const Type* a, const Type* b) const {
@@ -234,13 +374,32 @@ bool TypeRelation::related(const types::Class& a, const types::Class& b, bool re
 }
 
 bool TypeRelation::related(const types::Record& a, const types::Record& b, bool rev) const {
-  //  @TODO: Order-independent comparison.
   if (a.num_fields() != b.num_fields()) {
     return false;
   }
 
+  bool same_order = true;
+  if (a.is_fully_indexed() && b.is_fully_indexed() &&
+      !types::Record::match_fields(a, b, &same_order)) {
+    return false;
+  }
+
   const auto num_fields = a.num_fields();
 
+  if (!same_order) {
+    //  Same field names, declared in a different order, so pair fields by name.
+    for (int64_t i = 0; i < num_fields; i++) {
+      const auto& field0 = a.fields[a.field_index[i].index];
+      const auto& field1 = b.fields[b.field_index[i].index];
+
+      if (!related(field0.type, field1.type, rev)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
   for (int64_t i = 0; i < num_fields; i++) {
     const auto& field0 = a.fields[i];
     const auto& field1 = b.fields[i];
@@ -2,6 +2,8 @@
 
 #include "type.hpp"
 #include "type_store.hpp"
+#include "../Optional.hpp"
+#include <unordered_map>
 
 namespace mt {
 
@@ -16,11 +18,78 @@ public:
   virtual bool related(const Type* lhs, const Type* rhs, bool rev) const = 0;
 };
 
+/*
+ * TypeRelationCache
+ *
+ * Results of relating pairs of types that contain no variables, by relationship. Such a result
+ * depends only on the pair, unless the class hierarchy changes, or either type is collected and
+ * its address reused; the cache is cleared when given a different `version` of either.
+ */
+
+class TypeRelationCache {
+public:
+  struct Stats {
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int64_t invalidations = 0;
+  };
+
+  struct Version {
+    friend inline bool operator==(const Version& a, const Version& b) {
+      return a.class_hierarchy == b.class_hierarchy && a.collections == b.collections;
+    }
+
+    int64_t class_hierarchy;
+    int64_t collections;
+  };
+
+public:
+  TypeRelationCache() : version{0, 0} {
+    //
+  }
+
+  Optional<bool> lookup(const TypeRelationship* relationship,
+                        const Type* a, const Type* b, bool rev);
+  void insert(const TypeRelationship* relationship,
+              const Type* a, const Type* b, bool rev, bool related);
+
+  void require_version(const Version& to_version);
+  void add_stats(const Stats& other);
+  const Stats& get_stats() const;
+
+  static bool is_cacheable(const Type* type);
+
+private:
+  struct Key {
+    struct Hash {
+      std::size_t operator()(const Key& key) const noexcept;
+    };
+
+    friend inline bool operator==(const Key& a, const Key& b) {
+      return a.relationship == b.relationship && a.a == b.a && a.b == b.b && a.rev == b.rev;
+    }
+
+    const TypeRelationship* relationship;
+    const Type* a;
+    const Type* b;
+    bool rev;
+  };
+
+  std::unordered_map<Key, bool, Key::Hash> results;
+  Version version;
+  Stats stats;
+};
+
+/*
+ * TypeRelation
+ */
+
 class TypeRelation {
   friend class DestructuredVisitor;
 public:
-  TypeRelation(const TypeRelationship& relationship, const TypeStore& store) :
-  relationship(relationship), store(store) {
+  TypeRelation(const TypeRelationship& relationship, const TypeStore& store,
+               TypeRelationCache* cache = nullptr) :
+  relationship(relationship), store(store), cache(cache) {
     //
   }
 public:
@@ -65,6 +134,7 @@ private:
 private:
   const TypeRelationship& relationship;
   const TypeStore& store;
+  TypeRelationCache* cache;
 };
 
 }
\ No newline at end of file
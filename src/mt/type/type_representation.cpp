@@ -3,7 +3,12 @@
 #include "../display.hpp"
 #include "../string.hpp"
 #include "../config.hpp"
+#include <atomic>
 #include <cassert>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace mt {
 
@@ -25,8 +30,91 @@ const char* tuple_usage_shorthand(types::DestructuredTuple::Usage usage) {
   }
 }
 
+/*
+ * Streams are reused between calls, rather than constructed for each rendered type. A nested
+ * render (e.g., of a memoized member type) acquires the next stream in the pool.
+ */
+
+class StreamPool {
+public:
+  std::stringstream& acquire() {
+    if (depth == int64_t(streams.size())) {
+      streams.push_back(std::make_unique<std::stringstream>());
+    }
+    auto& stream = *streams[depth++];
+    stream.str(std::string());
+    stream.clear();
+    return stream;
+  }
+
+  void release() {
+    assert(depth > 0);
+    depth--;
+  }
+
+private:
+  std::vector<std::unique_ptr<std::stringstream>> streams;
+  int64_t depth = 0;
+};
+
+thread_local StreamPool stream_pool;
+
+inline std::string render(const TypeToString& to_str, const Type* t) {
+  auto& into = stream_pool.acquire();
+  to_str.apply(t, into);
+  auto str = into.str();
+  stream_pool.release();
+  return str;
+}
+
+inline bool is_memoizable(const Type* t) {
+  //  Only types whose strings are typically long are worth the lookup.
+  switch (t->tag) {
+    case Type::Tag::abstraction:
+    case Type::Tag::record:
+    case Type::Tag::class_type:
+    case Type::Tag::scheme:
+      return true;
+    default:
+      return false;
+  }
+}
+
 }
 
+/*
+ * TypeStringCache
+ */
+
+std::size_t TypeStringCache::Key::Hash::operator()(const Key& key) const noexcept {
+  return std::hash<const Type*>{}(key.type) ^ (std::hash<uint64_t>{}(key.options) << 1u);
+}
+
+Optional<std::string> TypeStringCache::lookup(const Type* type, uint64_t options) const {
+  std::shared_lock<std::shared_mutex> lock(mutex);
+  const auto it = strings.find(Key{type, options});
+  return it == strings.end() ? NullOpt{} : Optional<std::string>(it->second);
+}
+
+void TypeStringCache::insert(const Type* type, uint64_t options, const std::string& str) {
+  std::unique_lock<std::shared_mutex> lock(mutex);
+  strings.emplace(Key{type, options}, str);
+}
+
+void TypeStringCache::clear() {
+  std::unique_lock<std::shared_mutex> lock(mutex);
+  strings.clear();
+}
+
+int64_t TypeStringCache::size() const {
+  std::shared_lock<std::shared_mutex> lock(mutex);
+  return int64_t(strings.size());
+}
+
+/*
+ * TypeToString
+ */
+
 TypeToString::TypeToString(const Library *library, const StringRegistry *string_registry) :
   library(library),
   string_registry(string_registry),
@@ -36,18 +124,87 @@ TypeToString::TypeToString(const Library *library, const StringRegistry *string_
   arrow_function_notation(false),
   show_class_source_type(true),
   show_application_outputs(true),
-  max_num_type_variables(-1) {
+  max_num_type_variables(-1),
+  cache(nullptr) {
   //
 }
 
 void TypeToString::apply(const Type* t, std::stringstream& into) const {
-  t->accept(*this, into);
+  if (cache && is_memoizable(t)) {
+    apply_memoized(t, into);
+  } else {
+    t->accept(*this, into);
+  }
+}
+
+void TypeToString::apply_memoized(const Type* t, std::stringstream& into) const {
+  const auto opts = options();
+  if (auto maybe_str = cache->lookup(t, opts)) {
+    into << maybe_str.value();
+    return;
+  }
+
+  auto& nested = stream_pool.acquire();
+  t->accept(*this, nested);
+  const auto str = nested.str();
+  stream_pool.release();
+
+  cache->insert(t, opts, str);
+  into << str;
+}
+
+uint64_t TypeToString::options() const {
+  uint64_t opts = uint32_t(max_num_type_variables);
+  opts = (opts << 1u) | rich_text;
+  opts = (opts << 1u) | explicit_destructured_tuples;
+  opts = (opts << 1u) | explicit_aliases;
+  opts = (opts << 1u) | arrow_function_notation;
+  opts = (opts << 1u) | show_class_source_type;
+  opts = (opts << 1u) | show_application_outputs;
+  return opts;
 }
 
 std::string TypeToString::apply(const Type* t) const {
-  std::stringstream into;
-  apply(t, into);
-  return into.str();
+  if (cache && is_memoizable(t)) {
+    const auto opts = options();
+    if (auto maybe_str = cache->lookup(t, opts)) {
+      return maybe_str.rvalue();
+    }
+  }
+
+  return render(*this, t);
+}
+
+std::vector<std::string> TypeToString::apply(const std::vector<const Type*>& types,
+                                             int num_threads) const {
+  std::vector<std::string> strs(types.size());
+  const auto num_types = int64_t(types.size());
+
+  std::atomic<int64_t> next_type{0};
+  auto worker = [&]() {
+    int64_t i;
+    while ((i = next_type++) < num_types) {
+      strs[i] = apply(types[i]);
+    }
+  };
+
+  //  Only worth the threads for large printouts.
+  constexpr int64_t min_types_per_thread = 64;
+  const auto num_workers = std::min(int64_t(num_threads), num_types / min_types_per_thread);
+
+  if (num_workers <= 1) {
+    worker();
+  } else {
+    std::vector<std::thread> threads;
+    for (int64_t i = 0; i < num_workers; i++) {
+      threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  return strs;
 }
 
 void TypeToString::apply(const types::Scalar& scl, std::stringstream& stream) const {
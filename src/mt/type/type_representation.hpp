@@ -3,6 +3,9 @@
 #include "types.hpp"
 #include "../Optional.hpp"
 #include <sstream>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace mt {
 
@@ -10,6 +13,41 @@ class TypeStore;
 class Library;
 class StringRegistry;
 
+/*
+ * TypeStringCache
+ *
+ * Rendered strings of types that will no longer be modified (i.e., once type checking is
+ * complete), keyed by type and by the options of the TypeToString that rendered them. Can be
+ * shared by threads rendering in parallel.
+ */
+
+class TypeStringCache {
+  struct Key {
+    struct Hash {
+      std::size_t operator()(const Key& key) const noexcept;
+    };
+
+    friend bool operator==(const Key& a, const Key& b) {
+      return a.type == b.type && a.options == b.options;
+    }
+
+    const Type* type;
+    uint64_t options;
+  };
+
+public:
+  TypeStringCache() = default;
+
+  Optional<std::string> lookup(const Type* type, uint64_t options) const;
+  void insert(const Type* type, uint64_t options, const std::string& str);
+  void clear();
+  int64_t size() const;
+
+private:
+  mutable std::shared_mutex mutex;
+  std::unordered_map<Key, std::string, Key::Hash> strings;
+};
+
 class TypeToString {
 public:
   using DT = types::DestructuredTuple;
@@ -21,6 +59,8 @@ public:
   TypeToString(const Library* library, const StringRegistry* string_registry);
 
   MT_NODISCARD std::string apply(const Type* t) const;
+  MT_NODISCARD std::vector<std::string> apply(const std::vector<const Type*>& types,
+                                              int num_threads) const;
 
   void apply(const Type* handle, std::stringstream& into) const;
   void apply(const types::Scalar& scl, std::stringstream& into) const;
@@ -51,6 +91,9 @@ public:
   const char* right_arrow() const;
 
 private:
+  void apply_memoized(const Type* t, std::stringstream& into) const;
+  uint64_t options() const;
+
   void apply_implicit(const DT& tup, const Optional<DT::Usage>& parent_usage, std::stringstream& into) const;
   void apply_name(const types::Abstraction& abstr, std::stringstream& into) const;
 
@@ -66,6 +109,9 @@ public:
   bool show_class_source_type;
   bool show_application_outputs;
   int max_num_type_variables;
+
+  //  Set once types are solved, to reuse the strings of large types that are shown repeatedly.
+  TypeStringCache* cache;
 };
 
 }
\ No newline at end of file
@@ -1,7 +1,29 @@
 #include "type_store.hpp"
+#include "type_traversal.hpp"
+#include <cassert>
+#include <unordered_set>
 
 namespace mt {
 
+thread_local std::vector<Type*>* TypeStore::deferred_identifiers = nullptr;
+
+void TypeStore::defer_identifiers(std::vector<Type*>* into) {
+  deferred_identifiers = into;
+}
+
+void TypeStore::assign_identifiers(Type* const* made, int64_t num_made) {
+  for (int64_t i = 0; i < num_made; i++) {
+    const TypeIdentifier id(type_variable_ids++);
+
+    if (made[i]->is_variable()) {
+      MT_VAR_MUT_REF(*made[i]).identifier = id;
+    } else {
+      assert(made[i]->is_parameters());
+      MT_PARAMS_MUT_REF(*made[i]).identifier = id;
+    }
+  }
+}
+
 std::unordered_map<Type::Tag, double> TypeStore::type_distribution() const {
   std::unordered_map<Type::Tag, double> counts;
   for (const auto& ptr : types) {
@@ -15,4 +37,187 @@ std::unordered_map<Type::Tag, double> TypeStore::type_distribution() const {
   return counts;
 }
 
-}
\ No newline at end of file
+void TypeStore::push_referenced_types(Type* type, std::vector<Type**>& into) {
+  if (type->is_class()) {
+    //  The source of a class can be null while the class is being defined, or if its definition
+    //  failed; null types are not marked.
+    into.push_back(&MT_CLASS_MUT_REF(*type).source);
+  } else {
+    TypeTraversal::push_children(type, into);
+  }
+
+  //  Members that are not traversed when substituting into a type.
+  if (type->is_scheme()) {
+    auto& scheme = MT_SCHEME_MUT_REF(*type);
+    for (auto& param : scheme.parameters) {
+      into.push_back(&param);
+    }
+    for (auto& constraint : scheme.constraints) {
+      into.push_back(&constraint.lhs.term);
+      into.push_back(&constraint.rhs.term);
+    }
+  } else if (type->is_class()) {
+    for (auto& supertype : MT_CLASS_MUT_REF(*type).supertypes) {
+      into.push_back(&supertype);
+    }
+  }
+}
+
+TypeStore::Collection TypeStore::collect(const std::vector<const Type*>& roots) {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  std::unordered_set<const Type*> marked;
+  std::vector<Type*> pending;
+  auto mark = [&](const Type* type) {
+    if (type && marked.insert(type).second) {
+      pending.push_back(const_cast<Type*>(type));
+    }
+  };
+
+  for (int64_t i = 0; i < int64_t(types.size()); i++) {
+    if (!collectable[i]) {
+      mark(types[i].get());
+    }
+  }
+  for (const auto& ref : type_refs) {
+    mark(ref->type);
+  }
+  for (const auto* root : roots) {
+    mark(root);
+  }
+
+  std::vector<Type**> children;
+  while (!pending.empty()) {
+    auto* type = pending.back();
+    pending.pop_back();
+
+    children.clear();
+    push_referenced_types(type, children);
+    for (auto* child : children) {
+      mark(*child);
+    }
+  }
+
+  //  Compact the surviving types, keeping the order in which they were made.
+  Collection collection;
+  int64_t num_kept = 0;
+
+  for (int64_t i = 0; i < int64_t(types.size()); i++) {
+    if (collectable[i] && marked.count(types[i].get()) == 0) {
+      collection.num_types++;
+      collection.num_bytes += int64_t(types[i]->bytes());
+      types[i] = nullptr;
+    } else {
+      if (num_kept != i) {
+        types[num_kept] = std::move(types[i]);
+        collectable[num_kept] = collectable[i];
+      }
+      num_kept++;
+    }
+  }
+
+  types.resize(num_kept);
+  collectable.resize(num_kept);
+  num_collectable -= collection.num_types;
+  collections++;
+
+  return collection;
+}
+
+Type* TypeStore::Copies::type(const Type* source) const {
+  if (!source) {
+    return nullptr;
+  }
+  assert(types.count(source) > 0 && "Type was not copied.");
+  return types.at(source);
+}
+
+TypeReference* TypeStore::Copies::type_reference(const TypeReference* source) const {
+  if (!source) {
+    return nullptr;
+  }
+  assert(type_references.count(source) > 0 && "Type reference was not copied.");
+  return type_references.at(source);
+}
+
+std::unique_ptr<Type> TypeStore::copy_type(const Type& type) {
+  switch (type.tag) {
+    case Type::Tag::variable:
+      return std::make_unique<types::Variable>(MT_VAR_REF(type));
+    case Type::Tag::scalar:
+      return std::make_unique<types::Scalar>(MT_SCALAR_REF(type));
+    case Type::Tag::abstraction:
+      return std::make_unique<types::Abstraction>(MT_ABSTR_REF(type));
+    case Type::Tag::union_type:
+      return std::make_unique<types::Union>(MT_UNION_REF(type));
+    case Type::Tag::tuple:
+      return std::make_unique<types::Tuple>(MT_TUPLE_REF(type));
+    case Type::Tag::destructured_tuple:
+      return std::make_unique<types::DestructuredTuple>(MT_DT_REF(type));
+    case Type::Tag::list:
+      return std::make_unique<types::List>(MT_LIST_REF(type));
+    case Type::Tag::subscript:
+      return std::make_unique<types::Subscript>(MT_SUBS_REF(type));
+    case Type::Tag::constant_value:
+      return std::make_unique<types::ConstantValue>(MT_CONST_VAL_REF(type));
+    case Type::Tag::scheme:
+      return std::make_unique<types::Scheme>(MT_SCHEME_REF(type));
+    case Type::Tag::assignment:
+      return std::make_unique<types::Assignment>(MT_ASSIGN_REF(type));
+    case Type::Tag::parameters:
+      return std::make_unique<types::Parameters>(MT_PARAMS_REF(type));
+    case Type::Tag::class_type:
+      return std::make_unique<types::Class>(MT_CLASS_REF(type));
+    case Type::Tag::record:
+      return std::make_unique<types::Record>(MT_RECORD_REF(type));
+    case Type::Tag::alias:
+      return std::make_unique<types::Alias>(MT_ALIAS_REF(type));
+    case Type::Tag::application:
+      return std::make_unique<types::Application>(MT_APP_REF(type));
+    case Type::Tag::cast:
+      return std::make_unique<types::Cast>(MT_CAST_REF(type));
+    default:
+      assert(false && "Unhandled.");
+      return nullptr;
+  }
+}
+
+TypeStore::Copies TypeStore::copy_from(const TypeStore& source) {
+  std::lock_guard<std::mutex> source_lock(source.mutex);
+  std::lock_guard<std::mutex> lock(mutex);
+  assert(types.empty() && type_refs.empty() && "Expected an empty store.");
+
+  Copies copies;
+  copies.types.reserve(source.types.size());
+
+  for (int64_t i = 0; i < int64_t(source.types.size()); i++) {
+    auto copy = copy_type(*source.types[i]);
+    copies.types[source.types[i].get()] = copy.get();
+    types.push_back(std::move(copy));
+    collectable.push_back(source.collectable[i]);
+  }
+
+  std::vector<Type**> children;
+  for (auto& type : types) {
+    children.clear();
+    push_referenced_types(type.get(), children);
+    for (auto* child : children) {
+      *child = copies.type(*child);
+    }
+  }
+
+  for (const auto& ref : source.type_refs) {
+    auto copy = std::make_unique<TypeReference>(*ref);
+    copy->type = copies.type(ref->type);
+    copies.type_references[ref.get()] = copy.get();
+    type_refs.push_back(std::move(copy));
+  }
+
+  type_variable_ids = source.type_variable_ids.load();
+  scalar_ids = source.scalar_ids.load();
+  num_collectable = source.num_collectable;
+
+  return copies;
+}
+
+}
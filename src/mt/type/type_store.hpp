@@ -1,16 +1,45 @@
 #pragma once
 
 #include "types.hpp"
+#include <atomic>
+#include <mutex>
 #include <utility>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace mt {
 
+/*
+ * TypeStore
+ *
+ * Owns every type. Types made while collection is enabled (see `set_collectable`) can later be
+ * reclaimed by `collect`, if they are no longer reachable from any other type or from the
+ * given roots; all other types live as long as the store, and are themselves roots.
+ */
+
 class TypeStore {
+public:
+  struct Collection {
+    int64_t num_types = 0;
+    int64_t num_bytes = 0;
+  };
+
+  //  The copies, in this store, of the types and type references of another store.
+  struct Copies {
+    Type* type(const Type* source) const;
+    TypeReference* type_reference(const TypeReference* source) const;
+
+    std::unordered_map<const Type*, Type*> types;
+    std::unordered_map<const TypeReference*, TypeReference*> type_references;
+  };
+
 public:
   TypeStore() = delete;
 
-  explicit TypeStore(int64_t cap) : capacity(cap), type_variable_ids(0) {
+  explicit TypeStore(int64_t cap) :
+  capacity(cap), type_variable_ids(0), scalar_ids(0),
+  make_collectable(false), num_collectable(0), collections(0) {
     reserve();
   }
 
@@ -18,17 +47,24 @@ public:
   TypeStore& operator=(const TypeStore& other) = delete;
 
   int64_t size() const {
+    std::lock_guard<std::mutex> lock(mutex);
     return types.size();
   }
 
   Type* make_fresh_parameters() {
-    return make_type<types::Parameters>(make_type_identifier());
+    return defer_identifier(make_type<types::Parameters>(make_type_identifier()));
   }
 
   Type* make_fresh_type_variable_reference() {
-    return make_type<types::Variable>(make_type_identifier());
+    return defer_identifier(make_type<types::Variable>(make_type_identifier()));
   }
 
+  //  While `into` is set on a thread, variables and parameters made on that thread are given
+  //  provisional identifiers and appended to `into`. They are numbered by `assign_identifiers`,
+  //  so that types made concurrently are numbered in a deterministic order.
+  static void defer_identifiers(std::vector<Type*>* into);
+  void assign_identifiers(Type* const* made, int64_t num_made);
+
   template <typename... Args>
   types::ConstantValue* make_constant_value(Args&&... args) {
     return make_type<types::ConstantValue>(std::forward<Args>(args)...);
@@ -104,7 +140,7 @@ public:
   }
 
   Type* make_scalar(const TypeIdentifier& id) {
-    return make_type<types::Scalar>(id);
+    return make_type<types::Scalar>(id, scalar_ids++);
   }
 
   template <typename... Args>
@@ -131,34 +167,88 @@ public:
   TypeReference* make_type_reference(Args&&... args) {
     auto ref = std::make_unique<TypeReference>(std::forward<Args>(args)...);
     auto ptr = ref.get();
+    std::lock_guard<std::mutex> lock(mutex);
     type_refs.push_back(std::move(ref));
     return ptr;
   }
 
   MT_NODISCARD std::unordered_map<Type::Tag, double> type_distribution() const;
 
+  void set_collectable(bool collectable) {
+    std::lock_guard<std::mutex> lock(mutex);
+    make_collectable = collectable;
+  }
+
+  int64_t num_collectable_types() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return num_collectable;
+  }
+
+  int64_t num_collections() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return collections;
+  }
+
+  //  No type may be made while collecting.
+  Collection collect(const std::vector<const Type*>& roots);
+
+  //  Copies every type and type reference of `source` into this store, which must be empty, and
+  //  continues to number types from where `source` left off. The copies refer only to each other;
+  //  the scopes of the copied type references are those of `source`. No type may be made in
+  //  `source` while copying.
+  Copies copy_from(const TypeStore& source);
+
 private:
   void reserve() {
     types.reserve(capacity);
+    collectable.reserve(capacity);
   }
 
   TypeIdentifier make_type_identifier() {
-    return TypeIdentifier(type_variable_ids++);
+    if (deferred_identifiers) {
+      //  Distinct from the default identifier (-1).
+      return TypeIdentifier(-int64_t(deferred_identifiers->size()) - 2);
+    } else {
+      return TypeIdentifier(type_variable_ids++);
+    }
+  }
+
+  static Type* defer_identifier(Type* type) {
+    if (deferred_identifiers) {
+      deferred_identifiers->push_back(type);
+    }
+    return type;
   }
 
   template <typename T, typename... Args>
   T* make_type(Args&&... args) {
     auto type = std::make_unique<T>(std::forward<Args>(args)...);
     auto ptr = type.get();
+    std::lock_guard<std::mutex> lock(mutex);
     types.push_back(std::move(type));
+    collectable.push_back(make_collectable);
+    num_collectable += make_collectable;
     return ptr;
   }
 
+  static void push_referenced_types(Type* type, std::vector<Type**>& into);
+  static std::unique_ptr<Type> copy_type(const Type& type);
+
 private:
   std::vector<std::unique_ptr<Type>> types;
+  std::vector<uint8_t> collectable;
   std::vector<std::unique_ptr<TypeReference>> type_refs;
   std::size_t capacity;
-  int64_t type_variable_ids;
+  //  Types can be made concurrently, e.g. by unifiers solving independent
+  //  components of a set of type equations.
+  std::atomic<int64_t> type_variable_ids;
+  std::atomic<int64_t> scalar_ids;
+  bool make_collectable;
+  int64_t num_collectable;
+  int64_t collections;
+  mutable std::mutex mutex;
+
+  static thread_local std::vector<Type*>* deferred_identifiers;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "type_traversal.hpp"
+#include "types.hpp"
+
+namespace mt {
+
+namespace {
+  inline void push_members(TypePtrs& members, std::vector<Type**>& into) {
+    for (auto& member : members) {
+      into.push_back(&member);
+    }
+  }
+}
+
+void TypeTraversal::push_children(Type* type, std::vector<Type**>& into) {
+  switch (type->tag) {
+    case Type::Tag::abstraction: {
+      auto& abstr = MT_ABSTR_MUT_REF(*type);
+      into.push_back(&abstr.inputs);
+      into.push_back(&abstr.outputs);
+      break;
+    }
+    case Type::Tag::application: {
+      auto& app = MT_APP_MUT_REF(*type);
+      into.push_back(&app.abstraction);
+      into.push_back(&app.inputs);
+      into.push_back(&app.outputs);
+      break;
+    }
+    case Type::Tag::tuple:
+      push_members(MT_TUPLE_MUT_REF(*type).members, into);
+      break;
+    case Type::Tag::union_type:
+      push_members(MT_UNION_MUT_REF(*type).members, into);
+      break;
+    case Type::Tag::destructured_tuple:
+      push_members(MT_DT_MUT_REF(*type).members, into);
+      break;
+    case Type::Tag::list:
+      push_members(MT_LIST_MUT_REF(*type).pattern, into);
+      break;
+    case Type::Tag::subscript: {
+      auto& sub = MT_SUBS_MUT_REF(*type);
+      into.push_back(&sub.principal_argument);
+      for (auto& s : sub.subscripts) {
+        push_members(s.arguments, into);
+      }
+      into.push_back(&sub.outputs);
+      break;
+    }
+    case Type::Tag::assignment: {
+      auto& assignment = MT_ASSIGN_MUT_REF(*type);
+      into.push_back(&assignment.lhs);
+      into.push_back(&assignment.rhs);
+      break;
+    }
+    case Type::Tag::scheme:
+      into.push_back(&MT_SCHEME_MUT_REF(*type).type);
+      break;
+    case Type::Tag::class_type:
+      assert(MT_CLASS_REF(*type).source);
+      into.push_back(&MT_CLASS_MUT_REF(*type).source);
+      break;
+    case Type::Tag::record:
+      for (auto& field : MT_RECORD_MUT_REF(*type).fields) {
+        into.push_back(&field.name);
+        into.push_back(&field.type);
+      }
+      break;
+    case Type::Tag::alias:
+      into.push_back(&MT_ALIAS_MUT_REF(*type).source);
+      break;
+    case Type::Tag::cast: {
+      auto& cast = MT_CAST_MUT_REF(*type);
+      into.push_back(&cast.from);
+      into.push_back(&cast.to);
+      break;
+    }
+    case Type::Tag::variable:
+    case Type::Tag::parameters:
+    case Type::Tag::scalar:
+    case Type::Tag::constant_value:
+      break;
+    default:
+      assert(false && "Unhandled.");
+  }
+}
+
+bool TypeTraversal::is_concrete_argument(const Type* type, const uint8_t* concrete_children,
+                                         int64_t num_children) {
+  //  Mirrors IsConcreteArgument, in terms of the concreteness of the (traversed) children.
+  switch (type->tag) {
+    case Type::Tag::destructured_tuple:
+    case Type::Tag::list:
+    case Type::Tag::union_type:
+    case Type::Tag::scheme:
+    case Type::Tag::class_type:
+    case Type::Tag::alias:
+      for (int64_t i = 0; i < num_children; i++) {
+        if (!concrete_children[i]) {
+          return false;
+        }
+      }
+      return true;
+    case Type::Tag::abstraction:
+    case Type::Tag::tuple:
+    case Type::Tag::scalar:
+    case Type::Tag::record:
+    case Type::Tag::constant_value:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "type.hpp"
+#include <cassert>
+#include <vector>
+
+namespace mt {
+
+/*
+ * TypeTraversal
+ *
+ * Post-order, in-place traversal of a type, using an explicit stack rather than recursion so
+ * that deeply nested types (e.g., lists of lists) cannot overflow the call stack.
+ *
+ * For each type, `Visitor::enter(type, &result, &concrete)` either returns false, in which case
+ * `result` replaces the type and `concrete` is whether `result` is a concrete argument (see
+ * IsConcreteArgument); or returns true, in which case the type's children are traversed in the
+ * order given by `Visitor::push_children(type, into)`. Each child is overwritten with its
+ * result, and then `Visitor::exit(type, concrete_children, changed)` is called to obtain the
+ * type's result, where `changed` is whether any child or descendant of the type was replaced
+ * with a different type. Concreteness of a traversed type is computed from that of its
+ * children, so it comes at no extra cost.
+ */
+
+class TypeTraversal {
+public:
+  TypeTraversal() = default;
+
+  template <typename Visitor>
+  Type* traverse(Type* root, Visitor& visitor, bool* concrete = nullptr);
+
+  static void push_children(Type* type, std::vector<Type**>& into);
+  static bool is_concrete_argument(const Type* type, const uint8_t* concrete_children, int64_t num_children);
+
+private:
+  struct Frame {
+    Type* type;
+    int64_t parent_child;
+    int64_t child_begin;
+    int64_t num_children;
+    int64_t next_child;
+    bool changed;
+  };
+
+  std::vector<Frame> frames;
+  std::vector<Type**> children;
+  std::vector<uint8_t> concrete_children;
+};
+
+template <typename Visitor>
+Type* TypeTraversal::traverse(Type* root, Visitor& visitor, bool* concrete) {
+  assert(frames.empty() && "Traversals cannot be nested.");
+
+  Type* result = nullptr;
+  bool is_concrete = false;
+
+  auto push_frame = [this, &visitor](Type* type, int64_t parent_child) {
+    const auto child_begin = int64_t(children.size());
+    visitor.push_children(type, children);
+    const auto num_children = int64_t(children.size()) - child_begin;
+    concrete_children.resize(children.size(), 0);
+    frames.push_back(Frame{type, parent_child, child_begin, num_children, 0, false});
+  };
+
+  if (!visitor.enter(root, &result, &is_concrete)) {
+    if (concrete) {
+      *concrete = is_concrete;
+    }
+    return result;
+  }
+
+  push_frame(root, -1);
+
+  while (!frames.empty()) {
+    auto& frame = frames.back();
+
+    if (frame.next_child < frame.num_children) {
+      const auto child_index = frame.child_begin + frame.next_child++;
+      auto* child = *children[child_index];
+
+      if (visitor.enter(child, &result, &is_concrete)) {
+        push_frame(child, child_index);
+      } else {
+        frame.changed = frame.changed || result != child;
+        *children[child_index] = result;
+        concrete_children[child_index] = is_concrete;
+      }
+      continue;
+    }
+
+    const auto* frame_concrete = concrete_children.data() + frame.child_begin;
+    is_concrete = is_concrete_argument(frame.type, frame_concrete, frame.num_children);
+    result = visitor.exit(frame.type, frame_concrete, frame.changed);
+
+    const bool changed = frame.changed || result != frame.type;
+    const auto parent_child = frame.parent_child;
+    children.resize(frame.child_begin);
+    concrete_children.resize(frame.child_begin);
+    frames.pop_back();
+
+    if (parent_child >= 0) {
+      frames.back().changed = frames.back().changed || changed;
+      *children[parent_child] = result;
+      concrete_children[parent_child] = is_concrete;
+    }
+  }
+
+  if (concrete) {
+    *concrete = is_concrete;
+  }
+
+  return result;
+}
+
+}
@@ -153,6 +153,55 @@ int64_t types::Record::num_fields() const {
   return fields.size();
 }
 
+namespace {
+  inline Optional<int64_t> record_field_name(const Type* name) {
+    if (name->is_constant_value()) {
+      const auto& name_ref = MT_CONST_VAL_REF(*name);
+      if (name_ref.kind == types::ConstantValue::Kind::char_value) {
+        return Optional<int64_t>(name_ref.char_value.full_name());
+      }
+    }
+    return NullOpt{};
+  }
+
+  inline bool field_position_less(const types::Record::FieldPosition& a, int64_t name) {
+    return a.name < name;
+  }
+
+  inline bool field_position_greater(int64_t name, const types::Record::FieldPosition& a) {
+    return name < a.name;
+  }
+}
+
+void types::Record::add_field(const Field& field) {
+  const auto position = int64_t(fields.size());
+  fields.push_back(field);
+
+  if (auto maybe_name = record_field_name(field.name)) {
+    const auto name = maybe_name.value();
+    //  After any field of the same name, so that the first declared is found first.
+    auto it = std::upper_bound(field_index.begin(), field_index.end(), name, field_position_greater);
+    field_index.insert(it, FieldPosition{name, position});
+  }
+}
+
+void types::Record::index_fields() {
+  field_index.clear();
+  for (int64_t i = 0; i < int64_t(fields.size()); i++) {
+    if (auto maybe_name = record_field_name(fields[i].name)) {
+      field_index.push_back(FieldPosition{maybe_name.value(), i});
+    }
+  }
+
+  std::stable_sort(field_index.begin(), field_index.end(), [](const auto& a, const auto& b) {
+    return a.name < b.name;
+  });
+}
+
+bool types::Record::is_fully_indexed() const {
+  return field_index.size() == fields.size();
+}
+
 const types::Record::Field* types::Record::find_field(const types::ConstantValue& val) const {
   if (val.kind != types::ConstantValue::Kind::char_value) {
     return nullptr;
@@ -162,25 +211,35 @@ const types::Record::Field* types::Record::find_field(const types::ConstantValue
 }
 
 const types::Record::Field* types::Record::find_field(const TypeIdentifier& ident) const {
-  using Kind = types::ConstantValue::Kind;
+  const auto name = ident.full_name();
+  auto it = std::lower_bound(field_index.begin(), field_index.end(), name, field_position_less);
+  return it == field_index.end() || it->name != name ? nullptr : &fields[it->index];
+}
 
-  for (const auto& field : fields) {
-    const auto& name = field.name;
-    if (!name->is_constant_value()) {
-      continue;
-    }
+bool types::Record::has_field(const types::ConstantValue& val) const {
+  return find_field(val) != nullptr;
+}
 
-    const auto& name_ref = MT_CONST_VAL_REF(*name);
-    if (name_ref.kind == Kind::char_value && name_ref.char_value == ident) {
-      return &field;
-    }
+bool types::Record::match_fields(const Record& a, const Record& b, bool* same_order) {
+  //  Whether `a` and `b` have the same set of field names. If so, `same_order` is whether the
+  //  names are also declared in the same order, in which case fields can be paired by position.
+  *same_order = true;
+
+  if (a.num_fields() != b.num_fields() || !a.is_fully_indexed() || !b.is_fully_indexed()) {
+    return false;
   }
 
-  return nullptr;
-}
+  for (int64_t i = 0; i < int64_t(a.field_index.size()); i++) {
+    const auto& pos_a = a.field_index[i];
+    const auto& pos_b = b.field_index[i];
+    if (pos_a.name != pos_b.name) {
+      return false;
+    } else if (pos_a.index != pos_b.index) {
+      *same_order = false;
+    }
+  }
 
-bool types::Record::has_field(const types::ConstantValue& val) const {
-  return find_field(val) != nullptr;
+  return true;
 }
 
 int types::Record::compare(const Type* b) const noexcept {
@@ -188,6 +247,21 @@ int types::Record::compare(const Type* b) const noexcept {
   const auto& rec_b = MT_RECORD_REF(*b);
   MT_COMPARE_EARLY_RETURN(num_fields(), rec_b.num_fields())
 
+  if (is_fully_indexed() && rec_b.is_fully_indexed()) {
+    //  Compare in field name order, so that records which differ only in the order in which
+    //  fields are declared compare equal, consistent with `match_fields`.
+    for (int64_t i = 0; i < int64_t(field_index.size()); i++) {
+      const auto& pos_a = field_index[i];
+      const auto& pos_b = rec_b.field_index[i];
+      MT_COMPARE_EARLY_RETURN(pos_a.name, pos_b.name)
+
+      const auto type_comp = fields[pos_a.index].type->compare(rec_b.fields[pos_b.index].type);
+      MT_COMPARE_TEST0_EARLY_RETURN(type_comp)
+    }
+
+    return 0;
+  }
+
   for (int64_t i = 0; i < num_fields(); i++) {
     const auto name_comp = fields[i].name->compare(rec_b.fields[i].name);
     MT_COMPARE_TEST0_EARLY_RETURN(name_comp)
@@ -556,6 +630,24 @@ int64_t types::Union::UniqueMembers::count() const {
   return end - members.begin();
 }
 
+types::Union::ScalarSet types::Union::scalar_set() const {
+  ScalarSet set{0, true};
+  for (const auto& member : members) {
+    if (!member->is_scalar()) {
+      return ScalarSet{0, false};
+    }
+
+    const auto dense_id = MT_SCALAR_REF(*member).dense_id;
+    if (dense_id < 0 || dense_id > ScalarSet::max_dense_id) {
+      return ScalarSet{0, false};
+    }
+
+    set.bits |= uint64_t(1) << uint64_t(dense_id);
+  }
+
+  return set;
+}
+
 types::Union::UniqueMembers types::Union::unique_members(const types::Union& a) {
   auto members = a.members;
   std::sort(members.begin(), members.end(), Type::Less{});
@@ -729,6 +821,15 @@ int types::List::compare(const Type* b) const noexcept {
   return compare_impl(pattern, MT_LIST_REF(*b).pattern);
 }
 
+bool types::List::has_nested_members() const {
+  for (const auto* member : pattern) {
+    if (member->is_list() || member->is_destructured_tuple()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 /*
  * Subscript
  */
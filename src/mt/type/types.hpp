@@ -101,14 +101,21 @@ struct Record : public Type {
     Type* type;
   };
 
+  //  Position of a field in `fields`, keyed by the identifier of its name.
+  struct FieldPosition {
+    int64_t name;
+    int64_t index;
+  };
+
   using Fields = std::vector<Field>;
+  using FieldIndex = std::vector<FieldPosition>;
 
   Record() : Type(Type::Tag::record) {
     //
   }
 
   explicit Record(Fields&& fields) : Type(Type::Tag::record), fields(std::move(fields)) {
-    //
+    index_fields();
   }
 
   MT_DEFAULT_COPY_CTOR_AND_ASSIGNMENT(Record)
@@ -119,10 +126,16 @@ struct Record : public Type {
   std::size_t bytes() const override;
   int64_t num_fields() const;
 
+  void add_field(const Field& field);
+  void index_fields();
+  bool is_fully_indexed() const;
+
   const Field* find_field(const types::ConstantValue& val) const;
   const Field* find_field(const TypeIdentifier& ident) const;
   bool has_field(const types::ConstantValue& val) const;
 
+  static bool match_fields(const Record& a, const Record& b, bool* same_order);
+
   void accept(const TypeToString& to_str, std::stringstream& into) const override;
   bool accept(const IsFullyConcrete& is_fully_concrete) const override;
   void accept(TypeVisitor& vis) override;
@@ -130,7 +143,10 @@ struct Record : public Type {
 
   int compare(const Type* b) const noexcept override;
 
+  //  Fields in order of declaration; add them with `add_field` to keep `field_index` current.
   Fields fields;
+  //  Fields with char-valued names, sorted by name, and then by order of declaration.
+  FieldIndex field_index;
 };
 
 /*
@@ -298,10 +314,14 @@ struct Scheme : public Type {
  */
 
 struct Scalar : public Type {
-  Scalar() : Type(Type::Tag::scalar) {
+  Scalar() : Type(Type::Tag::scalar), dense_id(-1) {
+    //
+  }
+  explicit Scalar(const TypeIdentifier& id) : Scalar(id, -1) {
     //
   }
-  explicit Scalar(const TypeIdentifier& id) : Type(Type::Tag::scalar), identifier(id) {
+  Scalar(const TypeIdentifier& id, int64_t dense_id) :
+  Type(Type::Tag::scalar), identifier(id), dense_id(dense_id) {
     //
   }
 
@@ -319,6 +339,8 @@ struct Scalar : public Type {
   int compare(const Type* b) const noexcept override;
 
   TypeIdentifier identifier;
+  //  Small, dense index of this scalar among the scalars of its TypeStore, or -1.
+  int64_t dense_id;
 };
 
 /*
@@ -333,6 +355,19 @@ struct Union : public Type {
     TypePtrs::iterator end;
   };
 
+  //  Members as a set of bits over the dense ids of scalar types. `is_complete` is false if
+  //  some member is not a scalar with a dense id that fits in `bits`.
+  struct ScalarSet {
+    static constexpr int64_t max_dense_id = 63;
+
+    bool is_subset_of(const ScalarSet& other) const {
+      return is_complete && other.is_complete && (bits & ~other.bits) == 0;
+    }
+
+    uint64_t bits;
+    bool is_complete;
+  };
+
   Union() : Type(Type::Tag::union_type) {
     //
   }
@@ -356,6 +391,7 @@ struct Union : public Type {
 
   int compare(const Type* b) const noexcept override;
   static UniqueMembers unique_members(const types::Union& a);
+  ScalarSet scalar_set() const;
 
   TypePtrs members;
 };
@@ -365,15 +401,16 @@ struct Union : public Type {
  */
 
 struct List : public Type {
-  List() : Type(Type::Tag::list) {
+  List() : Type(Type::Tag::list), is_normalized(false) {
     //
   }
 
-  explicit List(Type* arg) : Type(Type::Tag::list), pattern{arg} {
+  explicit List(Type* arg) : Type(Type::Tag::list), pattern{arg}, is_normalized(false) {
     //
   }
 
-  explicit List(TypePtrs&& pattern) : Type(Type::Tag::list), pattern(std::move(pattern)) {
+  explicit List(TypePtrs&& pattern) :
+  Type(Type::Tag::list), pattern(std::move(pattern)), is_normalized(false) {
     //
   }
 
@@ -391,7 +428,12 @@ struct List : public Type {
 
   int compare(const Type* b) const noexcept override;
 
+  bool has_nested_members() const;
+
   TypePtrs pattern;
+  //  Whether `pattern` is flat and free of repeated trailing elements, and stays so until one of
+  //  its members, or a descendant of one, is replaced.
+  bool is_normalized;
 };
 
 /*
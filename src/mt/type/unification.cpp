@@ -3,11 +3,15 @@
 #include "library.hpp"
 #include "debug.hpp"
 #include "type_properties.hpp"
+#include "equation_partition.hpp"
 #include "../string.hpp"
 #include "../search_path.hpp"
+#include "../utility.hpp"
 #include <algorithm>
-
-#define MT_REVERSE_UNIFY (0)
+#include <atomic>
+#include <deque>
+#include <numeric>
+#include <thread>
 
 #define MT_SHOW1(msg, a) \
   std::cout << (msg); \
@@ -31,7 +35,10 @@ Unifier::Unifier(TypeStore& store, const Library& library, StringRegistry& strin
   simplifier(*this, store),
   instantiation(store),
   subscript_handler(*this),
-  any_failures(false) {
+  any_failures(false),
+  component_context(nullptr),
+  num_components(0),
+  num_deferred(0) {
   //
 }
 
@@ -47,6 +54,37 @@ int64_t Unifier::num_registered_types() const {
   return registered_funcs.size() + registered_assignments.size();
 }
 
+int64_t Unifier::num_partitioned_components() const {
+  return num_components;
+}
+
+int64_t Unifier::num_deferred_components() const {
+  return num_deferred;
+}
+
+const TypeRelationCache::Stats& Unifier::relation_cache_stats() const {
+  return relation_cache.get_stats();
+}
+
+void Unifier::gather_types(std::vector<const Type*>& into) const {
+  for (const auto& func : registered_funcs) {
+    into.push_back(func.first);
+  }
+  for (const auto& assignment : registered_assignments) {
+    into.push_back(assignment.first);
+  }
+  for (const auto& params : expanded_parameters) {
+    into.push_back(params.first);
+    into.push_back(params.second);
+  }
+  for (const auto* app : applications_awaiting_resolution) {
+    into.push_back(app);
+  }
+  for (const auto& err : errors) {
+    err->gather_types(into);
+  }
+}
+
 void Unifier::resolve_function(Type* as_referenced, Type* as_defined,
                                const Token* source_token) {
   if (as_referenced->is_abstraction()) {
@@ -120,7 +158,7 @@ Optional<FunctionSearchResult> Unifier::search_function(Type* source,
     } else if (search_result.external_function_candidate) {
       //  This function was located in at least one file.
       const auto candidate = search_result.external_function_candidate.value();
-      pending_external_functions->add_visited_candidate(candidate);
+      add_visited_candidate(candidate);
 
       if (pending_external_functions->has_resolved(candidate)) {
         //  We've already gotten the type for this candidate, so reuse it.
@@ -141,10 +179,9 @@ Optional<FunctionSearchResult> Unifier::search_function(Type* source,
   }
 }
 
-void Unifier::check_application(Type* source, TermRef term, const types::Application& app) {
-  if (is_visited_type(source) ||
-      !is_concrete_argument(app.abstraction) ||
-      !is_concrete_argument(app.inputs)) {
+void Unifier::check_application(Type* source, TermRef term, const types::Application& app,
+                                bool concrete_args) {
+  if (is_visited_type(source) || !concrete_args) {
     return;
   }
 
@@ -171,21 +208,22 @@ void Unifier::check_application(Type* source, TermRef term, const types::Applica
   const auto& search_result = maybe_search_result.value();
 
   if (search_result.resolved_type) {
-    const auto& type = search_result.resolved_type.value();
-    resolve_application(MT_APP_MUT_PTR(source), type, term.source_token);
+    auto type = component_function_type(source, search_result.resolved_type.value(), term.source_token);
+    if (type) {
+      resolve_application(MT_APP_MUT_PTR(source), type, term.source_token);
+    }
 
   } else {
     assert(search_result.external_function_candidate);
     const auto& candidate = search_result.external_function_candidate.value();
     PendingFunction pending_app{source, term.source_token};
-    pending_external_functions->add_pending(candidate, pending_app);
+    add_pending_function(candidate, pending_app);
   }
 }
 
-void Unifier::check_abstraction(Type* source, TermRef term, const types::Abstraction& abstr) {
-  if (is_visited_type(source) ||
-      !is_concrete_argument(abstr.inputs) ||
-      abstr.is_anonymous()) {
+void Unifier::check_abstraction(Type* source, TermRef term, const types::Abstraction& abstr,
+                                bool concrete_inputs) {
+  if (is_visited_type(source) || !concrete_inputs || abstr.is_anonymous()) {
     return;
   }
 
@@ -201,26 +239,26 @@ void Unifier::check_abstraction(Type* source, TermRef term, const types::Abstrac
   const auto& search_result = maybe_search_result.value();
 
   if (search_result.resolved_type) {
-    const auto& type = search_result.resolved_type.value();
-    resolve_abstraction(source, type, term.source_token);
+    auto type = component_function_type(source, search_result.resolved_type.value(), term.source_token);
+    if (type) {
+      resolve_abstraction(source, type, term.source_token);
+    }
 
   } else {
     assert(search_result.external_function_candidate);
     const auto& candidate = search_result.external_function_candidate.value();
     PendingFunction pending_abstr{source, term.source_token};
-    pending_external_functions->add_pending(candidate, pending_abstr);
+    add_pending_function(candidate, pending_abstr);
   }
 }
 
-void Unifier::check_cast(Type* source, TermRef term, const types::Cast& cast) {
-  if (is_visited_type(source) ||
-      !is_concrete_argument(cast.from) ||
-      !is_concrete_argument(cast.to)) {
+void Unifier::check_cast(Type* source, TermRef term, const types::Cast& cast, bool concrete_args) {
+  if (is_visited_type(source) || !concrete_args) {
     return;
   }
 
   register_visited_type(source);
-  TypeRelation check_related(subtype_relationship, store);
+  TypeRelation check_related(subtype_relationship, store, &relation_cache);
 
   const bool cast_okay =
     cast.strategy == CastStrategy::presume ||
@@ -232,18 +270,19 @@ void Unifier::check_cast(Type* source, TermRef term, const types::Cast& cast) {
   }
 }
 
-void Unifier::check_assignment(Type* source, TermRef term, const types::Assignment& assignment) {
-  if (registered_assignments.count(source) > 0) {
+void Unifier::check_assignment(Type* source, TermRef term, const types::Assignment& assignment,
+                               bool concrete_rhs) {
+  if (is_registered_assignment(source)) {
     return;
   }
 
-  if (is_concrete_argument(assignment.rhs)) {
+  if (concrete_rhs) {
     //  In assignment lhs = rhs, rhs must be a subtype of lhs
     const auto lhs_term = make_term(term.source_token, assignment.rhs);
     const auto rhs_term = make_term(term.source_token, assignment.lhs);
     substitution->push_type_equation(make_eq(lhs_term, rhs_term));
 
-    registered_assignments[source] = true;
+    register_assignment(source);
   }
 }
 
@@ -255,22 +294,14 @@ void Unifier::reset(Substitution* subst, PendingExternalFunctions* external_func
   pending_external_functions = external_functions;
   errors.clear();
   any_failures = false;
+
+  relation_cache.require_version({library.get_class_hierarchy_version(), store.num_collections()});
 }
 
 UnifyResult Unifier::unify(Substitution* subst, PendingExternalFunctions* external_functions) {
   reset(subst, external_functions);
 
-#if MT_REVERSE_UNIFY
-  while (!substitution->type_equations.empty()) {
-    auto eq = substitution->type_equations.back();
-    substitution->type_equations.pop_back();
-    unify_one(eq);
-  }
-#else
-  while (substitution->equation_index < substitution->num_type_equations()) {
-    unify_one(substitution->type_equations[substitution->equation_index++]);
-  }
-#endif
+  unify_pending();
 
   if (had_error()) {
     return UnifyResult(std::move(errors));
@@ -279,504 +310,870 @@ UnifyResult Unifier::unify(Substitution* subst, PendingExternalFunctions* extern
   }
 }
 
-bool Unifier::occurs(const Type* type, TermRef term, const Type* lhs) const {
-  switch (type->tag) {
-    case Type::Tag::abstraction:
-      return occurs(MT_ABSTR_REF(*type), term, lhs);
-    case Type::Tag::application:
-      return occurs(MT_APP_REF(*type), term, lhs);
-    case Type::Tag::tuple:
-      return occurs(MT_TUPLE_REF(*type), term, lhs);
-    case Type::Tag::union_type:
-      return occurs(MT_UNION_REF(*type), term, lhs);
-    case Type::Tag::destructured_tuple:
-      return occurs(MT_DT_REF(*type), term, lhs);
-    case Type::Tag::subscript:
-      return occurs(MT_SUBS_REF(*type), term, lhs);
-    case Type::Tag::list:
-      return occurs(MT_LIST_REF(*type), term, lhs);
-    case Type::Tag::assignment:
-      return occurs(MT_ASSIGN_REF(*type), term, lhs);
-    case Type::Tag::scheme:
-      return occurs(MT_SCHEME_REF(*type), term, lhs);
-    case Type::Tag::class_type:
-      return occurs(MT_CLASS_REF(*type), term, lhs);
-    case Type::Tag::record:
-      return occurs(MT_RECORD_REF(*type), term, lhs);
-    case Type::Tag::constant_value:
-      return occurs(MT_CONST_VAL_REF(*type), term, lhs);
-    case Type::Tag::alias:
-      return occurs(MT_ALIAS_REF(*type), term, lhs);
-    case Type::Tag::cast:
-      return occurs(MT_CAST_REF(*type), term, lhs);
-    case Type::Tag::scalar:
-      return false;
-    case Type::Tag::variable:
-    case Type::Tag::parameters:
-      return type == lhs;
-    default:
-      MT_SHOW1("Unhandled occurs: ", type);
-      assert(false);
-      return true;
+void Unifier::unify_pending() {
+  auto& eqs = substitution->type_equations;
+  while (!eqs.empty()) {
+    unify_one(eqs.pop());
   }
 }
 
-bool Unifier::occurs(const TypePtrs& ts, TermRef term, const Type* lhs) const {
-  for (const auto& t : ts) {
-    if (occurs(t, term, lhs)) {
-      return true;
+/*
+ * Partitioned unification
+ *
+ * Pending equations are grouped into components that share no (mutable) type, and each
+ * component is solved by its own unifier on a worker thread. Side effects that are not local
+ * to a component -- errors, bindings, external function requests -- are buffered and then
+ * merged in the order in which a single unifier would have produced them.
+ */
+
+struct Unifier::ComponentContext {
+  struct ExternalFunctionEvent {
+    int64_t equation;
+    FunctionSearchCandidate candidate;
+    Optional<PendingFunction> pending;
+  };
+
+  //  The resolution is replayed at the point at which the component deferred it: after the
+  //  errors, external function requests, variables and equations that preceded it.
+  struct DeferredResolution {
+    int64_t equation;
+    Type* source;
+    Type* with_type;
+    const Token* source_token;
+    int64_t num_errors;
+    int64_t num_events;
+    int64_t num_made_variables;
+    int64_t num_enqueued;
+  };
+
+  ComponentContext(const Unifier* parent, const EquationPartition* partition, int64_t component) :
+    parent(parent),
+    partition(partition),
+    component(component),
+    num_initial_equations(0),
+    num_initial_bindings(0),
+    current_equation(0),
+    stopped(false) {
+    //
+  }
+
+  const Unifier* parent;
+  const EquationPartition* partition;
+  int64_t component;
+  int64_t num_initial_equations;
+  int64_t num_initial_bindings;
+  int64_t current_equation;
+  bool stopped;
+
+  //  Index of the first equation generated while processing each processed equation.
+  std::vector<int64_t> child_begin;
+  //  Variables and parameters made by the component, which are numbered when merged, and the
+  //  index of the first one made while processing each processed equation.
+  std::vector<Type*> made_variables;
+  std::vector<int64_t> variable_begin;
+  //  Index of the equation that was being processed when each error / binding was made.
+  std::vector<int64_t> error_equations;
+  std::vector<int64_t> binding_equations;
+
+  std::vector<ExternalFunctionEvent> external_events;
+  std::vector<DeferredResolution> deferred_resolutions;
+};
+
+struct Unifier::ComponentResult {
+  std::unique_ptr<Unifier> unifier;
+  std::unique_ptr<ComponentContext> context;
+  Substitution substitution;
+  //  Index of each of the component's initial (pending) equations and bindings.
+  std::vector<int64_t> equations;
+  std::vector<int64_t> bindings;
+};
+
+namespace {
+  //  True if `type` can be cloned without losing its identity: it contains no variables
+  //  to be unified, and no classes (which are compared by address).
+  bool is_clonable_concrete_type(const Type* type) {
+    std::vector<const Type*> pending{type};
+
+    while (!pending.empty()) {
+      const auto* next = pending.back();
+      pending.pop_back();
+
+      if (next->is_variable() || next->is_parameters() || next->is_class()) {
+        return false;
+      }
+
+      EquationPartition::push_members(next, pending);
     }
+
+    return true;
   }
-  return false;
 }
 
-bool Unifier::occurs(const types::Abstraction& abstr, TermRef term, const Type* lhs) const {
-  return occurs(abstr.inputs, term, lhs) || occurs(abstr.outputs, term, lhs);
-}
+UnifyResult Unifier::unify_partitioned(Substitution* subst,
+                                       PendingExternalFunctions* external_functions,
+                                       int num_threads) {
+  reset(subst, external_functions);
 
-bool Unifier::occurs(const types::Application& app, TermRef term, const Type* lhs) const {
-  return occurs(app.abstraction, term, lhs) ||
-         occurs(app.inputs, term, lhs) ||
-         occurs(app.outputs, term, lhs);
-}
+  EquationPartition partition;
+  build_partition(partition);
 
-bool Unifier::occurs(const types::Tuple& tup, TermRef term, const Type* lhs) const {
-  return occurs(tup.members, term, lhs);
-}
+  const int64_t num_partitions = partition.num_components();
 
-bool Unifier::occurs(const types::Union& union_type, TermRef term, const Type* lhs) const {
-  return occurs(union_type.members, term, lhs);
-}
+  if (num_threads > 1 && num_partitions > 1) {
+    std::vector<ComponentResult> results(num_partitions);
+    const auto& eqs = substitution->type_equations;
 
-bool Unifier::occurs(const types::DestructuredTuple& tup, TermRef term, const Type* lhs) const {
-  return occurs(tup.members, term, lhs);
-}
+    for (int64_t i = 0; i < num_partitions; i++) {
+      const auto& component = partition.component(i);
+      auto& result = results[i];
 
-bool Unifier::occurs(const types::Subscript& sub, TermRef term, const Type* lhs) const {
-  if (occurs(sub.outputs, term, lhs) || occurs(sub.principal_argument, term, lhs)) {
-    return true;
-  }
-  for (const auto& s : sub.subscripts) {
-    if (occurs(s.arguments, term, lhs)) {
-      return true;
-    }
-  }
-  return false;
-}
+      result.unifier = std::make_unique<Unifier>(store, library, string_registry);
+      result.context = std::make_unique<ComponentContext>(this, &partition, i);
 
-bool Unifier::occurs(const types::List& list, TermRef term, const Type* lhs) const {
-  return occurs(list.pattern, term, lhs);
-}
+      for (const auto& eq : component.equations) {
+        result.substitution.push_type_equation(eqs.pending(eq));
+        result.equations.push_back(eq);
+      }
+      for (const auto& binding : component.bindings) {
+        const auto& bound = substitution->bindings[binding];
+        result.substitution.bind(bound.lhs, bound.rhs);
+        result.bindings.push_back(binding);
+      }
 
-bool Unifier::occurs(const types::Assignment& assignment, TermRef term, const Type* lhs) const {
-  return occurs(assignment.lhs, term, lhs) || occurs(assignment.rhs, term, lhs);
-}
+      result.context->num_initial_equations = component.equations.size();
+      result.context->num_initial_bindings = component.bindings.size();
+      result.unifier->reset(&result.substitution, external_functions);
+      result.unifier->component_context = result.context.get();
+    }
 
-bool Unifier::occurs(const types::Scheme& scheme, TermRef term, const Type* lhs) const {
-  return occurs(scheme.type, term, lhs);
-}
+    //  Start with the largest components.
+    std::vector<int64_t> schedule(num_partitions);
+    std::iota(schedule.begin(), schedule.end(), int64_t(0));
+    std::stable_sort(schedule.begin(), schedule.end(), [&](int64_t a, int64_t b) {
+      return results[a].equations.size() > results[b].equations.size();
+    });
+
+    std::atomic<int64_t> next_component{0};
+    auto worker = [&]() {
+      int64_t i;
+      while ((i = next_component++) < num_partitions) {
+        auto& result = results[schedule[i]];
+        result.unifier->unify_component(*result.context);
+      }
+    };
 
-bool Unifier::occurs(const types::Class& class_type, TermRef term, const Type* lhs) const {
-  return occurs(class_type.source, term, lhs);
-}
+    std::vector<std::thread> threads;
+    const auto num_workers = std::min(int64_t(num_threads), num_partitions);
+    for (int64_t i = 1; i < num_workers; i++) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+      thread.join();
+    }
 
-bool Unifier::occurs(const types::Record& record, TermRef term, const Type* lhs) const {
-  for (const auto& field : record.fields) {
-    if (occurs(field.name, term, lhs) || occurs(field.type, term, lhs)) {
-      return true;
+    for (const auto& result : results) {
+      relation_cache.add_stats(result.unifier->relation_cache_stats());
     }
+
+    merge_components(results);
+    num_components += num_partitions;
   }
-  return false;
-}
 
-bool Unifier::occurs(const types::ConstantValue&, TermRef, const Type*) const {
-  return false;
-}
+  //  All equations, if they were not partitioned.
+  unify_pending();
 
-bool Unifier::occurs(const types::Alias& alias, TermRef term, const Type* lhs) const {
-  return occurs(alias.source, term, lhs);
+  if (had_error()) {
+    return UnifyResult(std::move(errors));
+  } else {
+    return UnifyResult();
+  }
 }
 
-bool Unifier::occurs(const types::Cast& cast, TermRef term, const Type* lhs) const {
-  return occurs(cast.from, term, lhs) || occurs(cast.to, term, lhs);
-}
+void Unifier::build_partition(EquationPartition& partition) const {
+  const auto& eqs = substitution->type_equations;
 
-Type* Unifier::apply_to(types::Variable& var, TermRef) {
-  TypeEquationTerm lookup(nullptr, &var);
+  for (int64_t i = 0; i < eqs.num_pending(); i++) {
+    partition.add_equation(i, eqs.pending(i));
+  }
 
-  if (substitution->bound_terms.count(lookup) > 0) {
-    return substitution->bound_terms.at(lookup).term;
-  } else {
-    return &var;
+  for (int64_t i = 0; i < int64_t(substitution->bindings.size()); i++) {
+    partition.add_binding(i, substitution->bindings[i]);
   }
-}
 
-Type* Unifier::apply_to(types::Parameters& params, TermRef) {
-  if (expanded_parameters.count(&params) > 0) {
-    return expanded_parameters.at(&params);
-  } else {
-    return &params;
+  //  Types of local definitions can be pulled into a component when a function is resolved;
+  //  they are registered so that a component referencing them can be deferred.
+  for (const auto& func : library.local_function_types) {
+    partition.add_root(func.second);
+  }
+  for (const auto& cls : library.local_class_types) {
+    partition.add_root(cls.second);
+  }
+  for (const auto& var : library.local_variables_types) {
+    partition.add_root(var.second);
   }
-}
 
-Type* Unifier::apply_to(types::Tuple& tup, TermRef term) {
-  apply_to(tup.members, term);
-  return &tup;
-}
+  //  A scheme is instantiated from its current state, so calls to a local function are solved
+  //  in the same component as the function itself, in the same relative order.
+  std::unordered_map<MatlabIdentifier, TypePtrs, MatlabIdentifier::Hash> local_functions;
+  library.def_store.use<Store::ReadConst>([&](const auto& reader) {
+    for (const auto& func : library.local_function_types) {
+      local_functions[reader.at(func.first).header.name].push_back(func.second);
+    }
+  });
 
-Type* Unifier::apply_to(types::Union& union_type, TermRef term) {
-  apply_to(union_type.members, term);
-  return &union_type;
-}
+  std::unordered_set<const Type*> visited;
+  std::vector<const Type*> pending;
 
-Type* Unifier::apply_to(types::DestructuredTuple& tup, TermRef term) {
-  apply_to(tup.members, term);
-  return &tup;
-}
+  for (int64_t i = 0; i < eqs.num_pending(); i++) {
+    pending.push_back(eqs.pending(i).lhs.term);
+    pending.push_back(eqs.pending(i).rhs.term);
+  }
+  for (const auto& binding : substitution->bindings) {
+    pending.push_back(binding.rhs.term);
+  }
 
-Type* Unifier::apply_to(types::Abstraction& func, TermRef term) {
-  func.inputs = apply_to(func.inputs, term);
-  func.outputs = apply_to(func.outputs, term);
+  while (!pending.empty()) {
+    const auto* next = pending.back();
+    pending.pop_back();
+
+    if (visited.count(next) > 0) {
+      continue;
+    }
+    visited.insert(next);
+
+    if (next->is_abstraction() && MT_ABSTR_REF(*next).is_function()) {
+      const auto func_it = local_functions.find(MT_ABSTR_REF(*next).name);
+      if (func_it != local_functions.end()) {
+        for (const auto& func : func_it->second) {
+          partition.link(next, func);
+        }
+      }
+    }
 
-  check_abstraction(&func, term, func);
+    EquationPartition::push_members(next, pending);
+  }
 
-  return &func;
+  partition.finalize();
 }
 
-Type* Unifier::apply_to(types::Application& app, TermRef term) {
-  app.abstraction = apply_to(app.abstraction, term);
-  app.inputs = apply_to(app.inputs, term);
-  app.outputs = apply_to(app.outputs, term);
+void Unifier::unify_component(ComponentContext& context) {
+  auto& eqs = substitution->type_equations;
 
-  check_application(&app, term, app);
+  TypeStore::defer_identifiers(&context.made_variables);
+  MT_SCOPE_EXIT {
+    TypeStore::defer_identifiers(nullptr);
+  };
 
-  return &app;
-}
+  while (!context.stopped && !eqs.empty()) {
+    //  Equations are indexed in the order in which they were enqueued.
+    const auto index = eqs.counts().retired;
+
+    if (index >= context.num_initial_equations &&
+        context.partition->is_foreign(eqs.pending(0), context.component)) {
+      //  This and all subsequent equations are solved after the components are merged.
+      break;
+    }
+
+    const auto num_bindings = substitution->num_bound_terms();
+
+    context.current_equation = index;
+    context.child_begin.push_back(eqs.counts().enqueued);
+    context.variable_begin.push_back(int64_t(context.made_variables.size()));
+    unify_one(eqs.pop());
 
-Type* Unifier::apply_to(types::Subscript& sub, TermRef term) {
-  sub.principal_argument = apply_to(sub.principal_argument, term);
-  for (auto& s : sub.subscripts) {
-    apply_to(s.arguments, term);
+    for (auto i = num_bindings; i < substitution->num_bound_terms(); i++) {
+      context.binding_equations.push_back(index);
+    }
   }
-  sub.outputs = apply_to(sub.outputs, term);
-  return &sub;
 }
 
-Type* Unifier::apply_to(types::List& list, TermRef term) {
-  apply_to(list.pattern, term);
-  return &list;
-}
+void Unifier::merge_components(std::vector<ComponentResult>& results) {
+  struct Entry {
+    int64_t component;
+    int64_t equation;
+  };
 
-Type* Unifier::apply_to(types::Assignment& assignment, TermRef term) {
-  assignment.lhs = apply_to(assignment.lhs, term);
-  assignment.rhs = apply_to(assignment.rhs, term);
+  auto& eqs = substitution->type_equations;
+  const auto num_pending = eqs.num_pending();
+  const auto num_results = int64_t(results.size());
 
-  check_assignment(&assignment, term, assignment);
+  //  Recover the order in which a single unifier would have processed equations: the
+  //  initial equations in order, followed by those generated by each processed equation,
+  //  in the order in which they were generated.
+  std::vector<Entry> order(num_pending);
+  std::vector<std::vector<int64_t>> positions(num_results);
 
-  return &assignment;
-}
+  for (int64_t i = 0; i < num_results; i++) {
+    const auto& result = results[i];
+    positions[i].resize(result.substitution.num_type_equations());
 
-Type* Unifier::apply_to(types::Scheme& scheme, TermRef term) {
-  scheme.type = apply_to(scheme.type, term);
-  return &scheme;
-}
+    for (int64_t j = 0; j < int64_t(result.equations.size()); j++) {
+      order[result.equations[j]] = Entry{i, j};
+    }
+  }
 
-Type* Unifier::apply_to(types::Class& class_type, TermRef term) {
-  assert(class_type.source);
-  class_type.source = apply_to(class_type.source, term);
-  return &class_type;
-}
+  for (int64_t i = 0; i < int64_t(order.size()); i++) {
+    const auto entry = order[i];
+    const auto& result = results[entry.component];
+    const auto& child_begin = result.context->child_begin;
+    const auto num_processed = int64_t(child_begin.size());
 
-Type* Unifier::apply_to(types::Record& record, TermRef term) {
-  for (auto& field : record.fields) {
-    field.name = apply_to(field.name, term);
-    field.type = apply_to(field.type, term);
+    positions[entry.component][entry.equation] = i;
+
+    if (entry.equation < num_processed) {
+      const auto begin = child_begin[entry.equation];
+      const auto end = entry.equation + 1 < num_processed ?
+        child_begin[entry.equation + 1] : result.substitution.num_type_equations();
+
+      for (auto j = begin; j < end; j++) {
+        order.push_back(Entry{entry.component, j});
+      }
+    }
   }
-  return &record;
-}
 
-Type* Unifier::apply_to(types::ConstantValue& val, TermRef) {
-  //  Nothing to do yet.
-  return &val;
-}
+  auto position_of = [&](int64_t component, int64_t equation) {
+    return positions[component][equation];
+  };
 
-Type* Unifier::apply_to(types::Alias& alias, TermRef term) {
-  alias.source = apply_to(alias.source, term);
-  return &alias;
-}
+  TypeEquationQueue::Counts component_counts;
 
-Type* Unifier::apply_to(types::Cast& cast, TermRef term) {
-  cast.from = apply_to(cast.from, term);
-  cast.to = apply_to(cast.to, term);
-  check_cast(&cast, term, cast);
+  for (const auto& result : results) {
+    const auto& counts = result.substitution.type_equation_counts();
+    component_counts.enqueued += counts.enqueued - result.context->num_initial_equations;
+    component_counts.deduplicated += counts.deduplicated;
+    component_counts.retired += counts.retired;
+  }
 
-  return &cast;
-}
+  eqs.clear();
+  eqs.add_counts(component_counts);
+
+  //  Bindings.
+  std::vector<std::pair<int64_t, const TypeEquation*>> new_bindings;
 
-Type* Unifier::apply_to(Type* source, TermRef term) {
-  switch (source->tag) {
-    case Type::Tag::variable:
-      return apply_to(MT_VAR_MUT_REF(*source), term);
-    case Type::Tag::scalar:
-      return source;
-    case Type::Tag::abstraction:
-      return apply_to(MT_ABSTR_MUT_REF(*source), term);
-    case Type::Tag::application:
-      return apply_to(MT_APP_MUT_REF(*source), term);
-    case Type::Tag::tuple:
-      return apply_to(MT_TUPLE_MUT_REF(*source), term);
-    case Type::Tag::union_type:
-      return apply_to(MT_UNION_MUT_REF(*source), term);
-    case Type::Tag::destructured_tuple:
-      return apply_to(MT_DT_MUT_REF(*source), term);
-    case Type::Tag::subscript:
-      return apply_to(MT_SUBS_MUT_REF(*source), term);
-    case Type::Tag::list:
-      return apply_to(MT_LIST_MUT_REF(*source), term);
-    case Type::Tag::assignment:
-      return apply_to(MT_ASSIGN_MUT_REF(*source), term);
-    case Type::Tag::scheme:
-      return apply_to(MT_SCHEME_MUT_REF(*source), term);
-    case Type::Tag::parameters:
-      return apply_to(MT_PARAMS_MUT_REF(*source), term);
-    case Type::Tag::class_type:
-      return apply_to(MT_CLASS_MUT_REF(*source), term);
-    case Type::Tag::record:
-      return apply_to(MT_RECORD_MUT_REF(*source), term);
-    case Type::Tag::constant_value:
-      return apply_to(MT_CONST_VAL_MUT_REF(*source), term);
-    case Type::Tag::alias:
-      return apply_to(MT_ALIAS_MUT_REF(*source), term);
-    case Type::Tag::cast:
-      return apply_to(MT_CAST_MUT_REF(*source), term);
-    default:
-      MT_SHOW1("Unhandled apply to: ", source);
-      assert(false);
-      return source;
+  for (int64_t i = 0; i < num_results; i++) {
+    const auto& result = results[i];
+    const auto& context = *result.context;
+    const auto& bindings = result.substitution.bindings;
+
+    for (int64_t j = 0; j < int64_t(bindings.size()); j++) {
+      if (j < context.num_initial_bindings) {
+        substitution->bind(bindings[j].lhs, bindings[j].rhs);
+      } else {
+        const auto eq = context.binding_equations[j - context.num_initial_bindings];
+        new_bindings.emplace_back(position_of(i, eq), &bindings[j]);
+      }
+    }
   }
-}
 
-void Unifier::apply_to(TypePtrs& sources, TermRef term) {
-  for (auto& source : sources) {
-    source = apply_to(source, term);
+  std::stable_sort(new_bindings.begin(), new_bindings.end(), [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  });
+  for (const auto& binding : new_bindings) {
+    substitution->bind(binding.second->lhs, binding.second->rhs);
   }
-}
 
-Type* Unifier::substitute_one(Type* source, TermRef term, TermRef lhs, TermRef rhs) {
-  switch (source->tag) {
-    case Type::Tag::variable:
-      return substitute_one(MT_VAR_MUT_REF(*source), term, lhs, rhs);
-    case Type::Tag::parameters:
-      return substitute_one(MT_PARAMS_MUT_REF(*source), term, lhs, rhs);
-    case Type::Tag::scalar:
-      return source;
-    case Type::Tag::abstraction:
-      return substitute_one(MT_ABSTR_MUT_REF(*source), term, lhs, rhs);
-    case Type::Tag::application:
-      return substitute_one(MT_APP_MUT_REF(*source), term, lhs, rhs);
-    case Type::Tag::tuple:
-      return substitute_one(MT_TUPLE_MUT_REF(*source), term, lhs, rhs);
-    case Type::Tag::union_type:
-      return substitute_one(MT_UNION_MUT_REF(*source), term, lhs, rhs);
-    case Type::Tag::destructured_tuple:
-      return substitute_one(MT_DT_MUT_REF(*source), term, lhs, rhs);
-    case Type::Tag::subscript:
-      return substitute_one(MT_SUBS_MUT_REF(*source), term, lhs, rhs);
-    case Type::Tag::list:
-      return substitute_one(MT_LIST_MUT_REF(*source), term, lhs, rhs);
-    case Type::Tag::assignment:
-      return substitute_one(MT_ASSIGN_MUT_REF(*source), term, lhs, rhs);
-    case Type::Tag::scheme:
-      return substitute_one(MT_SCHEME_MUT_REF(*source), term, lhs, rhs);
-    case Type::Tag::class_type:
-      return substitute_one(MT_CLASS_MUT_REF(*source), term, lhs, rhs);
-    case Type::Tag::record:
-      return substitute_one(MT_RECORD_MUT_REF(*source), term, lhs, rhs);
-    case Type::Tag::constant_value:
-      return substitute_one(MT_CONST_VAL_MUT_REF(*source), term, lhs, rhs);
-    case Type::Tag::alias:
-      return substitute_one(MT_ALIAS_MUT_REF(*source), term, lhs, rhs);
-    case Type::Tag::cast:
-      return substitute_one(MT_CAST_MUT_REF(*source), term, lhs, rhs);
-    default:
-      MT_SHOW1("Unhandled: ", source);
-      assert(false);
-      return source;
+  //  Registered types.
+  for (auto& result : results) {
+    auto& unifier = *result.unifier;
+
+    for (const auto& func : unifier.registered_funcs) {
+      if (func.second) {
+        registered_funcs[func.first] = true;
+      } else {
+        registered_funcs.erase(func.first);
+      }
+    }
+
+    registered_assignments.insert(unifier.registered_assignments.begin(),
+                                  unifier.registered_assignments.end());
+    expanded_parameters.insert(unifier.expanded_parameters.begin(),
+                               unifier.expanded_parameters.end());
   }
-}
 
-void Unifier::substitute_one(TypePtrs& sources, TermRef term, TermRef lhs, TermRef rhs) {
-  for (auto& source : sources) {
-    source = substitute_one(source, term, lhs, rhs);
+  for (const auto& result : results) {
+    if (result.unifier->any_failures) {
+      mark_failure();
+    }
+    if (result.context->stopped || !result.substitution.type_equations.empty()) {
+      num_deferred++;
+    }
   }
-}
 
-Type* Unifier::substitute_one(types::Scheme& scheme, TermRef term, TermRef lhs, TermRef rhs) {
-  scheme.type = substitute_one(scheme.type, term, lhs, rhs);
-  return &scheme;
-}
+  //  Errors, external function requests, and equations left pending by a component. These are
+  //  replayed in the order of a single unifier's queue, in which an equation generated while
+  //  merging (entry component `no_component`) follows the equations that were enqueued before
+  //  it. Deferred equations are solved as they are reached, so that their errors and
+  //  generated equations are interleaved with those of the components.
+  struct Cursor {
+    int64_t error = 0;
+    int64_t event = 0;
+    int64_t resolution = 0;
+    int64_t variable = 0;
+    int64_t child = 0;
+  };
+
+  constexpr int64_t no_component = -1;
+  std::vector<Cursor> cursors(num_results);
+  std::deque<Entry> queue;
+
+  for (int64_t i = 0; i < num_pending; i++) {
+    queue.push_back(order[i]);
+  }
 
-Type* Unifier::substitute_one(types::Class& class_type, TermRef term, TermRef lhs, TermRef rhs) {
-  class_type.source = substitute_one(class_type.source, term, lhs, rhs);
-  return &class_type;
-}
+  auto enqueue_generated = [&](int64_t num_enqueued) {
+    for (auto i = num_enqueued; i < eqs.counts().enqueued; i++) {
+      queue.push_back(Entry{no_component, 0});
+    }
+  };
 
-Type* Unifier::substitute_one(types::Assignment& assignment, TermRef term, TermRef lhs, TermRef rhs) {
-  assignment.rhs = substitute_one(assignment.rhs, term, lhs, rhs);
-  assignment.lhs = substitute_one(assignment.lhs, term, lhs, rhs);
+  while (!queue.empty()) {
+    const auto entry = queue.front();
+    queue.pop_front();
 
-  check_assignment(&assignment, term, assignment);
+    const auto num_enqueued = eqs.counts().enqueued;
 
-  return &assignment;
-}
+    if (entry.component == no_component) {
+      unify_one(eqs.pop());
+      enqueue_generated(num_enqueued);
+      continue;
+    }
 
-Type* Unifier::substitute_one(types::Record& record, TermRef term, TermRef lhs, TermRef rhs) {
-  for (auto& field : record.fields) {
-    field.name = substitute_one(field.name, term, lhs, rhs);
-    field.type = substitute_one(field.type, term, lhs, rhs);
-  }
-  return &record;
-}
+    auto& result = results[entry.component];
+    auto& unifier = *result.unifier;
+    const auto& context = *result.context;
+    const auto& component_eqs = result.substitution.type_equations;
+    const auto num_retired = component_eqs.counts().retired;
+
+    if (entry.equation >= num_retired) {
+      //  Left pending by the component.
+      unify_one(component_eqs.pending(entry.equation - num_retired));
+      enqueue_generated(num_enqueued);
+      continue;
+    }
 
-Type* Unifier::substitute_one(types::ConstantValue& val, TermRef, TermRef, TermRef) {
-  //  Nothing to do yet.
-  return &val;
-}
+    auto& cursor = cursors[entry.component];
+    const auto& error_equations = context.error_equations;
+    const auto& events = context.external_events;
+    const auto& resolutions = context.deferred_resolutions;
+    const auto& made_variables = context.made_variables;
+
+    auto end_of = [&](const std::vector<int64_t>& begin, int64_t num_total) {
+      return entry.equation + 1 < int64_t(begin.size()) ? begin[entry.equation + 1] : num_total;
+    };
+
+    //  Replays the equation's effects, up to (but excluding) the given errors, events, etc.
+    auto replay = [&](int64_t errors_end, int64_t events_end,
+                      int64_t variables_end, int64_t children_end) {
+      //  Variables are numbered as a single unifier would have numbered them.
+      store.assign_identifiers(made_variables.data() + cursor.variable,
+                               variables_end - cursor.variable);
+      cursor.variable = variables_end;
+
+      for (; cursor.error < errors_end; cursor.error++) {
+        add_error(std::move(unifier.errors[cursor.error]));
+      }
 
-Type* Unifier::substitute_one(types::Alias& alias, TermRef term, TermRef lhs, TermRef rhs) {
-  alias.source = substitute_one(alias.source, term, lhs, rhs);
-  return &alias;
-}
+      for (; cursor.event < events_end; cursor.event++) {
+        const auto& event = events[cursor.event];
+        if (event.pending) {
+          add_pending_function(event.candidate, event.pending.value());
+        } else {
+          add_visited_candidate(event.candidate);
+        }
+      }
 
-Type* Unifier::substitute_one(types::Cast& cast, TermRef term, TermRef lhs, TermRef rhs) {
-  cast.from = substitute_one(cast.from, term, lhs, rhs);
-  cast.to = substitute_one(cast.to, term, lhs, rhs);
-  check_cast(&cast, term, cast);
-  return &cast;
-}
+      for (; cursor.child < children_end; cursor.child++) {
+        queue.push_back(Entry{entry.component, cursor.child});
+      }
+    };
 
-Type* Unifier::substitute_one(types::Abstraction& func, TermRef term, TermRef lhs, TermRef rhs) {
-  func.inputs = substitute_one(func.inputs, term, lhs, rhs);
-  func.outputs = substitute_one(func.outputs, term, lhs, rhs);
+    cursor.variable = context.variable_begin[entry.equation];
+    cursor.child = context.child_begin[entry.equation];
 
-  check_abstraction(&func, term, func);
+    for (; cursor.resolution < int64_t(resolutions.size()) &&
+           resolutions[cursor.resolution].equation == entry.equation; cursor.resolution++) {
+      const auto& deferred = resolutions[cursor.resolution];
+      replay(deferred.num_errors, deferred.num_events,
+             deferred.num_made_variables, deferred.num_enqueued);
 
-  return &func;
-}
+      const auto num_generated = eqs.counts().enqueued;
+      resolve_function(deferred.source, deferred.with_type, deferred.source_token);
+      enqueue_generated(num_generated);
+    }
 
-Type* Unifier::substitute_one(types::Application& app, TermRef term, TermRef lhs, TermRef rhs) {
-  app.abstraction = substitute_one(app.abstraction, term, lhs, rhs);
-  app.inputs = substitute_one(app.inputs, term, lhs, rhs);
-  app.outputs = substitute_one(app.outputs, term, lhs, rhs);
+    auto errors_end = cursor.error;
+    while (errors_end < int64_t(error_equations.size()) &&
+           error_equations[errors_end] == entry.equation) {
+      errors_end++;
+    }
 
-  check_application(&app, term, app);
+    auto events_end = cursor.event;
+    while (events_end < int64_t(events.size()) && events[events_end].equation == entry.equation) {
+      events_end++;
+    }
 
-  return &app;
+    replay(errors_end, events_end,
+           end_of(context.variable_begin, int64_t(made_variables.size())),
+           end_of(context.child_begin, result.substitution.num_type_equations()));
+  }
 }
 
-Type* Unifier::substitute_one(types::Tuple& tup, TermRef term, TermRef lhs, TermRef rhs) {
-  substitute_one(tup.members, term, lhs, rhs);
-  return &tup;
+void Unifier::add_visited_candidate(const FunctionSearchCandidate& candidate) {
+  if (component_context) {
+    component_context->external_events.push_back({component_context->current_equation, candidate, NullOpt{}});
+  } else {
+    pending_external_functions->add_visited_candidate(candidate);
+  }
 }
 
-Type* Unifier::substitute_one(types::Union& union_type, TermRef term, TermRef lhs, TermRef rhs) {
-  substitute_one(union_type.members, term, lhs, rhs);
-  return &union_type;
+void Unifier::add_pending_function(const FunctionSearchCandidate& candidate,
+                                   const PendingFunction& func) {
+  if (component_context) {
+    component_context->external_events.push_back(
+      {component_context->current_equation, candidate, Optional<PendingFunction>(func)});
+  } else {
+    pending_external_functions->add_pending(candidate, func);
+  }
 }
 
-Type* Unifier::substitute_one(types::DestructuredTuple& tup, TermRef term, TermRef lhs, TermRef rhs) {
-  substitute_one(tup.members, term, lhs, rhs);
-  return &tup;
-}
+Type* Unifier::component_function_type(Type* source, Type* type, const Token* source_token) {
+  if (!component_context) {
+    return type;
+  }
 
-Type* Unifier::substitute_one(types::Variable& var, TermRef, TermRef lhs, TermRef rhs) {
-  auto source = &var;
+  const auto& partition = *component_context->partition;
+  const auto component = component_context->component;
+  const bool shared = partition.is_foreign(type, component);
+
+  if (!shared && (type->is_scheme() || partition.owning_component(type) == component)) {
+    //  Schemes are only read when instantiated.
+    return type;
+
+  } else if (!shared && is_clonable_concrete_type(type)) {
+    Instantiation::InstanceVars no_vars;
+    return instantiation.clone(type, no_vars);
 
-  if (source == lhs.term) {
-    return rhs.term;
   } else {
-    return source;
+    //  Using `type` would modify types belonging to another component; resolve it after the
+    //  components are merged, and stop processing this component.
+    component_context->deferred_resolutions.push_back(
+      {component_context->current_equation, source, type, source_token,
+       int64_t(errors.size()), int64_t(component_context->external_events.size()),
+       int64_t(component_context->made_variables.size()), substitution->num_type_equations()});
+    component_context->stopped = true;
+    return nullptr;
   }
 }
 
-Type* Unifier::substitute_one(types::Parameters& params, TermRef, TermRef, TermRef) {
-  auto source = &params;
+/*
+ * Traversals
+ *
+ * The current substitution is applied to a term in a single (post-order) pass, which also
+ * computes the concreteness of each sub-term for the checks made on abstractions,
+ * applications, assignments and casts, and optionally whether a variable occurs in the result.
+ */
 
-  if (expanded_parameters.count(source) > 0) {
-    return expanded_parameters.at(source);
-  } else {
-    return source;
+struct Unifier::ApplyVisitor {
+  ApplyVisitor(Unifier& unifier, TermRef term, const Type* occurs_lhs) :
+    unifier(unifier), term(term), occurs_lhs(occurs_lhs), occurred(false) {
+    //
   }
-}
 
-Type* Unifier::substitute_one(types::Subscript& sub, TermRef term, TermRef lhs, TermRef rhs) {
-  sub.principal_argument = substitute_one(sub.principal_argument, term, lhs, rhs);
+  bool enter(Type* type, Type** result, bool* concrete) {
+    switch (type->tag) {
+      case Type::Tag::variable: {
+        const auto* maybe_bound = unifier.substitution->lookup_binding(make_term(nullptr, type));
+        *result = maybe_bound ? maybe_bound->term : type;
+        break;
+      }
+      case Type::Tag::parameters: {
+        const auto maybe_expanded = unifier.lookup_expanded_parameters(type);
+        *result = maybe_expanded ? maybe_expanded.value() : type;
+        break;
+      }
+      case Type::Tag::scalar:
+      case Type::Tag::constant_value:
+        *result = type;
+        *concrete = true;
+        return false;
+      default:
+        return true;
+    }
+
+    *concrete = unifier.is_concrete_argument(*result);
+
+    if (occurs_lhs && !occurred) {
+      occurred = *result == type ? type == occurs_lhs : unifier.occurs(*result, occurs_lhs);
+    }
 
-  for (auto& s : sub.subscripts) {
-    substitute_one(s.arguments, term, lhs, rhs);
+    return false;
   }
 
-  sub.outputs = substitute_one(sub.outputs, term, lhs, rhs);
-  subscript_handler.maybe_unify_subscript(&sub, term, sub);
+  void push_children(Type* type, std::vector<Type**>& into) const {
+    TypeTraversal::push_children(type, into);
+  }
 
-  return &sub;
-}
+  Type* exit(Type* type, const uint8_t* concrete_children, bool changed) {
+    switch (type->tag) {
+      case Type::Tag::abstraction:
+        unifier.check_abstraction(type, term, MT_ABSTR_REF(*type), concrete_children[0]);
+        break;
+      case Type::Tag::application:
+        unifier.check_application(type, term, MT_APP_REF(*type),
+                                  concrete_children[0] && concrete_children[1]);
+        break;
+      case Type::Tag::assignment:
+        unifier.check_assignment(type, term, MT_ASSIGN_REF(*type), concrete_children[1]);
+        break;
+      case Type::Tag::cast:
+        unifier.check_cast(type, term, MT_CAST_REF(*type),
+                           concrete_children[0] && concrete_children[1]);
+        break;
+      case Type::Tag::list:
+        //  Normalized by the next substitution that visits the list.
+        if (changed) {
+          MT_LIST_MUT_REF(*type).is_normalized = false;
+        }
+        break;
+      default:
+        break;
+    }
 
-void Unifier::flatten_list(Type* source, TypePtrs& into) const {
-  switch (source->tag) {
-    case Type::Tag::list: {
-      const auto& list = MT_LIST_REF(*source);
-      auto sz = list.size();
-      for (int64_t i = 0; i < sz; i++) {
-        flatten_list(list.pattern[i], into);
+    return type;
+  }
+
+  Unifier& unifier;
+  TermRef term;
+  const Type* occurs_lhs;
+  bool occurred;
+};
+
+struct Unifier::SubstituteVisitor {
+  SubstituteVisitor(Unifier& unifier, TermRef term, TermRef lhs, TermRef rhs) :
+    unifier(unifier), term(term), lhs(lhs), rhs(rhs) {
+    //
+  }
+
+  bool enter(Type* type, Type** result, bool* concrete) {
+    switch (type->tag) {
+      case Type::Tag::variable:
+        *result = type == lhs.term ? rhs.term : type;
+        break;
+      case Type::Tag::parameters: {
+        const auto maybe_expanded = unifier.lookup_expanded_parameters(type);
+        *result = maybe_expanded ? maybe_expanded.value() : type;
+        break;
       }
-      break;
+      case Type::Tag::scalar:
+      case Type::Tag::constant_value:
+        *result = type;
+        *concrete = true;
+        return false;
+      case Type::Tag::list:
+        flatten(MT_LIST_MUT_REF(*type));
+        return true;
+      default:
+        return true;
+    }
+
+    *concrete = unifier.is_concrete_argument(*result);
+    return false;
+  }
+
+  void push_children(Type* type, std::vector<Type**>& into) const {
+    if (type->tag == Type::Tag::assignment) {
+      auto& assignment = MT_ASSIGN_MUT_REF(*type);
+      into.push_back(&assignment.rhs);
+      into.push_back(&assignment.lhs);
+    } else {
+      TypeTraversal::push_children(type, into);
+    }
+  }
+
+  Type* exit(Type* type, const uint8_t* concrete_children, bool changed) {
+    switch (type->tag) {
+      case Type::Tag::abstraction:
+        unifier.check_abstraction(type, term, MT_ABSTR_REF(*type), concrete_children[0]);
+        break;
+      case Type::Tag::application:
+        unifier.check_application(type, term, MT_APP_REF(*type),
+                                  concrete_children[0] && concrete_children[1]);
+        break;
+      case Type::Tag::assignment:
+        unifier.check_assignment(type, term, MT_ASSIGN_REF(*type), concrete_children[0]);
+        break;
+      case Type::Tag::cast:
+        unifier.check_cast(type, term, MT_CAST_REF(*type),
+                           concrete_children[0] && concrete_children[1]);
+        break;
+      case Type::Tag::subscript:
+        unifier.subscript_handler.maybe_unify_subscript(type, term, MT_SUBS_MUT_REF(*type));
+        break;
+      case Type::Tag::list:
+        normalize(MT_LIST_MUT_REF(*type), concrete_children, changed);
+        break;
+      default:
+        break;
     }
-    case Type::Tag::destructured_tuple: {
-      const auto& tup = MT_DT_REF(*source);
-      const auto sz = tup.is_outputs() ? std::min(int64_t(1), tup.size()) : tup.size();
-      for (int64_t i = 0; i < sz; i++) {
-        flatten_list(tup.members[i], into);
+
+    return type;
+  }
+
+  void flatten(types::List& list) const {
+    if (list.has_nested_members()) {
+      TypePtrs flattened;
+      unifier.flatten_list(&list, flattened);
+      std::swap(list.pattern, flattened);
+      list.is_normalized = false;
+    }
+  }
+
+  void normalize(types::List& list, const uint8_t* concrete_elements, bool changed) const {
+    //  Lists are left as-is unless a member or one of its descendants was replaced since they
+    //  were last normalized.
+    if (list.is_normalized && !changed) {
+      return;
+    }
+
+    std::vector<uint8_t> concrete_members;
+    if (list.has_nested_members()) {
+      //  A member was substituted with a list or destructured tuple, whose own members have
+      //  already been substituted.
+      flatten(list);
+      concrete_members.resize(list.size());
+      for (int64_t i = 0; i < list.size(); i++) {
+        concrete_members[i] = unifier.is_concrete_argument(list.pattern[i]);
       }
-      break;
+      concrete_elements = concrete_members.data();
     }
-    default:
-      into.push_back(source);
+
+    remove_repeated_elements(list, concrete_elements);
+    list.is_normalized = is_stable_normalization(list, concrete_elements);
   }
-}
 
-Type* Unifier::substitute_one(types::List& list, TermRef term, TermRef lhs, TermRef rhs) {
-  TypePtrs flattened;
-  flatten_list(&list, flattened);
-  std::swap(list.pattern, flattened);
+  static bool is_stable_normalization(const types::List& list, const uint8_t* concrete_elements) {
+    //  Binding a variable only narrows which members are equivalent, so elements can only become
+    //  repeated once a member becomes concrete. A variable or parameters member does so only by
+    //  having its slot replaced, which marks the list as changed; other members can become
+    //  concrete in place, through another type that shares them.
+    for (int64_t i = 0; i < list.size(); i++) {
+      const auto* member = list.pattern[i];
+      if (!concrete_elements[i] && !member->is_variable() && !member->is_parameters()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void remove_repeated_elements(types::List& list, const uint8_t* concrete_elements) const {
+    //  Trailing elements equivalent to the one preceding them are redundant.
+    TypeRelation relation(unifier.equivalence_relationship, unifier.store, &unifier.relation_cache);
+    int64_t remove_from = 1;
+    int64_t num_remove = 0;
+
+    for (int64_t i = 0; i < list.size(); i++) {
+      const bool should_remove = i > 0 && concrete_elements[i] && concrete_elements[i-1] &&
+        relation.related_entry(list.pattern[i], list.pattern[i-1]);
+
+      if (should_remove) {
+        num_remove++;
+      } else {
+        num_remove = 0;
+        remove_from = i + 1;
+      }
+    }
+
+    if (num_remove > 0) {
+      list.pattern.erase(list.pattern.begin() + remove_from, list.pattern.end());
+    }
+  }
 
-  Type* last = nullptr;
-  int64_t remove_from = 1;
-  int64_t num_remove = 0;
+  Unifier& unifier;
+  TermRef term;
+  TermRef lhs;
+  TermRef rhs;
+};
 
-  for (int64_t i = 0; i < list.size(); i++) {
-    auto& element = list.pattern[i];
-    element = substitute_one(element, term, lhs, rhs);
-    assert(element);
+struct Unifier::OccursVisitor {
+  explicit OccursVisitor(const Type* lhs) : lhs(lhs), occurred(false) {
+    //
+  }
 
-    const bool should_remove = i > 0 && is_concrete_argument(element) &&
-                               is_concrete_argument(last) &&
-      TypeRelation(EquivalenceRelation(), store).related_entry(element, last);
+  bool enter(Type* type, Type** result, bool* concrete) {
+    *result = type;
+    *concrete = false;
 
-    if (should_remove) {
-      num_remove++;
+    if (occurred) {
+      return false;
+    } else if (type->is_variable() || type->is_parameters()) {
+      occurred = type == lhs;
+      return false;
     } else {
-      num_remove = 0;
-      remove_from = i + 1;
+      return true;
     }
-    last = element;
   }
 
-  if (num_remove > 0) {
-    list.pattern.erase(list.pattern.begin() + remove_from, list.pattern.end());
+  void push_children(Type* type, std::vector<Type**>& into) const {
+    TypeTraversal::push_children(type, into);
   }
 
-  return &list;
+  Type* exit(Type* type, const uint8_t*, bool) const {
+    return type;
+  }
+
+  const Type* lhs;
+  bool occurred;
+};
+
+Type* Unifier::apply_to(Type* source, TermRef term, const Type* occurs_lhs, bool* occurred) {
+  ApplyVisitor visitor(*this, term, occurs_lhs);
+  auto result = traversal.traverse(source, visitor);
+
+  if (occurred) {
+    *occurred = visitor.occurred;
+  }
+
+  return result;
+}
+
+Type* Unifier::substitute_one(Type* source, TermRef term, TermRef lhs, TermRef rhs) {
+  SubstituteVisitor visitor(*this, term, lhs, rhs);
+  return traversal.traverse(source, visitor);
+}
+
+bool Unifier::occurs(Type* type, const Type* lhs) {
+  //  Uses a traversal of its own, since it may be called during the application of a
+  //  substitution.
+  OccursVisitor visitor(lhs);
+  TypeTraversal occurs_traversal;
+  occurs_traversal.traverse(type, visitor);
+  return visitor.occurred;
+}
+
+void Unifier::flatten_list(Type* source, TypePtrs& into) const {
+  std::vector<Type*> pending{source};
+
+  while (!pending.empty()) {
+    auto* next = pending.back();
+    pending.pop_back();
+
+    switch (next->tag) {
+      case Type::Tag::list: {
+        const auto& pattern = MT_LIST_REF(*next).pattern;
+        pending.insert(pending.end(), pattern.rbegin(), pattern.rend());
+        break;
+      }
+      case Type::Tag::destructured_tuple: {
+        const auto& tup = MT_DT_REF(*next);
+        const auto sz = tup.is_outputs() ? std::min(int64_t(1), tup.size()) : tup.size();
+        pending.insert(pending.end(), tup.members.rend() - sz, tup.members.rend());
+        break;
+      }
+      default:
+        into.push_back(next);
+    }
+  }
 }
 
 void Unifier::unify_one(TypeEquation eq) {
@@ -785,8 +1182,12 @@ void Unifier::unify_one(TypeEquation eq) {
   auto lhs = eq.lhs;
   auto rhs = eq.rhs;
 
-  lhs.term = apply_to(lhs.term, lhs);
-  rhs.term = apply_to(rhs.term, rhs);
+  lhs.term = apply_to(lhs.term, lhs, nullptr, nullptr);
+
+  //  If lhs is a variable, check whether it occurs in rhs while applying the substitution.
+  const Type* occurs_lhs = lhs.term->is_variable() ? lhs.term : nullptr;
+  bool lhs_occurs_in_rhs = false;
+  rhs.term = apply_to(rhs.term, rhs, occurs_lhs, &lhs_occurs_in_rhs);
 
   if (lhs.term == rhs.term) {
     return;
@@ -806,21 +1207,24 @@ void Unifier::unify_one(TypeEquation eq) {
     assert(rhs_type == Tag::variable && "Rhs should be variable.");
     std::swap(lhs, rhs);
     std::swap(lhs_type, rhs_type);
+    lhs_occurs_in_rhs = occurs(rhs.term, lhs.term);
   }
 
   assert(lhs_type == Type::Tag::variable);
 
-  if (occurs(rhs.term, rhs, lhs.term)) {
+  if (lhs_occurs_in_rhs) {
     add_error(make_occurs_check_violation(lhs.source_token, rhs.source_token, lhs.term, rhs.term));
     return;
   }
 
-  for (auto& subst_it : substitution->bound_terms) {
-    auto& rhs_term = subst_it.second;
+  //  The new binding is swept as well, so that it is checked by the equation that made it,
+  //  rather than by whichever equation next binds a variable.
+  substitution->bind(lhs, rhs);
+
+  for (auto& binding : substitution->bindings) {
+    auto& rhs_term = binding.rhs;
     rhs_term.term = substitute_one(rhs_term.term, rhs_term, lhs, rhs);
   }
-
-  substitution->bound_terms[lhs] = rhs;
 }
 
 Type* Unifier::instantiate(const types::Scheme& scheme) {
@@ -829,10 +1233,16 @@ Type* Unifier::instantiate(const types::Scheme& scheme) {
   auto instance_constraints = scheme.constraints;
 
   for (auto& constraint : instance_constraints) {
+    const auto num_replaced = instantiation.num_replaced_variables();
+
     constraint.lhs.term = instantiation.clone(constraint.lhs.term, instance_vars);
     constraint.rhs.term = instantiation.clone(constraint.rhs.term, instance_vars);
 
-    if (constraint.lhs != constraint.rhs) {
+    //  A constraint that references none of the scheme's parameters is unchanged by
+    //  instantiation; it is already part of the system of equations.
+    const bool is_generic = instantiation.num_replaced_variables() != num_replaced;
+
+    if (is_generic && constraint.lhs != constraint.rhs) {
       substitution->push_type_equation(constraint);
     }
   }
@@ -880,19 +1290,62 @@ BoxedTypeError Unifier::make_unhandled_custom_subscripts_error(const Token* at_t
 }
 
 void Unifier::add_error(BoxedTypeError err) {
+  if (component_context) {
+    component_context->error_equations.push_back(component_context->current_equation);
+  }
   errors.emplace_back(std::move(err));
 }
 
+/*
+ * When solving one component of a partitioned set of equations, types are registered with
+ * the component's unifier, but looked up in the partitioning unifier as well. Unregistered
+ * types are marked `false`, rather than erased, so that they are also unregistered from the
+ * partitioning unifier when the components are merged.
+ */
+
 void Unifier::register_visited_type(Type* type) {
   registered_funcs[type] = true;
 }
 
 void Unifier::unregister_visited_type(Type* type) {
-  registered_funcs.erase(type);
+  if (component_context) {
+    registered_funcs[type] = false;
+  } else {
+    registered_funcs.erase(type);
+  }
 }
 
 bool Unifier::is_visited_type(Type* type) const {
-  return registered_funcs.count(type) > 0;
+  const auto it = registered_funcs.find(type);
+  if (it != registered_funcs.end()) {
+    return it->second;
+  } else {
+    return component_context && component_context->parent->is_visited_type(type);
+  }
+}
+
+void Unifier::register_assignment(Type* type) {
+  registered_assignments[type] = true;
+}
+
+bool Unifier::is_registered_assignment(Type* type) const {
+  return registered_assignments.count(type) > 0 ||
+    (component_context && component_context->parent->is_registered_assignment(type));
+}
+
+void Unifier::register_expanded_parameters(Type* params, Type* expanded) {
+  expanded_parameters[params] = expanded;
+}
+
+Optional<Type*> Unifier::lookup_expanded_parameters(Type* params) const {
+  const auto it = expanded_parameters.find(params);
+  if (it != expanded_parameters.end()) {
+    return Optional<Type*>(it->second);
+  } else if (component_context) {
+    return component_context->parent->lookup_expanded_parameters(params);
+  } else {
+    return NullOpt{};
+  }
 }
 
 bool Unifier::had_error() const {
@@ -8,12 +8,14 @@
 #include "substitution.hpp"
 #include "type_relationships.hpp"
 #include "pending_external_functions.hpp"
+#include "type_traversal.hpp"
 #include <map>
 #include <unordered_set>
 
 namespace mt {
 
 class DebugTypePrinter;
+class EquationPartition;
 class Library;
 class StringRegistry;
 class TypeStore;
@@ -53,74 +55,47 @@ public:
 public:
   Unifier(TypeStore& store, const Library& library, StringRegistry& string_registry);
   MT_NODISCARD UnifyResult unify(Substitution* subst, PendingExternalFunctions* external_functions);
+  MT_NODISCARD UnifyResult unify_partitioned(Substitution* subst,
+                                             PendingExternalFunctions* external_functions,
+                                             int num_threads);
 
   void resolve_function(Type* as_referenced, Type* as_defined, const Token* source_token);
   int64_t num_registered_types() const;
+  int64_t num_partitioned_components() const;
+  int64_t num_deferred_components() const;
+  const TypeRelationCache::Stats& relation_cache_stats() const;
+
+  //  Types referenced by registered functions and assignments, expanded parameters, and errors.
+  void gather_types(std::vector<const Type*>& into) const;
 
 private:
+  struct ComponentContext;
+  struct ComponentResult;
+
   void reset(Substitution* subst, PendingExternalFunctions* external_functions);
   void unify_one(TypeEquation eq);
+  void unify_pending();
+
+  void build_partition(EquationPartition& partition) const;
+  void unify_component(ComponentContext& context);
+  void merge_components(std::vector<ComponentResult>& results);
+
+  void add_visited_candidate(const FunctionSearchCandidate& candidate);
+  void add_pending_function(const FunctionSearchCandidate& candidate, const PendingFunction& func);
+  Type* component_function_type(Type* source, Type* type, const Token* source_token);
 
-  MT_NODISCARD Type* apply_to(types::Abstraction& func, TermRef term);
-  MT_NODISCARD Type* apply_to(types::Application& app, TermRef term);
-  MT_NODISCARD Type* apply_to(types::Variable& var, TermRef term);
-  MT_NODISCARD Type* apply_to(types::Parameters& params, TermRef term);
-  MT_NODISCARD Type* apply_to(types::Tuple& tup, TermRef term);
-  MT_NODISCARD Type* apply_to(types::Union& union_type, TermRef term);
-  MT_NODISCARD Type* apply_to(types::DestructuredTuple& tup, TermRef term);
-  MT_NODISCARD Type* apply_to(types::Subscript& sub, TermRef term);
-  MT_NODISCARD Type* apply_to(types::List& list, TermRef term);
-  MT_NODISCARD Type* apply_to(types::Assignment& assignment, TermRef term);
-  MT_NODISCARD Type* apply_to(types::Scheme& scheme, TermRef term);
-  MT_NODISCARD Type* apply_to(types::Class& class_type, TermRef term);
-  MT_NODISCARD Type* apply_to(types::Record& record, TermRef term);
-  MT_NODISCARD Type* apply_to(types::ConstantValue& val, TermRef term);
-  MT_NODISCARD Type* apply_to(types::Alias& alias, TermRef term);
-  MT_NODISCARD Type* apply_to(types::Cast& alias, TermRef term);
-  MT_NODISCARD Type* apply_to(Type* source, TermRef term);
-  void apply_to(TypePtrs& sources, TermRef term);
+  struct ApplyVisitor;
+  struct SubstituteVisitor;
+  struct OccursVisitor;
 
+  MT_NODISCARD Type* apply_to(Type* source, TermRef term, const Type* occurs_lhs, bool* occurred);
   MT_NODISCARD Type* substitute_one(Type* source, TermRef term, TermRef lhs, TermRef rhs);
-  void substitute_one(TypePtrs& sources, TermRef term, TermRef lhs, TermRef rhs);
-
-  MT_NODISCARD Type* substitute_one(types::Variable& var, TermRef term, TermRef lhs, TermRef rhs);
-  MT_NODISCARD Type* substitute_one(types::Parameters& params, TermRef term, TermRef lhs, TermRef rhs);
-  MT_NODISCARD Type* substitute_one(types::Abstraction& func, TermRef term, TermRef lhs, TermRef rhs);
-  MT_NODISCARD Type* substitute_one(types::Application& app, TermRef term, TermRef lhs, TermRef rhs);
-  MT_NODISCARD Type* substitute_one(types::Tuple& tup, TermRef term, TermRef lhs, TermRef rhs);
-  MT_NODISCARD Type* substitute_one(types::Union& union_type, TermRef term, TermRef lhs, TermRef rhs);
-  MT_NODISCARD Type* substitute_one(types::DestructuredTuple& tup, TermRef term, TermRef lhs, TermRef rhs);
-  MT_NODISCARD Type* substitute_one(types::Subscript& sub, TermRef term, TermRef lhs, TermRef rhs);
-  MT_NODISCARD Type* substitute_one(types::List& list, TermRef term, TermRef lhs, TermRef rhs);
-  MT_NODISCARD Type* substitute_one(types::Assignment& assignment, TermRef term, TermRef lhs, TermRef rhs);
-  MT_NODISCARD Type* substitute_one(types::Scheme& scheme, TermRef term, TermRef lhs, TermRef rhs);
-  MT_NODISCARD Type* substitute_one(types::Class& class_type, TermRef term, TermRef lhs, TermRef rhs);
-  MT_NODISCARD Type* substitute_one(types::Record& record, TermRef term, TermRef lhs, TermRef rhs);
-  MT_NODISCARD Type* substitute_one(types::ConstantValue& val, TermRef term, TermRef lhs, TermRef rhs);
-  MT_NODISCARD Type* substitute_one(types::Alias& val, TermRef term, TermRef lhs, TermRef rhs);
-  MT_NODISCARD Type* substitute_one(types::Cast& cast, TermRef term, TermRef lhs, TermRef rhs);
-
-  bool occurs(const Type* t, TermRef term, const Type* lhs) const;
-  bool occurs(const TypePtrs& ts, TermRef term, const Type* lhs) const;
-  bool occurs(const types::Abstraction& abstr, TermRef term, const Type* lhs) const;
-  bool occurs(const types::Application& app, TermRef term, const Type* lhs) const;
-  bool occurs(const types::Tuple& tup, TermRef term, const Type* lhs) const;
-  bool occurs(const types::Union& union_type, TermRef term, const Type* lhs) const;
-  bool occurs(const types::DestructuredTuple& tup, TermRef term, const Type* lhs) const;
-  bool occurs(const types::Subscript& sub, TermRef term, const Type* lhs) const;
-  bool occurs(const types::List& list, TermRef term, const Type* lhs) const;
-  bool occurs(const types::Assignment& assignment, TermRef term, const Type* lhs) const;
-  bool occurs(const types::Scheme& scheme, TermRef term, const Type* lhs) const;
-  bool occurs(const types::Class& class_type, TermRef term, const Type* lhs) const;
-  bool occurs(const types::Record& record, TermRef term, const Type* lhs) const;
-  bool occurs(const types::ConstantValue& val, TermRef term, const Type* lhs) const;
-  bool occurs(const types::Alias& alias, TermRef term, const Type* lhs) const;
-  bool occurs(const types::Cast& cast, TermRef term, const Type* lhs) const;
-
-  void check_cast(Type* source, TermRef term, const types::Cast& cast);
-  void check_assignment(Type* source, TermRef term, const types::Assignment& assignment);
-  void check_application(Type* source, TermRef term, const types::Application& app);
-  void check_abstraction(Type* source, TermRef term, const types::Abstraction& abstr);
+  bool occurs(Type* type, const Type* lhs);
+
+  void check_cast(Type* source, TermRef term, const types::Cast& cast, bool concrete_args);
+  void check_assignment(Type* source, TermRef term, const types::Assignment& assignment, bool concrete_rhs);
+  void check_application(Type* source, TermRef term, const types::Application& app, bool concrete_args);
+  void check_abstraction(Type* source, TermRef term, const types::Abstraction& abstr, bool concrete_inputs);
   Optional<FunctionSearchResult> search_function(Type* source,
                                                  const types::Abstraction& abstr,
                                                  const TypePtrs& args,
@@ -148,6 +123,12 @@ private:
   void unregister_visited_type(Type* type);
   bool is_visited_type(Type* type) const;
 
+  void register_assignment(Type* type);
+  bool is_registered_assignment(Type* type) const;
+
+  void register_expanded_parameters(Type* params, Type* expanded);
+  Optional<Type*> lookup_expanded_parameters(Type* params) const;
+
   void add_error(BoxedTypeError err);
   void emplace_simplification_failure(const Token* lhs_token, const Token* rhs_token,
                                       const Type* lhs_type, const Type* rhs_type);
@@ -164,6 +145,8 @@ private:
   Substitution* substitution;
   PendingExternalFunctions* pending_external_functions;
   SubtypeRelation subtype_relationship;
+  EquivalenceRelation equivalence_relationship;
+  TypeRelationCache relation_cache;
 
   TypeStore& store;
   const Library& library;
@@ -171,6 +154,7 @@ private:
   Simplifier simplifier;
   Instantiation instantiation;
   SubscriptHandler subscript_handler;
+  TypeTraversal traversal;
 
   std::unordered_map<Type*, bool> registered_funcs;
   std::unordered_map<Type*, bool> registered_assignments;
@@ -179,6 +163,11 @@ private:
 
   TypeErrors errors;
   bool any_failures;
+
+  //  Set when solving one component of a partitioned set of equations.
+  ComponentContext* component_context;
+  int64_t num_components;
+  int64_t num_deferred;
 };
 
 }
\ No newline at end of file
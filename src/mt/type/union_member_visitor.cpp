@@ -44,6 +44,15 @@ bool UnionMemberVisitor::check_subsumption(const TypePtrs& a, const TypePtrs& b,
 }
 
 bool UnionMemberVisitor::operator()(const types::Union& a, const types::Union& b, bool rev) const {
+  //  For unions of scalars, each member of the expected subset being among the members of the
+  //  other is a single word operation. Otherwise (e.g., a member may only be a subtype of another),
+  //  fall back to relating members pairwise.
+  const auto scalars_a = a.scalar_set();
+  const auto scalars_b = b.scalar_set();
+  if (rev ? scalars_b.is_subset_of(scalars_a) : scalars_a.is_subset_of(scalars_b)) {
+    return true;
+  }
+
   const auto unique_a = types::Union::unique_members(a);
   const auto unique_b = types::Union::unique_members(b);
 
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <iostream>
+
+/*
+ * MT_EXPECT
+ *
+ * Reports a failed expectation, and counts it towards the test's exit status.
+ */
+
+#define MT_EXPECT(cond, msg) \
+  if (!(cond)) { \
+    std::cout << "FAIL: " << msg << std::endl; \
+    mt::test::num_failures++; \
+  }
+
+namespace mt {
+
+namespace test {
+
+inline int num_failures = 0;
+
+//  Exit status of a test's main: non-zero if any expectation failed.
+inline int exit_status() {
+  if (num_failures > 0) {
+    std::cout << num_failures << " failure(s)." << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+}
+
+}
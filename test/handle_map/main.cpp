@@ -0,0 +1,123 @@
+#include "mt/handle_map.hpp"
+#include "mt/handles.hpp"
+#include "../common/expect.hpp"
+#include <iostream>
+#include <string>
+
+namespace mt {
+
+namespace {
+
+class TestHandle : public detail::Handle<100> {
+public:
+  TestHandle() = default;
+  explicit TestHandle(int64_t index) : Handle(index) {
+    //
+  }
+};
+
+using Map = HandleMap<TestHandle, std::string>;
+
+std::vector<int64_t> keys_of(const Map& map) {
+  std::vector<int64_t> keys;
+  for (const auto& entry : map) {
+    keys.push_back(entry.first.get_index());
+  }
+  return keys;
+}
+
+void test_insert_and_lookup() {
+  Map map;
+  MT_EXPECT(map.empty(), "Expected a new map to be empty.");
+  MT_EXPECT(map.begin() == map.end(), "Expected a new map to have no entries.");
+  MT_EXPECT(map.count(TestHandle(0)) == 0, "Expected no entry in an unallocated page.");
+
+  const std::vector<int64_t> keys{1000, 0, Map::page_size - 1, Map::page_size, 5};
+  for (const auto key : keys) {
+    map[TestHandle(key)] = std::to_string(key);
+  }
+
+  MT_EXPECT(map.size() == int64_t(keys.size()), "Expected one entry per inserted handle.");
+  for (const auto key : keys) {
+    MT_EXPECT(map.count(TestHandle(key)) == 1, "Expected an entry for " << key);
+    MT_EXPECT(map.at(TestHandle(key)) == std::to_string(key), "Expected the value inserted for " << key);
+    auto it = map.find(TestHandle(key));
+    MT_EXPECT(it != map.end() && it->first.get_index() == key, "Expected find to locate " << key);
+  }
+
+  MT_EXPECT(map.count(TestHandle(1)) == 0, "Expected no entry in an allocated page.");
+  MT_EXPECT(map.find(TestHandle(1)) == map.end(), "Expected find of a missing handle to be end().");
+  MT_EXPECT(map.find(TestHandle(5000)) == map.end(), "Expected find past the last page to be end().");
+
+  //  Existing entries are returned, not replaced.
+  map[TestHandle(5)] += "!";
+  MT_EXPECT(map.at(TestHandle(5)) == "5!", "Expected operator[] to return the existing value.");
+  MT_EXPECT(map.size() == int64_t(keys.size()), "Expected operator[] on an existing handle not to grow.");
+}
+
+void test_iteration_order() {
+  Map map;
+  for (const auto key : {700, 3, 256, 2, 255, 1}) {
+    map[TestHandle(key)] = "";
+  }
+
+  const std::vector<int64_t> expect{1, 2, 3, 255, 256, 700};
+  MT_EXPECT(keys_of(map) == expect, "Expected entries in order of handle.");
+
+  //  Iteration from a found entry continues in order of handle.
+  std::vector<int64_t> from_found;
+  for (auto it = map.find(TestHandle(255)); it != map.end(); ++it) {
+    from_found.push_back(it->first.get_index());
+  }
+  MT_EXPECT((from_found == std::vector<int64_t>{255, 256, 700}), "Expected iteration from find.");
+}
+
+void test_erase() {
+  Map map;
+  for (const auto key : {1, 2, 300, 301}) {
+    map[TestHandle(key)] = std::to_string(key);
+  }
+
+  MT_EXPECT(map.erase(TestHandle(2)) == 1, "Expected erase of an entry to return 1.");
+  MT_EXPECT(map.erase(TestHandle(2)) == 0, "Expected erase of an erased entry to return 0.");
+  MT_EXPECT(map.erase(TestHandle(9999)) == 0, "Expected erase past the last page to return 0.");
+  MT_EXPECT(map.size() == 3, "Expected 3 entries after erase.");
+  MT_EXPECT((keys_of(map) == std::vector<int64_t>{1, 300, 301}), "Expected iteration to skip erased entries.");
+
+  //  A page emptied by erasure is skipped.
+  map.erase(TestHandle(1));
+  MT_EXPECT((keys_of(map) == std::vector<int64_t>{300, 301}), "Expected iteration to skip an empty page.");
+
+  //  An erased entry is reinserted with a default value.
+  MT_EXPECT(map[TestHandle(2)].empty(), "Expected a reinserted entry to be default constructed.");
+  MT_EXPECT(map.size() == 3, "Expected 3 entries after reinsertion.");
+
+  map.erase(TestHandle(2));
+  map.erase(TestHandle(300));
+  map.erase(TestHandle(301));
+  MT_EXPECT(map.empty() && map.begin() == map.end(), "Expected an empty map after erasing every entry.");
+}
+
+void test_move() {
+  Map map;
+  map[TestHandle(4)] = "four";
+  map[TestHandle(400)] = "four hundred";
+
+  Map moved(std::move(map));
+  MT_EXPECT(moved.size() == 2, "Expected the moved-to map to hold every entry.");
+  MT_EXPECT(moved.at(TestHandle(400)) == "four hundred", "Expected moved values.");
+  MT_EXPECT((keys_of(moved) == std::vector<int64_t>{4, 400}), "Expected moved entries in order.");
+}
+
+}
+
+}
+
+int main() {
+  mt::test_insert_and_lookup();
+  mt::test_iteration_order();
+  mt::test_erase();
+  mt::test_move();
+
+  return mt::test::exit_status();
+}
@@ -0,0 +1,92 @@
+#include "mt/type/unification.hpp"
+#include "mt/type/library.hpp"
+#include "mt/type/type_store.hpp"
+#include "mt/search_path.hpp"
+#include "mt/store.hpp"
+#include "mt/string.hpp"
+#include "../common/expect.hpp"
+#include <iostream>
+
+namespace mt {
+
+namespace {
+
+struct Context {
+  Context() :
+    type_store(1e4),
+    library(type_store, store, search_path, string_registry),
+    unifier(type_store, library, string_registry) {
+    //
+  }
+
+  types::Record* make_record(const char* field_name, Type* field_type) {
+    auto name = type_store.make_constant_value(TypeIdentifier(string_registry.register_string(field_name)));
+    auto record = type_store.make_record();
+    record->add_field(types::Record::Field{name, field_type});
+    return record;
+  }
+
+  void push(Type* lhs, Type* rhs) {
+    substitution.push_type_equation(make_eq(make_term(nullptr, lhs), make_term(nullptr, rhs)));
+  }
+
+  bool unify() {
+    return !unifier.unify(&substitution, &external_functions).is_error();
+  }
+
+  TypeStore type_store;
+  Store store;
+  SearchPath search_path;
+  StringRegistry string_registry;
+  Library library;
+  Unifier unifier;
+  Substitution substitution;
+  PendingExternalFunctions external_functions;
+};
+
+void test_repeated_records() {
+  //  list<{a: T1}, {a: T2}> becomes list<{a: double}> once T1 and T2 are bound to double, even
+  //  though the records are concrete arguments before and after substitution.
+  Context ctx;
+  auto double_type = ctx.library.get_number_type().value();
+  auto t1 = ctx.type_store.make_fresh_type_variable_reference();
+  auto t2 = ctx.type_store.make_fresh_type_variable_reference();
+  auto list = ctx.type_store.make_list(TypePtrs{ctx.make_record("a", t1), ctx.make_record("a", t2)});
+  auto list_var = ctx.type_store.make_fresh_type_variable_reference();
+
+  ctx.push(list_var, list);
+  ctx.push(t1, double_type);
+  ctx.push(t2, double_type);
+
+  MT_EXPECT(ctx.unify(), "Expected unification to succeed.");
+  MT_EXPECT(MT_LIST_REF(*list).size() == 1, "Expected repeated records to be removed; got "
+            << MT_LIST_REF(*list).size() << " element(s).");
+}
+
+void test_repeated_scalars() {
+  Context ctx;
+  auto double_type = ctx.library.get_number_type().value();
+  auto t1 = ctx.type_store.make_fresh_type_variable_reference();
+  auto t2 = ctx.type_store.make_fresh_type_variable_reference();
+  auto list = ctx.type_store.make_list(TypePtrs{double_type, t1, t2});
+  auto list_var = ctx.type_store.make_fresh_type_variable_reference();
+
+  ctx.push(list_var, list);
+  ctx.push(t1, double_type);
+  ctx.push(t2, double_type);
+
+  MT_EXPECT(ctx.unify(), "Expected unification to succeed.");
+  MT_EXPECT(MT_LIST_REF(*list).size() == 1, "Expected repeated scalars to be removed; got "
+            << MT_LIST_REF(*list).size() << " element(s).");
+}
+
+}
+
+}
+
+int main() {
+  mt::test_repeated_records();
+  mt::test_repeated_scalars();
+
+  return mt::test::exit_status();
+}
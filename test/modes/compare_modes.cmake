@@ -0,0 +1,66 @@
+#  Checks that mtype reports the same types and errors, in the same order, when run with the
+#  options in `MODE_ARGS` as when run with the default options.
+#
+#  cmake -DMTYPE=<mtype> -DSEARCH_PATH=<dir1:dir2> -DROOTS=<a,b> -DMODE_ARGS=<-ut,4>
+#    [-DROOT_ARGS=<-sf,-sv>] [-DSEPARATE_ROOTS=ON] -P compare_modes.cmake
+#
+#  Each root is checked on its own, with the options in `ROOT_ARGS`, and then all roots are
+#  checked together; the order in which the types of different files are printed is
+#  unspecified, so only errors are compared in that case. With `SEPARATE_ROOTS`, the mode
+#  checks each of several roots on its own, so checking all roots together must instead report
+#  the results of checking each root on its own, in order. Standard output and standard error
+#  are compared separately, since the order in which they interleave is unspecified.
+
+string(REPLACE "," ";" roots "${ROOTS}")
+string(REPLACE "," ";" mode_args "${MODE_ARGS}")
+
+if (NOT DEFINED ROOT_ARGS)
+  set(ROOT_ARGS "-sf,-sv")
+endif()
+string(REPLACE "," ";" root_args "${ROOT_ARGS}")
+
+set(common_args -p "${SEARCH_PATH}" -pt -hdi)
+
+function(report_differences label expected expected_error expected_result actual actual_error actual_result)
+  if (NOT expected_result STREQUAL actual_result)
+    message(SEND_ERROR "${label}: exited with `${actual_result}`; expected `${expected_result}`.")
+  elseif (NOT expected STREQUAL actual)
+    message(SEND_ERROR "${label}: output differs with `${MODE_ARGS}`.\n"
+      "Expected:\n${expected}\nActual:\n${actual}")
+  elseif (NOT expected_error STREQUAL actual_error)
+    message(SEND_ERROR "${label}: error output differs with `${MODE_ARGS}`.\n"
+      "Expected:\n${expected_error}\nActual:\n${actual_error}")
+  endif()
+endfunction()
+
+function(compare_outputs label)
+  execute_process(COMMAND "${MTYPE}" ${ARGN} ${common_args}
+    OUTPUT_VARIABLE expected ERROR_VARIABLE expected_error RESULT_VARIABLE expected_result)
+  execute_process(COMMAND "${MTYPE}" ${ARGN} ${common_args} ${mode_args}
+    OUTPUT_VARIABLE actual ERROR_VARIABLE actual_error RESULT_VARIABLE actual_result)
+
+  report_differences("${label}" "${expected}" "${expected_error}" "${expected_result}"
+    "${actual}" "${actual_error}" "${actual_result}")
+
+  set(expected "${expected}" PARENT_SCOPE)
+  set(expected_error "${expected_error}" PARENT_SCOPE)
+endfunction()
+
+set(separate_expected "")
+set(separate_expected_error "")
+
+foreach(root IN LISTS roots)
+  compare_outputs(${root} ${root} ${root_args})
+  string(APPEND separate_expected "${expected}")
+  string(APPEND separate_expected_error "${expected_error}")
+endforeach()
+
+if (SEPARATE_ROOTS)
+  execute_process(COMMAND "${MTYPE}" ${roots} ${root_args} ${common_args} ${mode_args}
+    OUTPUT_VARIABLE actual ERROR_VARIABLE actual_error RESULT_VARIABLE actual_result)
+
+  report_differences("all roots" "${separate_expected}" "${separate_expected_error}" "0"
+    "${actual}" "${actual_error}" "${actual_result}")
+else()
+  compare_outputs("all roots" ${roots} -hf)
+endif()
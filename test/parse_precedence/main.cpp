@@ -0,0 +1,134 @@
+#include "mt/mt.hpp"
+#include "../common/expect.hpp"
+#include <iostream>
+#include <regex>
+
+namespace mt {
+
+namespace {
+
+void on_before_parse_no_op(AstGenerator&, ParseInstance&) {
+  //
+}
+
+/*
+ * Parses the statement `x = <expr>;` and renders its right-hand side, with each operator
+ * expression parenthesized. Identifier references are rendered without parentheses.
+ */
+
+Optional<std::string> parse_expr(const std::string& expr) {
+  const std::string text = "x = " + expr + ";\n";
+
+  Scanner scanner;
+  auto scan_res = scanner.scan(text);
+  if (!scan_res) {
+    return NullOpt{};
+  }
+
+  auto& scan_info = scan_res.value;
+  if (insert_implicit_expr_delimiters(scan_info.tokens, text)) {
+    return NullOpt{};
+  }
+
+  TypeStore type_store(1e3);
+  Store store;
+  StringRegistry string_registry;
+  SearchPath search_path;
+  Library library(type_store, store, search_path, string_registry);
+  FunctionsByFile functions_by_file;
+  CodeFileDescriptor file_descriptor;
+
+  ParseSourceData source_data(text, &file_descriptor, &scan_info.row_column_indices);
+  ParseInstance parse_instance(&store, &type_store, &library, &string_registry, &functions_by_file,
+    source_data, scan_info.functions_are_end_terminated, on_before_parse_no_op);
+
+  AstGenerator ast_gen(&parse_instance, scan_info.tokens);
+  ast_gen.parse();
+
+  if (parse_instance.had_error) {
+    return NullOpt{};
+  }
+
+  StringVisitor visitor(&string_registry, &store);
+  visitor.colorize = false;
+  visitor.include_def_ptrs = false;
+
+  const auto str = parse_instance.root_block->accept(visitor);
+  const auto rhs_begin = str.find(" = ");
+  const auto rhs_end = str.rfind(';');
+  if (rhs_begin == std::string::npos || rhs_end == std::string::npos || rhs_end < rhs_begin) {
+    return NullOpt{};
+  }
+
+  const auto rhs = str.substr(rhs_begin + 3, rhs_end - rhs_begin - 3);
+  return Optional<std::string>(std::regex_replace(rhs, std::regex("\\(([A-Za-z_]\\w*)\\)"), "$1"));
+}
+
+void expect_parse(const std::string& expr, const std::string& expected) {
+  const auto actual = parse_expr(expr);
+  MT_EXPECT(actual && actual.value() == expected,
+    "Expected `" << expr << "` to parse as `" << expected << "`; got `"
+    << (actual ? actual.value() : std::string("<error>")) << "`.");
+}
+
+void expect_parse_error(const std::string& expr) {
+  MT_EXPECT(!parse_expr(expr), "Expected `" << expr << "` not to parse.");
+}
+
+void test_binary_precedence() {
+  expect_parse("a || b + c < d", "(a || ((b + c) < d))");
+  expect_parse("a + b * c", "(a + (b * c))");
+  expect_parse("a * b + c", "((a * b) + c)");
+  expect_parse("a | b & c", "(a | (b & c))");
+  expect_parse("a && b || c && d", "((a && b) || (c && d))");
+  expect_parse("a < b | c == d", "((a < b) | (c == d))");
+  expect_parse("a + b < c * d & e", "(((a + b) < (c * d)) & e)");
+  expect_parse("(a + b) * c", "(((a + b)) * c)");
+}
+
+void test_binary_associativity() {
+  expect_parse("a - b - c", "((a - b) - c)");
+  expect_parse("a / b * c", "((a / b) * c)");
+  expect_parse("a == b ~= c", "((a == b) ~= c)");
+  expect_parse("a^b^c", "((a ^ b) ^ c)");
+  expect_parse("a.^b.^c", "((a .^ b) .^ c)");
+}
+
+void test_unary_precedence() {
+  expect_parse("-a^2", "(-(a ^ 2.000000))");
+  expect_parse("-a.^2", "(-(a .^ 2.000000))");
+  expect_parse("~a^b", "(~(a ^ b))");
+  expect_parse("a^-b", "(a ^ (-b))");
+  expect_parse("a^-b^c", "((a ^ (-b)) ^ c)");
+  expect_parse("-a * b", "((-a) * b)");
+  expect_parse("~a == b", "((~a) == b)");
+  expect_parse("-a'", "(-(a'))");
+  expect_parse("a'^b", "((a') ^ b)");
+  expect_parse("- -a", "(-(-a))");
+  expect_parse_error("a^");
+  expect_parse_error("-");
+}
+
+void test_range() {
+  expect_parse("a:b", "(a : b)");
+  expect_parse("a:b:c", "(a : (b : c))");
+  expect_parse("a:b:c:d", "((a : (b : c)) : d)");
+  expect_parse("1:2:3:4:5:6", "(((1.000000 : (2.000000 : 3.000000)) : (4.000000 : 5.000000)) : 6.000000)");
+  expect_parse("(a:b):c", "(((a : b)) : c)");
+  expect_parse("a:b+c:d < e", "((a : ((b + c) : d)) < e)");
+  expect_parse("a+1:b*2", "((a + 1.000000) : (b * 2.000000))");
+  expect_parse("-a:b", "((-a) : b)");
+}
+
+}
+
+}
+
+int main() {
+  mt::test_binary_precedence();
+  mt::test_binary_associativity();
+  mt::test_unary_precedence();
+  mt::test_range();
+
+  return mt::test::exit_status();
+}
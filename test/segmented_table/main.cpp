@@ -0,0 +1,128 @@
+#include "mt/segmented_table.hpp"
+#include "../common/expect.hpp"
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mt {
+
+namespace {
+
+struct Counted {
+  explicit Counted(int64_t value, std::atomic<int64_t>* num_destroyed) :
+    value(value), name(std::to_string(value)), num_destroyed(num_destroyed) {
+    //
+  }
+  ~Counted() {
+    (*num_destroyed)++;
+  }
+
+  int64_t value;
+  std::string name;
+  std::atomic<int64_t>* num_destroyed;
+};
+
+void test_append_across_segments() {
+  using Segments = detail::Segments<Counted>;
+  const int64_t num_elements = Segments::segment_size * 3 + 5;
+  std::atomic<int64_t> num_destroyed{0};
+
+  {
+    SegmentedTable<Counted> table;
+    MT_EXPECT(table.size() == 0, "Expected an empty table.");
+
+    std::vector<const Counted*> addresses;
+    for (int64_t i = 0; i < num_elements; i++) {
+      const auto index = table.emplace_back(i, &num_destroyed);
+      MT_EXPECT(index == i, "Expected index " << i << "; got " << index << ".");
+      addresses.push_back(&table[index]);
+    }
+
+    MT_EXPECT(table.size() == num_elements, "Expected " << num_elements << " elements.");
+
+    for (int64_t i = 0; i < num_elements; i++) {
+      MT_EXPECT(&table[i] == addresses[i], "Expected element " << i << " not to move.");
+      MT_EXPECT(table[i].value == i && table[i].name == std::to_string(i),
+                "Expected element " << i << " to keep its value.");
+    }
+
+    table[1].value = -1;
+    const auto& const_table = table;
+    MT_EXPECT(const_table[1].value == -1, "Expected a modified element to be visible.");
+    MT_EXPECT(num_destroyed == 0, "Expected no element to be destroyed while appending.");
+  }
+
+  MT_EXPECT(num_destroyed == num_elements, "Expected every element to be destroyed once.");
+}
+
+void test_concurrent_append() {
+  const int64_t num_threads = 8;
+  const int64_t num_per_thread = detail::Segments<Counted>::segment_size * 2 + 17;
+  std::atomic<int64_t> num_destroyed{0};
+
+  {
+    SegmentedTable<Counted> table;
+    std::vector<std::vector<int64_t>> indices(num_threads);
+    std::vector<std::thread> threads;
+
+    for (int64_t t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t]() {
+        for (int64_t i = 0; i < num_per_thread; i++) {
+          indices[t].push_back(table.emplace_back(t * num_per_thread + i, &num_destroyed));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    const int64_t num_elements = num_threads * num_per_thread;
+    MT_EXPECT(table.size() == num_elements, "Expected " << num_elements << " elements.");
+
+    std::vector<uint8_t> seen(num_elements, 0);
+    for (int64_t t = 0; t < num_threads; t++) {
+      for (int64_t i = 0; i < num_per_thread; i++) {
+        const auto index = indices[t][i];
+        MT_EXPECT(index >= 0 && index < num_elements, "Expected index " << index << " in range.");
+        if (index < 0 || index >= num_elements) {
+          continue;
+        }
+        MT_EXPECT(!seen[index], "Expected index " << index << " to be allocated once.");
+        seen[index] = 1;
+        MT_EXPECT(table[index].value == t * num_per_thread + i,
+                  "Expected element " << index << " to hold the value appended with it.");
+      }
+    }
+  }
+
+  MT_EXPECT(num_destroyed == num_threads * num_per_thread, "Expected every element to be destroyed once.");
+}
+
+void test_column() {
+  const int64_t num_elements = detail::Segments<int64_t>::segment_size + 3;
+  SegmentedTable<int64_t> table;
+  SegmentedColumn<int64_t> column;
+
+  for (int64_t i = 0; i < num_elements; i++) {
+    const auto index = table.emplace_back(i);
+    column.set(index, i * 2);
+  }
+
+  for (int64_t i = 0; i < num_elements; i++) {
+    MT_EXPECT(column[i] == i * 2, "Expected column value " << i << " to be " << i * 2 << ".");
+  }
+}
+
+}
+
+}
+
+int main() {
+  mt::test_append_across_segments();
+  mt::test_concurrent_append();
+  mt::test_column();
+
+  return mt::test::exit_status();
+}
@@ -0,0 +1,81 @@
+#include "mt/type/type_store.hpp"
+#include "mt/type/components.hpp"
+#include "../common/expect.hpp"
+#include <iostream>
+
+namespace mt {
+
+namespace {
+
+void test_unreachable_types_collected() {
+  TypeStore store(1e2);
+  store.make_fresh_type_variable_reference();
+
+  store.set_collectable(true);
+  auto a = store.make_fresh_type_variable_reference();
+  auto b = store.make_fresh_type_variable_reference();
+  auto tup = store.make_tuple(TypePtrs{a});
+  store.set_collectable(false);
+
+  const auto expect_bytes = int64_t(a->bytes() + b->bytes() + tup->bytes());
+  MT_EXPECT(store.num_collectable_types() == 3, "Expected 3 collectable types.");
+
+  const auto collection = store.collect({});
+  MT_EXPECT(collection.num_types == 3, "Expected 3 collected types; got " << collection.num_types);
+  MT_EXPECT(collection.num_bytes == expect_bytes, "Expected collected bytes to sum Type::bytes().");
+  MT_EXPECT(store.size() == 1, "Expected only the non-collectable type to remain.");
+  MT_EXPECT(store.num_collectable_types() == 0, "Expected no collectable types to remain.");
+  MT_EXPECT(store.num_collections() == 1, "Expected 1 collection.");
+
+  //  Types made after a collection are numbered and collected as before.
+  store.set_collectable(true);
+  store.make_fresh_type_variable_reference();
+  store.set_collectable(false);
+  MT_EXPECT(store.collect({}).num_types == 1, "Expected a second collection to reclaim 1 type.");
+  MT_EXPECT(store.num_collections() == 2, "Expected 2 collections.");
+}
+
+void test_reachable_types_kept() {
+  TypeStore store(1e2);
+
+  store.set_collectable(true);
+  auto from_root = store.make_fresh_type_variable_reference();
+  auto root = store.make_tuple(TypePtrs{from_root});
+  auto from_pinned = store.make_fresh_type_variable_reference();
+  auto scheme_param = store.make_fresh_type_variable_reference();
+  auto scheme_constraint = store.make_fresh_type_variable_reference();
+  auto supertype = store.make_fresh_type_variable_reference();
+  auto from_reference = store.make_fresh_type_variable_reference();
+  store.make_fresh_type_variable_reference();
+  store.make_tuple(TypePtrs{from_root});
+  store.set_collectable(false);
+
+  //  Types that are not collectable are roots, as are type references.
+  store.make_tuple(TypePtrs{from_pinned});
+  auto scheme = store.make_scheme(store.make_tuple(), TypePtrs{scheme_param});
+  scheme->constraints.push_back(make_eq(make_term(nullptr, scheme_constraint),
+                                        make_term(nullptr, scheme_param)));
+  store.make_class(TypeIdentifier(0), store.make_tuple(), supertype);
+  store.make_type_reference(nullptr, from_reference, nullptr);
+
+  const auto size_before = store.size();
+  const auto collection = store.collect({root});
+  MT_EXPECT(collection.num_types == 2, "Expected only the 2 unreachable types to be collected; got "
+            << collection.num_types);
+  MT_EXPECT(store.size() == size_before - 2, "Expected store size to shrink by 2.");
+  MT_EXPECT(store.num_collectable_types() == 7, "Expected 7 reachable collectable types to remain.");
+
+  //  Once no longer a root, the tuple and its member are unreachable.
+  MT_EXPECT(store.collect({}).num_types == 2, "Expected the former root and its member to be collected.");
+}
+
+}
+
+}
+
+int main() {
+  mt::test_unreachable_types_collected();
+  mt::test_reachable_types_kept();
+
+  return mt::test::exit_status();
+}
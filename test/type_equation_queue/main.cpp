@@ -0,0 +1,146 @@
+#include "mt/type/substitution.hpp"
+#include "mt/type/type_store.hpp"
+#include "../common/expect.hpp"
+#include <iostream>
+
+namespace mt {
+
+namespace {
+
+std::vector<TypeEquation> make_equations(TypeStore& store, int64_t count) {
+  std::vector<TypeEquation> eqs;
+  for (int64_t i = 0; i < count; i++) {
+    auto lhs = make_term(nullptr, store.make_fresh_type_variable_reference());
+    auto rhs = make_term(nullptr, store.make_fresh_type_variable_reference());
+    eqs.push_back(make_eq(lhs, rhs));
+  }
+  return eqs;
+}
+
+bool same_equation(const TypeEquation& a, const TypeEquation& b) {
+  return a.lhs.term == b.lhs.term && a.rhs.term == b.rhs.term &&
+    a.lhs.source_token == b.lhs.source_token && a.rhs.source_token == b.rhs.source_token;
+}
+
+void test_fifo_order() {
+  TypeStore store(1e4);
+  TypeEquationQueue queue;
+  const int64_t num_eqs = TypeEquationQueue::chunk_capacity * 3 + 7;
+  const auto eqs = make_equations(store, num_eqs);
+
+  for (const auto& eq : eqs) {
+    queue.push(eq);
+  }
+
+  MT_EXPECT(queue.num_pending() == num_eqs, "Expected every equation to be pending.");
+  for (int64_t i = 0; i < num_eqs; i++) {
+    MT_EXPECT(same_equation(queue.pending(i), eqs[i]), "Expected pending(" << i << ") in push order.");
+  }
+
+  for (int64_t i = 0; i < num_eqs; i++) {
+    MT_EXPECT(same_equation(queue.pop(), eqs[i]), "Expected pop " << i << " in push order.");
+    MT_EXPECT(queue.num_pending() == num_eqs - i - 1, "Expected pending count to decrease.");
+  }
+
+  MT_EXPECT(queue.empty(), "Expected queue to be empty.");
+  MT_EXPECT(queue.counts().enqueued == num_eqs, "Expected every push to be counted.");
+  MT_EXPECT(queue.counts().retired == num_eqs, "Expected every pop to be counted.");
+  MT_EXPECT(queue.counts().deduplicated == 0, "Expected no deduplicated equations.");
+}
+
+void test_interleaved_push_pop() {
+  //  Keep the queue short while cycling through many chunks, so that chunks are recycled.
+  TypeStore store(1e5);
+  TypeEquationQueue queue;
+  const int64_t num_eqs = TypeEquationQueue::chunk_capacity * 5 + 3;
+  const auto eqs = make_equations(store, num_eqs);
+
+  int64_t next_push = 0;
+  int64_t next_pop = 0;
+
+  while (next_pop < num_eqs) {
+    for (int64_t i = 0; i < 3 && next_push < num_eqs; i++) {
+      queue.push(eqs[next_push++]);
+    }
+    for (int64_t i = 0; i < 2 && next_pop < next_push; i++) {
+      MT_EXPECT(same_equation(queue.pop(), eqs[next_pop]), "Expected pop " << next_pop << " in push order.");
+      next_pop++;
+    }
+    if (next_push == num_eqs) {
+      while (next_pop < num_eqs) {
+        MT_EXPECT(same_equation(queue.pop(), eqs[next_pop]), "Expected pop " << next_pop << " in push order.");
+        next_pop++;
+      }
+    }
+    MT_EXPECT(queue.num_pending() == next_push - next_pop, "Expected pending count to match.");
+  }
+
+  MT_EXPECT(queue.empty(), "Expected queue to be empty.");
+}
+
+void test_deduplication() {
+  TypeStore store(1e2);
+  TypeEquationQueue queue;
+  const auto eqs = make_equations(store, 2);
+  const auto reversed = make_eq(eqs[0].rhs, eqs[0].lhs);
+  Token token{};
+  const auto with_token = make_eq(make_term(&token, eqs[0].lhs.term), eqs[0].rhs);
+
+  MT_EXPECT(queue.push(eqs[0]), "Expected first push to enqueue.");
+  MT_EXPECT(!queue.push(eqs[0]), "Expected identical pending equation to be deduplicated.");
+  MT_EXPECT(queue.push(reversed), "Expected reversed equation to be distinct.");
+  MT_EXPECT(queue.push(with_token), "Expected equation with different source token to be distinct.");
+  MT_EXPECT(queue.push(eqs[1]), "Expected different equation to enqueue.");
+  MT_EXPECT(queue.num_pending() == 4, "Expected 4 pending equations.");
+  MT_EXPECT(queue.counts().deduplicated == 1, "Expected 1 deduplicated equation.");
+
+  //  Once retired, an equation may be enqueued again.
+  MT_EXPECT(same_equation(queue.pop(), eqs[0]), "Expected first equation to be popped first.");
+  MT_EXPECT(queue.push(eqs[0]), "Expected retired equation to enqueue again.");
+  MT_EXPECT(same_equation(queue.pending(queue.num_pending() - 1), eqs[0]),
+            "Expected re-enqueued equation at the back.");
+  MT_EXPECT(queue.counts().enqueued == 5, "Expected 5 enqueued equations.");
+}
+
+void test_restore_and_clear() {
+  TypeStore store(1e2);
+  TypeEquationQueue queue;
+  const auto eqs = make_equations(store, 3);
+
+  for (const auto& eq : eqs) {
+    queue.push(eq);
+  }
+
+  auto popped = queue.pop();
+  queue.restore(popped);
+  queue.restore(eqs[1]);
+  MT_EXPECT(queue.num_pending() == 3, "Expected restore to skip an already pending equation.");
+  MT_EXPECT(same_equation(queue.pending(2), eqs[0]), "Expected restored equation at the back.");
+  MT_EXPECT(queue.counts().enqueued == 3, "Expected restore not to count as enqueued.");
+
+  queue.clear();
+  MT_EXPECT(queue.empty(), "Expected clear to discard pending equations.");
+  MT_EXPECT(queue.counts().retired == 1, "Expected clear not to count as retired.");
+  MT_EXPECT(queue.push(eqs[1]), "Expected cleared equation to enqueue again.");
+  MT_EXPECT(same_equation(queue.pop(), eqs[1]), "Expected pushed equation after clear.");
+
+  TypeEquationQueue other;
+  other.push(eqs[2]);
+  other.push(eqs[2]);
+  queue.add_counts(other.counts());
+  MT_EXPECT(queue.counts().enqueued == 5, "Expected added enqueued counts.");
+  MT_EXPECT(queue.counts().deduplicated == 1, "Expected added deduplicated counts.");
+}
+
+}
+
+}
+
+int main() {
+  mt::test_fifo_order();
+  mt::test_interleaved_push_pop();
+  mt::test_deduplication();
+  mt::test_restore_and_clear();
+
+  return mt::test::exit_status();
+}